@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Helpers shared by the POSIX benchmark programs: a fresh virtual-time kernel
+ * per run, task creation from a static stack pool, and a park point tasks
+ * block on once their loop is done so hrt_sim_run_for(0) returns. */
+#ifndef HARDRT_BENCH_COMMON_H
+#define HARDRT_BENCH_COMMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hardrt.h"
+#include "hardrt_sem.h"
+#include "hardrt_time.h"
+#include "hardrt_posix.h"
+
+#define BENCH_STACK_WORDS 2048u
+
+static uint32_t g_bench_stacks[HARDRT_MAX_TASKS][BENCH_STACK_WORDS];
+static int g_bench_next_stack = 0;
+static hrt_sem_t g_bench_park;
+
+static void bench_park(void) {
+    for (;;) hrt_sem_take(&g_bench_park);
+}
+
+static void bench_kernel_reset(void) {
+    const hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5,
+                              .tick_src = HRT_TICK_VIRTUAL};
+    hrt_init(&cfg);
+    g_bench_next_stack = 0;
+    hrt_sem_init(&g_bench_park, 0);
+}
+
+static int bench_spawn_attr(const hrt_task_fn fn, void *arg, const hrt_task_attr_t *attr) {
+    const int id = hrt_create_task(fn, arg, g_bench_stacks[g_bench_next_stack++], BENCH_STACK_WORDS, attr);
+    if (id < 0) {
+        fprintf(stderr, "bench: task creation failed\n");
+        exit(1);
+    }
+    return id;
+}
+
+static inline int bench_spawn(const hrt_task_fn fn, void *arg, const hrt_prio_t prio) {
+    const hrt_task_attr_t a = {.priority = prio, .timeslice = 0};
+    return bench_spawn_attr(fn, arg, &a);
+}
+
+#endif
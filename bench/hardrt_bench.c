@@ -0,0 +1,513 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* HardRT POSIX microbenchmarks.
+ *
+ *   hardrt_bench [--quick] [--iters N] [--reps N] [--json FILE|-] [--filter SUBSTR]
+ *                [--check BASELINE.json [--tolerance PCT]]
+ *
+ * Every benchmark initialises the kernel in virtual time, creates its tasks
+ * and times hrt_sim_run_for() from the host until all of them have finished
+ * and blocked, so no timer signal or host sleep lands inside a measurement.
+ * Each case runs `reps` times; the median and best ns/op are reported.
+ *
+ * `rel` is the median divided by the cost of one host swapcontext(), timed the
+ * same way. It is what --check compares against a baseline written by --json,
+ * so a baseline recorded on one machine stays usable on another. --check exits
+ * 1 when a case is slower than baseline by more than the tolerance, and 77
+ * (CTest skip) when the baseline was recorded for another configuration. */
+#include <string.h>
+#include <ucontext.h>
+
+#include "bench_common.h"
+#include "hardrt_mutex.h"
+#include "hardrt_queue.h"
+#include "hardrt_version.h"
+
+#define BENCH_MAX_RESULTS 64
+#define BENCH_MAX_REPS    32
+#define BENCH_MAX_ITEM    256u
+#define BENCH_QUEUE_DEPTH 16u
+#define BENCH_EXIT_SKIP   77
+
+/* bench_run() flags */
+#define BENCH_TICK        1u /* time hrt_sim_step() per op instead of one hrt_sim_run_for(0) */
+#define BENCH_NO_GATE     2u /* reported, but never fails --check: too short to time reliably */
+
+typedef struct {
+    char name[32];
+    uint32_t param;      /* case parameter (item size, sleeper count), 0 if none */
+    uint64_t ops;        /* operations per run */
+    double ns_median;
+    double ns_min;
+    int gated;           /* compared by --check (no BENCH_NO_GATE) */
+    double rel;          /* median over reps of ns/op over the swapcontext time measured around that rep */
+} bench_result_t;
+
+static bench_result_t g_results[BENCH_MAX_RESULTS];
+static int g_nresults = 0;
+
+static uint32_t g_iters = 100000u;
+static int g_reps = 5;
+static const char *g_filter = NULL;
+static double g_calib_ns = 0.0;
+
+static hrt_sem_t g_sem_a, g_sem_b;
+static hrt_mutex_t g_mtx;
+static hrt_queue_t g_q;
+static uint8_t g_q_store[BENCH_QUEUE_DEPTH * BENCH_MAX_ITEM];
+static size_t g_item;
+
+/* ---------------- Cases ---------------- */
+
+static void t_yield(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) hrt_yield();
+    bench_park();
+}
+
+static uint64_t setup_yield(const uint32_t param) {
+    (void) param;
+    bench_spawn(t_yield, NULL, HRT_PRIO1);
+    bench_spawn(t_yield, NULL, HRT_PRIO1);
+    return 2ull * g_iters; /* one switch per yield */
+}
+
+static void t_sem_ping(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        hrt_sem_give(&g_sem_a);
+        hrt_sem_take(&g_sem_b);
+    }
+    bench_park();
+}
+
+static void t_sem_pong(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        hrt_sem_take(&g_sem_a);
+        hrt_sem_give(&g_sem_b);
+    }
+    bench_park();
+}
+
+static uint64_t setup_sem(const uint32_t param) {
+    (void) param;
+    hrt_sem_init(&g_sem_a, 0);
+    hrt_sem_init(&g_sem_b, 0);
+    bench_spawn(t_sem_pong, NULL, HRT_PRIO0);
+    bench_spawn(t_sem_ping, NULL, HRT_PRIO1);
+    return g_iters; /* give -> take -> give -> take round trips */
+}
+
+/* Uncontended: one task, nobody ever waits, so every call stays on the fast path */
+static void t_sem_solo(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        hrt_sem_give(&g_sem_a);
+        hrt_sem_take(&g_sem_a);
+    }
+    bench_park();
+}
+
+static uint64_t setup_sem_solo(const uint32_t param) {
+    (void) param;
+    hrt_sem_init(&g_sem_a, 0);
+    bench_spawn(t_sem_solo, NULL, HRT_PRIO1);
+    return g_iters; /* give + take pairs */
+}
+
+static void t_q_send(void *arg) {
+    (void) arg;
+    uint8_t item[BENCH_MAX_ITEM];
+    memset(item, 0x5A, sizeof(item));
+    for (uint32_t i = 0; i < g_iters; ++i) hrt_queue_send(&g_q, item);
+    bench_park();
+}
+
+static void t_q_recv(void *arg) {
+    (void) arg;
+    uint8_t item[BENCH_MAX_ITEM];
+    for (uint32_t i = 0; i < g_iters; ++i) hrt_queue_recv(&g_q, item);
+    bench_park();
+}
+
+static uint64_t setup_queue(const uint32_t param) {
+    g_item = param;
+    hrt_queue_init(&g_q, g_q_store, BENCH_QUEUE_DEPTH, g_item);
+    bench_spawn(t_q_recv, NULL, HRT_PRIO1);
+    bench_spawn(t_q_send, NULL, HRT_PRIO1);
+    return g_iters; /* items transferred */
+}
+
+/* Generic vs typed queue, one task and no waiters: what is left is the critical
+ * section, the item copy and the ring wrap. The generic case is the fully generic
+ * shape (odd depth, byte-aligned storage: compare wrap and memcpy); the typed one
+ * comes from HRT_QUEUE_DEFINE (mask wrap, word copies). */
+typedef struct { uint32_t w[1]; } bench_item4_t;
+typedef struct { uint32_t w[4]; } bench_item16_t;
+HRT_QUEUE_DEFINE(g_tq4, bench_item4_t, BENCH_QUEUE_DEPTH)
+HRT_QUEUE_DEFINE(g_tq16, bench_item16_t, BENCH_QUEUE_DEPTH)
+
+static void t_q_generic(void *arg) {
+    (void) arg;
+    uint32_t in[4] = {1u, 2u, 3u, 4u}, out[4];
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        hrt_queue_try_send(&g_q, in);
+        hrt_queue_try_recv(&g_q, out);
+    }
+    bench_park();
+}
+
+static uint64_t setup_queue_generic(const uint32_t param) {
+    hrt_queue_init(&g_q, g_q_store + 1, BENCH_QUEUE_DEPTH - 1u, param);
+    bench_spawn(t_q_generic, NULL, HRT_PRIO1);
+    return g_iters; /* send + receive pairs */
+}
+
+static void t_q_typed4(void *arg) {
+    (void) arg;
+    bench_item4_t in = {{1u}}, out;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        g_tq4_try_send(&in);
+        g_tq4_try_recv(&out);
+    }
+    bench_park();
+}
+
+static void t_q_typed16(void *arg) {
+    (void) arg;
+    bench_item16_t in = {{1u, 2u, 3u, 4u}}, out;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        g_tq16_try_send(&in);
+        g_tq16_try_recv(&out);
+    }
+    bench_park();
+}
+
+static uint64_t setup_queue_typed(const uint32_t param) {
+    if (param == sizeof(bench_item4_t)) {
+        g_tq4_reset();
+        bench_spawn(t_q_typed4, NULL, HRT_PRIO1);
+    } else {
+        g_tq16_reset();
+        bench_spawn(t_q_typed16, NULL, HRT_PRIO1);
+    }
+    return g_iters; /* send + receive pairs */
+}
+
+static void t_mutex(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        hrt_mutex_lock(&g_mtx);
+        hrt_yield(); /* let the other task queue up on the mutex */
+        hrt_mutex_unlock(&g_mtx);
+    }
+    bench_park();
+}
+
+/* param: hrt_mutex_mode_t. With handoff every unlock passes ownership to the waiter
+ * and yields; with barging the releasing task re-locks and the waiter mostly loses. */
+static uint64_t setup_mutex(const uint32_t param) {
+    hrt_mutex_init_mode(&g_mtx, (hrt_mutex_mode_t) param);
+    bench_spawn(t_mutex, NULL, HRT_PRIO1);
+    bench_spawn(t_mutex, NULL, HRT_PRIO1);
+    return 2ull * g_iters; /* lock/unlock cycles of both tasks */
+}
+
+static void t_mutex_solo(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        hrt_mutex_lock(&g_mtx);
+        hrt_mutex_unlock(&g_mtx);
+    }
+    bench_park();
+}
+
+static uint64_t setup_mutex_solo(const uint32_t param) {
+    (void) param;
+    hrt_mutex_init(&g_mtx);
+    bench_spawn(t_mutex_solo, NULL, HRT_PRIO1);
+    return g_iters; /* lock + unlock pairs */
+}
+
+static void t_sleeper(void *arg) {
+    (void) arg;
+    for (;;) hrt_sleep(1000000u);
+}
+
+/* Sleepers never wake inside the measurement: each hrt_sim_step() is one tick
+ * ISR scan plus the scheduler's idle pick. At least one sleeper is needed, as
+ * virtual time skips ticks without running the ISR when nobody sleeps. */
+static uint64_t setup_tick(const uint32_t param) {
+    for (uint32_t i = 0; i < param; ++i) bench_spawn(t_sleeper, NULL, HRT_PRIO1);
+    hrt_sim_run_for(0); /* let every sleeper reach hrt_sleep() */
+    return g_iters;
+}
+
+/* ---------------- Host calibration ---------------- */
+
+static int _cmp_double(const void *a, const void *b) {
+    const double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+static ucontext_t g_cal_main, g_cal_peer;
+static uint8_t g_cal_stack[64 * 1024];
+
+static void _cal_peer(void) {
+    for (;;) swapcontext(&g_cal_peer, &g_cal_main);
+}
+
+/* ns of one swapcontext(): the host primitive the POSIX port is built on */
+static double bench_calibrate_once(void) {
+    const uint64_t t0 = hrt_posix_now_ns();
+    for (uint32_t i = 0; i < g_iters; ++i) swapcontext(&g_cal_main, &g_cal_peer);
+    return (double) (hrt_posix_now_ns() - t0) / (2.0 * g_iters);
+}
+
+/* Median over the reps, for the report; each case also calibrates around its own reps */
+static double bench_calibrate(void) {
+    getcontext(&g_cal_peer);
+    g_cal_peer.uc_stack.ss_sp = g_cal_stack;
+    g_cal_peer.uc_stack.ss_size = sizeof(g_cal_stack);
+    g_cal_peer.uc_link = NULL;
+    makecontext(&g_cal_peer, _cal_peer, 0);
+
+    double ns[BENCH_MAX_REPS];
+    for (int r = 0; r < g_reps; ++r) ns[r] = bench_calibrate_once();
+    qsort(ns, (size_t) g_reps, sizeof(ns[0]), _cmp_double);
+    return ns[g_reps / 2];
+}
+
+/* Everything that changes what a case measures; a baseline only applies to the same string */
+static void bench_config(char *buf, const size_t n) {
+#ifdef __OPTIMIZE__
+    const int opt = 1;
+#else
+    const int opt = 0;
+#endif
+    snprintf(buf, n, "max_tasks=%d max_prio=%d stats=%d trace=%d latency=%d stack_check=%d obj_stats=%d "
+                     "irqoff=%d isr_defer=%d guard_pages=%d posix_perf=%d posix_prof=%d posix_shm=%d debug=%d opt=%d",
+             HARDRT_MAX_TASKS, HARDRT_MAX_PRIO, HARDRT_STATS, HARDRT_TRACE, HARDRT_LATENCY,
+             HARDRT_STACK_CHECK, HARDRT_OBJ_STATS, HARDRT_IRQOFF, HARDRT_ISR_DEFER, HARDRT_POSIX_GUARD_PAGES,
+             HARDRT_POSIX_PERF, HARDRT_POSIX_PROF, HARDRT_POSIX_SHM, HARDRT_DEBUG, opt);
+}
+
+/* ---------------- Runner ---------------- */
+
+typedef uint64_t (*bench_setup_fn)(uint32_t param);
+
+static void bench_run(const char *name, const bench_setup_fn setup, const uint32_t param, const unsigned flags) {
+    if (g_filter && !strstr(name, g_filter)) return;
+    if (g_nresults >= BENCH_MAX_RESULTS) return;
+
+    double ns[BENCH_MAX_REPS], rel[BENCH_MAX_REPS];
+    uint64_t ops = 0;
+    for (int r = 0; r < g_reps; ++r) {
+        /* Host speed drifts on shared machines: normalise each rep by a calibration
+           taken right around it rather than by one taken at start-up */
+        const double cal_before = bench_calibrate_once();
+        bench_kernel_reset();
+        ops = setup(param);
+        const uint64_t t0 = hrt_posix_now_ns();
+        if (flags & BENCH_TICK) {
+            for (uint32_t i = 0; i < g_iters; ++i) hrt_sim_step();
+        } else {
+            hrt_sim_run_for(0);
+        }
+        const uint64_t t1 = hrt_posix_now_ns();
+        ns[r] = (double) (t1 - t0) / (double) ops;
+        rel[r] = ns[r] / (0.5 * (cal_before + bench_calibrate_once()));
+    }
+    qsort(ns, (size_t) g_reps, sizeof(ns[0]), _cmp_double);
+    qsort(rel, (size_t) g_reps, sizeof(rel[0]), _cmp_double);
+
+    bench_result_t *res = &g_results[g_nresults++];
+    snprintf(res->name, sizeof(res->name), "%s", name);
+    res->param = param;
+    res->ops = ops;
+    res->ns_median = ns[g_reps / 2];
+    res->ns_min = ns[0];
+    res->gated = !(flags & BENCH_NO_GATE);
+    res->rel = rel[g_reps / 2];
+}
+
+static void print_text(void) {
+    printf("HardRT %s bench (port %s, max_tasks %d, max_prio %d, %d reps)\n",
+           HARDRT_VERSION_STRING, hrt_port_name(), HARDRT_MAX_TASKS, HARDRT_MAX_PRIO, g_reps);
+    printf("host swapcontext: %.1f ns\n", g_calib_ns);
+    printf("%-16s %7s %10s %10s %10s %14s %8s\n", "case", "param", "ops", "ns/op", "best", "ops/s", "rel");
+    for (int i = 0; i < g_nresults; ++i) {
+        const bench_result_t *r = &g_results[i];
+        printf("%-16s %7u %10llu %10.1f %10.1f %14.0f %8.3f\n", r->name, (unsigned) r->param,
+               (unsigned long long) r->ops, r->ns_median, r->ns_min, 1e9 / r->ns_median, r->rel);
+    }
+}
+
+static int write_json(const char *path) {
+    FILE *f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    char cfg[256];
+    bench_config(cfg, sizeof(cfg));
+    fprintf(f, "{\n  \"version\": \"%s\",\n  \"port\": \"%s\",\n", HARDRT_VERSION_STRING, hrt_port_name());
+    fprintf(f, "  \"config\": \"%s\",\n", cfg);
+    fprintf(f, "  \"max_tasks\": %d,\n  \"max_prio\": %d,\n  \"reps\": %d,\n  \"iters\": %u,\n",
+            HARDRT_MAX_TASKS, HARDRT_MAX_PRIO, g_reps, (unsigned) g_iters);
+    fprintf(f, "  \"calib_ns\": %.2f,\n  \"results\": [", g_calib_ns);
+    for (int i = 0; i < g_nresults; ++i) {
+        const bench_result_t *r = &g_results[i];
+        fprintf(f, "%s\n    {\"name\": \"%s\", \"param\": %u, \"ops\": %llu, "
+                   "\"ns_per_op\": %.2f, \"ns_per_op_min\": %.2f, \"ops_per_s\": %.0f, \"rel\": %.4f}",
+                i ? "," : "", r->name, (unsigned) r->param, (unsigned long long) r->ops,
+                r->ns_median, r->ns_min, 1e9 / r->ns_median, r->rel);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    if (f != stdout) fclose(f);
+    return 0;
+}
+
+/* ---------------- Baseline check ---------------- */
+
+/* Baselines are written by write_json(): header fields and one result object per line */
+
+/* 0 if the baseline applies to this build, BENCH_EXIT_SKIP if it is for another configuration, 1 on error */
+static int baseline_applies(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        fprintf(stderr, "hardrt_bench: no baseline; record one with --json %s\n", path);
+        return 1;
+    }
+    char cfg[256], base_cfg[256] = "", line[512];
+    bench_config(cfg, sizeof(cfg));
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = strstr(line, "\"config\": \"");
+        if (p) {
+            sscanf(p + strlen("\"config\": \""), "%255[^\"]", base_cfg);
+            break;
+        }
+    }
+    fclose(f);
+
+    if (base_cfg[0] == '\0') {
+        fprintf(stderr, "hardrt_bench: %s has no config line\n", path);
+        return 1;
+    }
+    if (strcmp(base_cfg, cfg) != 0) {
+        printf("SKIP: baseline is for \"%s\", this build is \"%s\"\n", base_cfg, cfg);
+        return BENCH_EXIT_SKIP;
+    }
+    return 0;
+}
+
+static int check_baseline(const char *path, const double tol_pct) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+
+    int regressed = 0, matched = 0;
+    char line[512];
+    printf("\nbaseline %s (tolerance %.1f%%)\n", path, tol_pct);
+    while (fgets(line, sizeof(line), f)) {
+        const char *p;
+        char name[32];
+        unsigned param;
+        double base_rel;
+        if (!(p = strstr(line, "{\"name\": \"")) ||
+            sscanf(p, "{\"name\": \"%31[^\"]\", \"param\": %u", name, &param) != 2 ||
+            !(p = strstr(line, "\"rel\": ")) || sscanf(p, "\"rel\": %lf", &base_rel) != 1) {
+            continue;
+        }
+        for (int i = 0; i < g_nresults; ++i) {
+            const bench_result_t *r = &g_results[i];
+            if (strcmp(r->name, name) != 0 || r->param != param) continue;
+            const double delta = (r->rel / base_rel - 1.0) * 100.0;
+            const int bad = r->gated && delta > tol_pct;
+            printf("%-16s %7u  rel %8.3f  baseline %8.3f  %+7.1f%%  %s\n", name, param, r->rel, base_rel, delta,
+                   !r->gated ? "not gated" : bad ? "REGRESSED"
+                             : (delta < -tol_pct ? "faster (consider updating the baseline)" : "ok"));
+            regressed |= bad;
+            matched++;
+        }
+    }
+    fclose(f);
+
+    if (matched == 0) {
+        fprintf(stderr, "hardrt_bench: %s has no usable results\n", path);
+        return 1;
+    }
+    printf("%s\n", regressed ? "FAIL: performance regression" : "PASS");
+    return regressed ? 1 : 0;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--quick] [--iters N] [--reps N] [--json FILE|-] [--filter SUBSTR]\n"
+                    "       [--check BASELINE.json [--tolerance PCT]]\n", argv0);
+}
+
+int main(const int argc, char **argv) {
+    const char *json = NULL;
+    const char *check = NULL;
+    double tolerance = 25.0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            g_iters = 1000u;
+            g_reps = 1;
+        } else if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            g_iters = (uint32_t) strtoul(argv[++i], NULL, 0);
+            if (g_iters < 1u) g_iters = 1u;
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            g_reps = atoi(argv[++i]);
+            if (g_reps < 1) g_reps = 1;
+            if (g_reps > BENCH_MAX_REPS) g_reps = BENCH_MAX_REPS;
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            g_filter = argv[++i];
+        } else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+            check = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (check) {
+        const int rc = baseline_applies(check);
+        if (rc != 0) return rc;
+    }
+
+    g_calib_ns = bench_calibrate();
+
+    bench_run("yield_pingpong", setup_yield, 0, 0);
+    bench_run("sem_roundtrip", setup_sem, 0, 0);
+    bench_run("sem_fastpath", setup_sem_solo, 0, BENCH_NO_GATE);
+    static const uint32_t k_items[] = {4u, 16u, 64u, 256u};
+    for (unsigned i = 0; i < sizeof(k_items) / sizeof(k_items[0]); ++i) {
+        bench_run("queue_xfer", setup_queue, k_items[i], 0);
+    }
+    for (unsigned i = 0; i < 2u; ++i) {
+        bench_run("queue_generic", setup_queue_generic, k_items[i], BENCH_NO_GATE);
+        bench_run("queue_typed", setup_queue_typed, k_items[i], BENCH_NO_GATE);
+    }
+    bench_run("mutex_handoff", setup_mutex, HRT_MUTEX_HANDOFF, 0);
+    bench_run("mutex_barging", setup_mutex, HRT_MUTEX_BARGING, 0);
+    bench_run("mutex_fastpath", setup_mutex_solo, 0, BENCH_NO_GATE);
+    /* 1, 2, 4, ... sleepers, then every user slot */
+    for (uint32_t k = 1; k < (uint32_t) HARDRT_MAX_TASKS - 1u; k *= 2u) {
+        bench_run("tick_isr", setup_tick, k, BENCH_TICK);
+    }
+    bench_run("tick_isr", setup_tick, (uint32_t) HARDRT_MAX_TASKS - 1u, BENCH_TICK);
+
+    if (json && strcmp(json, "-") == 0) return write_json(json) ? 1 : 0;
+    print_text();
+    if (json && write_json(json) != 0) return 1;
+    if (check) return check_baseline(check, tolerance);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Configuration-matrix scaling probe.
+ *
+ *   hardrt_scale [--header] [--quick]
+ *
+ * Built once per (HARDRT_CFG_MAX_TASKS, HARDRT_CFG_MAX_PRIO) grid point by the
+ * hardrt_bench_matrix target. Each build runs the same small workload, so
+ * any change across rows comes from the kernel's sizing, not the load:
+ *   tick  - one tick with 4 far-future sleepers: the ISR scans every TCB slot
+ *   pick  - yield ping-pong between two tasks at the lowest priority, so
+ *           hrt__pick_next_ready() walks every priority class
+ *   sem   - give/take round trip between a PRIO0 and a lower task
+ * and prints one table row with ns/op (median of 3) and object sizes. */
+#include <string.h>
+
+#include "bench_common.h"
+#include "hardrt_mutex.h"
+#include "hardrt_queue.h"
+
+#define SCALE_REPS     3
+#define SCALE_SLEEPERS 4u
+
+static uint32_t g_iters = 20000u;
+static hrt_sem_t g_sem_a, g_sem_b;
+
+static void t_sleeper(void *arg) {
+    (void) arg;
+    for (;;) hrt_sleep(1000000u);
+}
+
+static void t_yield(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) hrt_yield();
+    bench_park();
+}
+
+static void t_ping(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        hrt_sem_give(&g_sem_a);
+        hrt_sem_take(&g_sem_b);
+    }
+    bench_park();
+}
+
+static void t_pong(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < g_iters; ++i) {
+        hrt_sem_take(&g_sem_a);
+        hrt_sem_give(&g_sem_b);
+    }
+    bench_park();
+}
+
+static hrt_prio_t _lowest_prio(void) {
+    return (hrt_prio_t) (HARDRT_MAX_PRIO - 1);
+}
+
+static double _run_tick(void) {
+    for (uint32_t i = 0; i < SCALE_SLEEPERS && i + 1u < (uint32_t) HARDRT_MAX_TASKS; ++i) {
+        bench_spawn(t_sleeper, NULL, _lowest_prio());
+    }
+    hrt_sim_run_for(0);
+    const uint64_t t0 = hrt_posix_now_ns();
+    for (uint32_t i = 0; i < g_iters; ++i) hrt_sim_step();
+    return (double) (hrt_posix_now_ns() - t0) / g_iters;
+}
+
+static double _run_pick(void) {
+    bench_spawn(t_yield, NULL, _lowest_prio());
+    bench_spawn(t_yield, NULL, _lowest_prio());
+    const uint64_t t0 = hrt_posix_now_ns();
+    hrt_sim_run_for(0);
+    return (double) (hrt_posix_now_ns() - t0) / (2.0 * g_iters);
+}
+
+static double _run_sem(void) {
+    hrt_sem_init(&g_sem_a, 0);
+    hrt_sem_init(&g_sem_b, 0);
+    bench_spawn(t_pong, NULL, HRT_PRIO0);
+    bench_spawn(t_ping, NULL, _lowest_prio());
+    const uint64_t t0 = hrt_posix_now_ns();
+    hrt_sim_run_for(0);
+    return (double) (hrt_posix_now_ns() - t0) / g_iters;
+}
+
+static int _cmp_double(const void *a, const void *b) {
+    const double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+static double _median(double (*run)(void)) {
+    double ns[SCALE_REPS];
+    for (int r = 0; r < SCALE_REPS; ++r) {
+        bench_kernel_reset();
+        ns[r] = run();
+    }
+    qsort(ns, SCALE_REPS, sizeof(ns[0]), _cmp_double);
+    return ns[SCALE_REPS / 2];
+}
+
+int main(const int argc, char **argv) {
+    int header = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--header") == 0) {
+            header = 1;
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            g_iters = 500u;
+        } else {
+            fprintf(stderr, "usage: %s [--header] [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (header) {
+        printf("%5s %4s | %9s %9s %9s | %5s %5s %5s %5s\n",
+               "tasks", "prio", "tick_ns", "pick_ns", "sem_ns", "tcb", "sem", "mutex", "queue");
+    }
+    const double tick = _median(_run_tick);
+    const double pick = _median(_run_pick);
+    const double sem = _median(_run_sem);
+    printf("%5d %4d | %9.1f %9.1f %9.1f | %5zu %5zu %5zu %5zu\n",
+           HARDRT_MAX_TASKS - 1, HARDRT_MAX_PRIO, tick, pick, sem,
+           sizeof(_hrt_tcb_t), sizeof(hrt_sem_t), sizeof(hrt_mutex_t), sizeof(hrt_queue_t));
+    return 0;
+}
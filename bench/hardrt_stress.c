@@ -0,0 +1,385 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Synthetic periodic task sets against the scheduler policies.
+ *
+ *   hardrt_stress [--quick] [--tasks N] [--util U,U,...] [--sets N] [--periods T,T,...]
+ *                 [--assign rm|random|flat] [--policy NAME] [--slice N] [--hyper N]
+ *                 [--seed N] [--verbose] [--json FILE|-]
+ *
+ * For every target utilisation, UUniFast draws `sets` task sets of `tasks`
+ * periodic tasks: period T from the --periods list, execution time
+ * C = round(U_i * T) ticks (at least 1), implicit deadline D = T. Each set runs
+ * once per scheduling policy on a fresh virtual-time kernel. Jobs are released
+ * synchronously at tick 0 and then every T ticks for `hyper` times the longest
+ * period; each job burns C ticks with hrt_sim_consume(), so wakes and RR slices
+ * preempt it as a real tick would. Response time R is completion tick minus
+ * release tick; a job misses when R > D.
+ *
+ * One row per (utilisation, policy): effective utilisation after rounding, the
+ * share of sets with no miss, the job miss ratio and the R/D distribution over
+ * all jobs. The same seed always gives the same sets and the same numbers. */
+#include <math.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "hardrt_version.h"
+
+#define STRESS_MAX_TASKS   (HARDRT_MAX_TASKS - 1)
+#define STRESS_MAX_UTILS   16
+#define STRESS_MAX_PERIODS 16
+#define STRESS_RD_BINS     1001 /* R/D in percent; the last bin holds >= 10x the deadline */
+#define STRESS_NPOLICIES   3
+
+typedef struct {
+    uint32_t period;
+    uint32_t wcet;
+    hrt_prio_t prio;
+    /* Results of the current run */
+    uint32_t jobs;
+    uint32_t misses;
+    uint32_t r_max;
+} stress_task_t;
+
+typedef struct {
+    uint32_t sets;
+    uint32_t sets_ok;
+    uint64_t jobs;
+    uint64_t misses;
+    double u_eff_sum;
+    uint32_t rd_bins[STRESS_RD_BINS];
+} stress_row_t;
+
+static const hrt_policy_t k_policies[STRESS_NPOLICIES] = {HRT_SCHED_PRIORITY, HRT_SCHED_RR, HRT_SCHED_PRIORITY_RR};
+static const char *const k_policy_names[STRESS_NPOLICIES] = {"priority", "rr", "priority_rr"};
+
+static int g_ntasks = 0;
+static double g_utils[STRESS_MAX_UTILS] = {0.5, 0.6, 0.7, 0.8, 0.9, 1.0};
+static int g_nutils = 6;
+static uint32_t g_periods[STRESS_MAX_PERIODS] = {25u, 50u, 100u, 200u, 250u, 500u, 1000u};
+static int g_nperiods = 7;
+static uint32_t g_sets = 50u;
+static const char *g_assign = "rm";
+static int g_policy_only = -1;
+static uint16_t g_slice = 2u;
+static uint32_t g_hyper = 4u;
+static uint64_t g_seed = 1u;
+static int g_verbose = 0;
+
+static stress_task_t g_tasks[STRESS_MAX_TASKS];
+static stress_row_t g_rows[STRESS_MAX_UTILS][STRESS_NPOLICIES];
+static stress_row_t *g_row = NULL;  /* row the running set reports into */
+static uint32_t g_t0 = 0;
+static uint32_t g_horizon = 0;
+
+/* ---------------- Task set generation ---------------- */
+
+static uint64_t _rand_u64(void) {
+    /* xorshift64* */
+    g_seed ^= g_seed >> 12;
+    g_seed ^= g_seed << 25;
+    g_seed ^= g_seed >> 27;
+    return g_seed * 0x2545F4914F6CDD1Dull;
+}
+
+/* Uniform in (0, 1] */
+static double _rand_unit(void) {
+    return (double) ((_rand_u64() >> 11) + 1u) / 9007199254740992.0;
+}
+
+/* UUniFast (Bini & Buttazzo), discarding draws with a task above U = 1 */
+static void _uunifast(const double total, double *u, const int n) {
+    for (;;) {
+        double sum = total;
+        int ok = 1;
+        for (int i = 0; i < n - 1; ++i) {
+            const double next = sum * pow(_rand_unit(), 1.0 / (double) (n - 1 - i));
+            u[i] = sum - next;
+            sum = next;
+            if (u[i] > 1.0) ok = 0;
+        }
+        u[n - 1] = sum;
+        if (ok && sum <= 1.0) return;
+    }
+}
+
+static int _cmp_period(const void *a, const void *b) {
+    const stress_task_t *x = *(const stress_task_t *const *) a, *y = *(const stress_task_t *const *) b;
+    return (x->period > y->period) - (x->period < y->period);
+}
+
+/* Spread the tasks over HARDRT_MAX_PRIO classes */
+static void _assign_priorities(void) {
+    if (strcmp(g_assign, "flat") == 0) {
+        for (int i = 0; i < g_ntasks; ++i) g_tasks[i].prio = HRT_PRIO0;
+    } else if (strcmp(g_assign, "random") == 0) {
+        for (int i = 0; i < g_ntasks; ++i) g_tasks[i].prio = (hrt_prio_t) (_rand_u64() % HARDRT_MAX_PRIO);
+    } else {
+        /* Rate monotonic: shortest period first, ranks folded into the available classes */
+        stress_task_t *by_period[STRESS_MAX_TASKS];
+        for (int i = 0; i < g_ntasks; ++i) by_period[i] = &g_tasks[i];
+        qsort(by_period, (size_t) g_ntasks, sizeof(by_period[0]), _cmp_period);
+        for (int r = 0; r < g_ntasks; ++r) {
+            by_period[r]->prio = (hrt_prio_t) (r * HARDRT_MAX_PRIO / g_ntasks);
+        }
+    }
+}
+
+/* Returns the utilisation after rounding C to whole ticks */
+static double _generate_set(const double util) {
+    double u[STRESS_MAX_TASKS];
+    _uunifast(util, u, g_ntasks);
+    double u_eff = 0.0;
+    for (int i = 0; i < g_ntasks; ++i) {
+        stress_task_t *t = &g_tasks[i];
+        t->period = g_periods[_rand_u64() % (uint64_t) g_nperiods];
+        t->wcet = (uint32_t) lround(u[i] * t->period);
+        if (t->wcet < 1u) t->wcet = 1u;
+        if (t->wcet > t->period) t->wcet = t->period;
+        u_eff += (double) t->wcet / t->period;
+    }
+    _assign_priorities();
+    return u_eff;
+}
+
+/* ---------------- Execution ---------------- */
+
+static void t_periodic(void *arg) {
+    stress_task_t *t = (stress_task_t *) arg;
+    for (uint32_t release = g_t0; release - g_t0 < g_horizon; release += t->period) {
+        const uint32_t now = hrt_tick_now();
+        if ((int32_t) (release - now) > 0) hrt_sleep(release - now);
+        hrt_sim_consume(t->wcet);
+
+        const uint32_t r = hrt_tick_now() - release;
+        uint32_t bin = (uint32_t) (((uint64_t) r * 100u) / t->period);
+        if (bin >= STRESS_RD_BINS) bin = STRESS_RD_BINS - 1;
+        g_row->rd_bins[bin]++;
+        t->jobs++;
+        if (r > t->period) t->misses++;
+        if (r > t->r_max) t->r_max = r;
+    }
+    bench_park();
+}
+
+static void _run_set(const int pol) {
+    bench_kernel_reset();
+    hrt_set_policy(k_policies[pol]);
+    g_t0 = hrt_tick_now();
+
+    for (int i = 0; i < g_ntasks; ++i) {
+        stress_task_t *t = &g_tasks[i];
+        t->jobs = t->misses = t->r_max = 0;
+        const hrt_task_attr_t a = {.priority = t->prio, .timeslice = g_slice};
+        bench_spawn_attr(t_periodic, t, &a);
+    }
+    /* Returns once every job released inside the horizon has completed */
+    hrt_sim_run_for(g_horizon);
+
+    uint32_t misses = 0;
+    for (int i = 0; i < g_ntasks; ++i) {
+        g_row->jobs += g_tasks[i].jobs;
+        misses += g_tasks[i].misses;
+    }
+    g_row->misses += misses;
+    g_row->sets++;
+    if (misses == 0) g_row->sets_ok++;
+}
+
+static void _print_set(const uint32_t set, const double util, const int pol) {
+    printf("set %u util %.2f %s\n", (unsigned) set, util, k_policy_names[pol]);
+    for (int i = 0; i < g_ntasks; ++i) {
+        const stress_task_t *t = &g_tasks[i];
+        printf("  task %d  T %4u  C %4u  prio %d  jobs %5u  misses %5u  R_max %5u\n", i, (unsigned) t->period,
+               (unsigned) t->wcet, (int) t->prio, (unsigned) t->jobs, (unsigned) t->misses, (unsigned) t->r_max);
+    }
+}
+
+/* ---------------- Reporting ---------------- */
+
+/* R/D at the given permille of all jobs in the row */
+static double _rd_percentile(const stress_row_t *row, const uint32_t permille) {
+    uint64_t total = 0;
+    for (int b = 0; b < STRESS_RD_BINS; ++b) total += row->rd_bins[b];
+    if (total == 0) return 0.0;
+    const uint64_t rank = (total * permille + 999u) / 1000u;
+    uint64_t seen = 0;
+    for (int b = 0; b < STRESS_RD_BINS; ++b) {
+        seen += row->rd_bins[b];
+        if (seen >= rank) return b / 100.0;
+    }
+    return (STRESS_RD_BINS - 1) / 100.0;
+}
+
+static double _rd_max(const stress_row_t *row) {
+    for (int b = STRESS_RD_BINS - 1; b >= 0; --b) {
+        if (row->rd_bins[b]) return b / 100.0;
+    }
+    return 0.0;
+}
+
+static void print_text(void) {
+    printf("%5s %6s %-12s %7s %9s %7s | %6s %6s %6s %6s\n", "util", "u_eff", "policy", "sched%", "jobs", "miss%",
+           "R/D50", "R/D90", "R/D99", "max");
+    for (int u = 0; u < g_nutils; ++u) {
+        for (int p = 0; p < STRESS_NPOLICIES; ++p) {
+            const stress_row_t *r = &g_rows[u][p];
+            if (r->sets == 0) continue;
+            printf("%5.2f %6.3f %-12s %7.1f %9llu %7.3f | %6.2f %6.2f %6.2f %6.2f\n", g_utils[u],
+                   r->u_eff_sum / r->sets, k_policy_names[p], 100.0 * r->sets_ok / r->sets,
+                   (unsigned long long) r->jobs, r->jobs ? 100.0 * (double) r->misses / (double) r->jobs : 0.0,
+                   _rd_percentile(r, 500), _rd_percentile(r, 900), _rd_percentile(r, 990), _rd_max(r));
+        }
+    }
+}
+
+static int write_json(const char *path, const uint64_t seed) {
+    FILE *f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "{\n  \"version\": \"%s\",\n  \"port\": \"%s\",\n", HARDRT_VERSION_STRING, hrt_port_name());
+    fprintf(f, "  \"max_tasks\": %d,\n  \"max_prio\": %d,\n  \"tasks\": %d,\n  \"sets\": %u,\n", HARDRT_MAX_TASKS,
+            HARDRT_MAX_PRIO, g_ntasks, (unsigned) g_sets);
+    fprintf(f, "  \"assign\": \"%s\",\n  \"slice\": %u,\n  \"hyper\": %u,\n  \"seed\": %llu,\n  \"rows\": [", g_assign,
+            (unsigned) g_slice, (unsigned) g_hyper, (unsigned long long) seed);
+    int first = 1;
+    for (int u = 0; u < g_nutils; ++u) {
+        for (int p = 0; p < STRESS_NPOLICIES; ++p) {
+            const stress_row_t *r = &g_rows[u][p];
+            if (r->sets == 0) continue;
+            fprintf(f, "%s\n    {\"util\": %.3f, \"u_eff\": %.4f, \"policy\": \"%s\", \"sets\": %u, \"sets_ok\": %u, "
+                       "\"jobs\": %llu, \"misses\": %llu, \"rd_p50\": %.2f, \"rd_p90\": %.2f, \"rd_p99\": %.2f, "
+                       "\"rd_max\": %.2f}",
+                    first ? "" : ",", g_utils[u], r->u_eff_sum / r->sets, k_policy_names[p], (unsigned) r->sets,
+                    (unsigned) r->sets_ok, (unsigned long long) r->jobs, (unsigned long long) r->misses,
+                    _rd_percentile(r, 500), _rd_percentile(r, 900), _rd_percentile(r, 990), _rd_max(r));
+            first = 0;
+        }
+    }
+    fprintf(f, "\n  ]\n}\n");
+    if (f != stdout) fclose(f);
+    return 0;
+}
+
+/* ---------------- Driver ---------------- */
+
+static int _parse_doubles(const char *s, double *out, const int max) {
+    int n = 0;
+    char *end;
+    while (*s && n < max) {
+        out[n++] = strtod(s, &end);
+        if (end == s) return -1;
+        s = (*end == ',') ? end + 1 : end;
+    }
+    return *s ? -1 : n;
+}
+
+static int _parse_periods(const char *s) {
+    int n = 0;
+    char *end;
+    while (*s && n < STRESS_MAX_PERIODS) {
+        const unsigned long v = strtoul(s, &end, 0);
+        if (end == s || v == 0 || v > 100000ul) return -1;
+        g_periods[n++] = (uint32_t) v;
+        s = (*end == ',') ? end + 1 : end;
+    }
+    return *s ? -1 : n;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--quick] [--tasks N] [--util U,U,...] [--sets N] [--periods T,T,...]\n"
+            "       [--assign rm|random|flat] [--policy priority|rr|priority_rr] [--slice N]\n"
+            "       [--hyper N] [--seed N] [--verbose] [--json FILE|-]\n",
+            argv0);
+}
+
+int main(const int argc, char **argv) {
+    const char *json = NULL;
+    g_ntasks = STRESS_MAX_TASKS < 8 ? STRESS_MAX_TASKS : 8;
+
+    for (int i = 1; i < argc; ++i) {
+        int bad = 0;
+        if (strcmp(argv[i], "--quick") == 0) {
+            g_sets = 3u;
+            g_hyper = 2u;
+        } else if (strcmp(argv[i], "--tasks") == 0 && i + 1 < argc) {
+            g_ntasks = atoi(argv[++i]);
+            bad = g_ntasks < 1 || g_ntasks > STRESS_MAX_TASKS;
+        } else if (strcmp(argv[i], "--util") == 0 && i + 1 < argc) {
+            g_nutils = _parse_doubles(argv[++i], g_utils, STRESS_MAX_UTILS);
+            bad = g_nutils < 1;
+        } else if (strcmp(argv[i], "--sets") == 0 && i + 1 < argc) {
+            g_sets = (uint32_t) strtoul(argv[++i], NULL, 0);
+            bad = g_sets == 0;
+        } else if (strcmp(argv[i], "--periods") == 0 && i + 1 < argc) {
+            g_nperiods = _parse_periods(argv[++i]);
+            bad = g_nperiods < 1;
+        } else if (strcmp(argv[i], "--assign") == 0 && i + 1 < argc) {
+            g_assign = argv[++i];
+            bad = strcmp(g_assign, "rm") != 0 && strcmp(g_assign, "random") != 0 && strcmp(g_assign, "flat") != 0;
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            ++i;
+            for (int p = 0; p < STRESS_NPOLICIES; ++p) {
+                if (strcmp(argv[i], k_policy_names[p]) == 0) g_policy_only = p;
+            }
+            bad = g_policy_only < 0;
+        } else if (strcmp(argv[i], "--slice") == 0 && i + 1 < argc) {
+            g_slice = (uint16_t) atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--hyper") == 0 && i + 1 < argc) {
+            g_hyper = (uint32_t) strtoul(argv[++i], NULL, 0);
+            bad = g_hyper == 0;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            g_seed = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            g_verbose = 1;
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json = argv[++i];
+        } else {
+            bad = 1;
+        }
+        if (bad) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    for (int u = 0; u < g_nutils; ++u) {
+        if (g_utils[u] <= 0.0 || g_utils[u] > (double) g_ntasks) {
+            fprintf(stderr, "hardrt_stress: utilisation %.3f outside (0, %d]\n", g_utils[u], g_ntasks);
+            return 2;
+        }
+    }
+
+    const uint64_t seed = g_seed;
+    if (g_seed == 0) g_seed = 1; /* xorshift has no zero state */
+    uint32_t t_max = 0;
+    for (int i = 0; i < g_nperiods; ++i) {
+        if (g_periods[i] > t_max) t_max = g_periods[i];
+    }
+    g_horizon = g_hyper * t_max;
+
+    const int to_stdout = json && strcmp(json, "-") == 0;
+    if (!to_stdout) {
+        printf("HardRT %s stress (port %s, max_tasks %d, max_prio %d)\n", HARDRT_VERSION_STRING, hrt_port_name(),
+               HARDRT_MAX_TASKS, HARDRT_MAX_PRIO);
+        printf("%d tasks, %u sets per point, assign %s, slice %u, horizon %u ticks, seed %llu\n", g_ntasks,
+               (unsigned) g_sets, g_assign, (unsigned) g_slice, (unsigned) g_horizon, (unsigned long long) seed);
+    }
+
+    for (int u = 0; u < g_nutils; ++u) {
+        for (uint32_t s = 0; s < g_sets; ++s) {
+            const double u_eff = _generate_set(g_utils[u]);
+            for (int p = 0; p < STRESS_NPOLICIES; ++p) {
+                if (g_policy_only >= 0 && p != g_policy_only) continue;
+                g_row = &g_rows[u][p];
+                g_row->u_eff_sum += u_eff;
+                _run_set(p);
+                if (g_verbose && !to_stdout) _print_set(s, g_utils[u], p);
+            }
+        }
+    }
+
+    if (!to_stdout) print_text();
+    if (json && write_json(json, seed) != 0) return 1;
+    return 0;
+}
@@ -0,0 +1,256 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* HardRT Cortex-M instruction-count benchmark for QEMU mps2-an385.
+ *
+ * QEMU has no DWT cycle counter. Run with `-icount shift=0` instead: virtual
+ * time then advances exactly 1 ns per executed instruction. The CMSDK APB
+ * timer 0 (25 MHz) follows virtual time, so one timer count is 40
+ * instructions. Every figure is an average over BENCH_N operations, which
+ * takes the timer quantisation down to well below one instruction, and the
+ * run is fully deterministic.
+ *
+ * Paths (instructions per operation, one decimal):
+ *   tick_isr      hrt_tick_from_isr() with 4 far-future sleepers
+ *   schedule      hrt__schedule() alone (linked with --wrap=hrt__schedule)
+ *   pendsv        hrt_yield() to first instruction of the next task, minus schedule
+ *   yield_switch  hrt_yield() to first instruction of the next task
+ *   sem_give_take hrt_sem_give() in a PRIO1 task to hrt_sem_take() returning in PRIO0
+ *   queue_generic hrt_queue_try_send() + hrt_queue_try_recv() of a 16-byte item, no waiters
+ *   queue_typed   the same pair through the HRT_QUEUE_DEFINE inline calls
+ *
+ * Results are printed over semihosting as "hrt_qemu_bench: <path> <insns>"
+ * and the program exits through SYS_EXIT. */
+#include <stdint.h>
+
+#include "hardrt.h"
+#include "hardrt_queue.h"
+#include "hardrt_sem.h"
+#include "hardrt_time.h"
+
+#define BENCH_N          2000u
+#define BENCH_SLEEPERS   4u
+#define INSNS_PER_COUNT  40u   /* 1 GHz instruction clock (icount shift=0) / 25 MHz timer */
+#define STACK_WORDS      512u
+#define QUEUE_DEPTH      8u
+
+/* Core clock seen by the port; mps2-an385 SYSCLK */
+uint32_t SystemCoreClock = 25000000u;
+
+/* -------- CMSDK APB timer 0: free-running 32-bit down-counter -------- */
+#define TMR0_CTRL   (*(volatile uint32_t *) 0x40000000u)
+#define TMR0_VALUE  (*(volatile uint32_t *) 0x40000004u)
+#define TMR0_RELOAD (*(volatile uint32_t *) 0x40000008u)
+
+static void timer_init(void) {
+    TMR0_CTRL = 0;
+    TMR0_RELOAD = 0xFFFFFFFFu;
+    TMR0_VALUE = 0xFFFFFFFFu;
+    TMR0_CTRL = 1u; /* enable, no interrupt */
+}
+
+static inline uint32_t now(void) { return TMR0_VALUE; }
+/* Down-counter: elapsed counts from a to b */
+static inline uint32_t since(const uint32_t a, const uint32_t b) { return a - b; }
+
+/* -------- Semihosting -------- */
+static int semihost(const int op, const void *arg) {
+    register int r0 __asm__("r0") = op;
+    register const void *r1 __asm__("r1") = arg;
+    __asm volatile("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+
+static void put(const char *s) { semihost(0x04 /* SYS_WRITE0 */, s); }
+
+static void sh_exit(void) {
+    const uint32_t args[2] = {0x20026u /* ADP_Stopped_ApplicationExit */, 0};
+    semihost(0x18 /* SYS_EXIT */, args);
+    for (;;) {
+    }
+}
+
+/* "hrt_qemu_bench: <name> <tenths as N.N>\n" */
+static void report(const char *name, const uint64_t counts, const uint32_t ops) {
+    const uint32_t tenths = (uint32_t) ((counts * INSNS_PER_COUNT * 10u + ops / 2u) / ops);
+    char num[16];
+    int i = (int) sizeof(num) - 1;
+    num[i] = '\0';
+    num[--i] = (char) ('0' + tenths % 10u);
+    num[--i] = '.';
+    uint32_t v = tenths / 10u;
+    do {
+        num[--i] = (char) ('0' + v % 10u);
+        v /= 10u;
+    } while (v && i > 0);
+    put("hrt_qemu_bench: ");
+    put(name);
+    put(" ");
+    put(&num[i]);
+    put("\n");
+}
+
+/* -------- hrt__schedule() instrumentation (--wrap) -------- */
+uintptr_t __real_hrt__schedule(uintptr_t old_sp);
+static volatile uint32_t g_sched_calls = 0;
+static volatile uint64_t g_sched_counts = 0;
+
+uintptr_t __wrap_hrt__schedule(const uintptr_t old_sp) {
+    const uint32_t t0 = now();
+    const uintptr_t sp = __real_hrt__schedule(old_sp);
+    g_sched_counts += since(t0, now());
+    g_sched_calls++;
+    return sp;
+}
+
+/* -------- Tasks -------- */
+static uint32_t s_driver[STACK_WORDS] __attribute__((aligned(8)));
+static uint32_t s_y1[STACK_WORDS] __attribute__((aligned(8)));
+static uint32_t s_y2[STACK_WORDS] __attribute__((aligned(8)));
+static uint32_t s_taker[STACK_WORDS] __attribute__((aligned(8)));
+static uint32_t s_giver[STACK_WORDS] __attribute__((aligned(8)));
+static uint32_t s_sleep[BENCH_SLEEPERS][STACK_WORDS] __attribute__((aligned(8)));
+
+static hrt_sem_t g_go_yield, g_go_y2, g_go_sem, g_done, g_sem;
+static volatile uint32_t g_t_give = 0;
+static volatile uint64_t g_give_take_counts = 0;
+static volatile uint32_t g_read_overhead = 0; /* counts for a back-to-back now() pair, x BENCH_N */
+
+/* Generic vs typed queue: same item, depth and alignment, so the difference is the inline path */
+typedef struct { uint32_t w[4]; } bench_item_t;
+static uint32_t g_gq_store[QUEUE_DEPTH * sizeof(bench_item_t) / 4u];
+static hrt_queue_t g_gq;
+HRT_QUEUE_DEFINE(g_tq, bench_item_t, QUEUE_DEPTH)
+static volatile uint32_t g_q_sink = 0;
+
+static void t_sleeper(void *arg) {
+    (void) arg;
+    for (;;) hrt_sleep(1000000u);
+}
+
+static void t_yield(void *arg) {
+    hrt_sem_t *go = (hrt_sem_t *) arg;
+    for (;;) {
+        hrt_sem_take(go);
+        if (go == &g_go_yield) hrt_sem_give(&g_go_y2); /* bring the partner in at the same priority */
+        for (uint32_t i = 0; i < BENCH_N; ++i) hrt_yield();
+        hrt_sem_give(&g_done);
+    }
+}
+
+static void t_taker(void *arg) {
+    (void) arg;
+    for (;;) {
+        hrt_sem_take(&g_sem);
+        g_give_take_counts += since(g_t_give, now());
+    }
+}
+
+static void t_giver(void *arg) {
+    (void) arg;
+    for (;;) {
+        hrt_sem_take(&g_go_sem);
+        for (uint32_t i = 0; i < BENCH_N; ++i) {
+            g_t_give = now();
+            hrt_sem_give(&g_sem); /* PRIO0 taker runs before this returns */
+        }
+        hrt_sem_give(&g_done);
+    }
+}
+
+/* Lowest priority: runs each bench by waking its tasks, then reports */
+static void t_driver(void *arg) {
+    (void) arg;
+
+    /* Cost of the measurement itself */
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < BENCH_N; ++i) {
+        const uint32_t a = now();
+        acc += since(a, now());
+    }
+    g_read_overhead = (uint32_t) acc;
+
+    uint32_t t0 = now();
+    for (uint32_t i = 0; i < BENCH_N; ++i) __asm volatile("" ::: "memory");
+    const uint32_t empty = since(t0, now());
+
+    /* Tick ISR: sleepers are parked far in the future, the driver is cooperative */
+    t0 = now();
+    for (uint32_t i = 0; i < BENCH_N; ++i) hrt_tick_from_isr();
+    report("tick_isr", since(t0, now()) - empty, BENCH_N);
+
+    /* Yield ping-pong: every switch passes through PendSV and hrt__schedule() */
+    g_sched_calls = 0;
+    g_sched_counts = 0;
+    t0 = now();
+    hrt_sem_give(&g_go_yield);
+    hrt_sem_take(&g_done);
+    hrt_sem_take(&g_done);
+    const uint32_t yield_total = since(t0, now());
+    const uint32_t calls = g_sched_calls;
+    const uint64_t sched = g_sched_counts > (uint64_t) calls * g_read_overhead / BENCH_N
+                               ? g_sched_counts - (uint64_t) calls * g_read_overhead / BENCH_N
+                               : 0u;
+    report("schedule", sched, calls);
+    report("yield_switch", yield_total, calls);
+    report("pendsv", yield_total > sched ? yield_total - sched : 0u, calls);
+
+    /* Semaphore give -> take */
+    g_give_take_counts = 0;
+    hrt_sem_give(&g_go_sem);
+    hrt_sem_take(&g_done);
+    report("sem_give_take", g_give_take_counts > g_read_overhead ? g_give_take_counts - g_read_overhead : 0u,
+           BENCH_N);
+
+    /* Queue send + receive pairs from the driver alone: no waiter, no switch */
+    const bench_item_t in = {{1u, 2u, 3u, 4u}};
+    bench_item_t out;
+    hrt_queue_init(&g_gq, g_gq_store, QUEUE_DEPTH, sizeof(bench_item_t));
+    t0 = now();
+    for (uint32_t i = 0; i < BENCH_N; ++i) {
+        hrt_queue_try_send(&g_gq, &in);
+        hrt_queue_try_recv(&g_gq, &out);
+        g_q_sink = out.w[3];
+    }
+    report("queue_generic", since(t0, now()) - empty, BENCH_N);
+
+    t0 = now();
+    for (uint32_t i = 0; i < BENCH_N; ++i) {
+        g_tq_try_send(&in);
+        g_tq_try_recv(&out);
+        g_q_sink = out.w[3];
+    }
+    report("queue_typed", since(t0, now()) - empty, BENCH_N);
+
+    sh_exit();
+}
+
+int main(void) {
+    timer_init();
+
+    /* External tick: SysTick stays off so no tick lands inside a measurement */
+    const hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 0,
+                              .core_hz = 25000000u, .tick_src = HRT_TICK_EXTERNAL};
+    hrt_init(&cfg);
+
+    hrt_sem_init(&g_go_yield, 0);
+    hrt_sem_init(&g_go_y2, 0);
+    hrt_sem_init(&g_go_sem, 0);
+    hrt_sem_init(&g_sem, 0);
+    hrt_sem_init_counting(&g_done, 0, 2);
+
+    const hrt_task_attr_t p0 = {.priority = HRT_PRIO0, .timeslice = 0};
+    const hrt_task_attr_t p1 = {.priority = HRT_PRIO1, .timeslice = 0};
+    const hrt_task_attr_t p3 = {.priority = HRT_PRIO3, .timeslice = 0};
+
+    for (uint32_t i = 0; i < BENCH_SLEEPERS; ++i) {
+        hrt_create_task(t_sleeper, NULL, s_sleep[i], STACK_WORDS, &p0);
+    }
+    hrt_create_task(t_taker, NULL, s_taker, STACK_WORDS, &p0);
+    hrt_create_task(t_giver, NULL, s_giver, STACK_WORDS, &p1);
+    hrt_create_task(t_yield, &g_go_yield, s_y1, STACK_WORDS, &p1);
+    hrt_create_task(t_yield, &g_go_y2, s_y2, STACK_WORDS, &p1);
+    hrt_create_task(t_driver, NULL, s_driver, STACK_WORDS, &p3);
+
+    put("hrt_qemu_bench: start\n");
+    hrt_start();
+    return 0;
+}
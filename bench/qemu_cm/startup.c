@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Minimal vector table and reset handler for QEMU mps2-an385 */
+#include <stdint.h>
+
+extern uint32_t _estack, _sidata, _sdata, _edata, _sbss, _ebss;
+extern int main(void);
+extern void PendSV_Handler(void);
+extern void SysTick_Handler(void);
+
+void Reset_Handler(void);
+
+static void Default_Handler(void) {
+    for (;;) {
+    }
+}
+
+__attribute__((section(".isr_vector"), used))
+static void (*const g_vectors[16])(void) = {
+    (void (*)(void)) &_estack,
+    Reset_Handler,
+    Default_Handler, /* NMI */
+    Default_Handler, /* HardFault */
+    Default_Handler, /* MemManage */
+    Default_Handler, /* BusFault */
+    Default_Handler, /* UsageFault */
+    0, 0, 0, 0,
+    Default_Handler, /* SVCall */
+    Default_Handler, /* DebugMon */
+    0,
+    PendSV_Handler,
+    SysTick_Handler,
+};
+
+void Reset_Handler(void) {
+    uint32_t *src = &_sidata;
+    for (uint32_t *dst = &_sdata; dst < &_edata;) *dst++ = *src++;
+    for (uint32_t *dst = &_sbss; dst < &_ebss;) *dst++ = 0;
+    main();
+    for (;;) {
+    }
+}
@@ -0,0 +1,136 @@
+# HardRT benchmark targets (included only when HARDRT_BUILD_BENCH is ON)
+
+# Benchmarks drive the POSIX scheduler in virtual time; other ports have no host runtime
+if(NOT HARDRT_PORT STREQUAL "posix")
+  message(STATUS "Benchmarks are enabled but HARDRT_PORT=${HARDRT_PORT} has no runtime scheduler; skipping bench targets")
+  return()
+endif()
+
+# Numbers from a Debug build are meaningless; default bench code to -O2
+if(NOT CMAKE_BUILD_TYPE OR CMAKE_BUILD_TYPE STREQUAL "Debug")
+  set(HARDRT_BENCH_OPT -O2)
+endif()
+
+# Build a private copy of the kernel sized <cfg_tasks>/<cfg_prio>.
+# Benchmarks never link ${LIB_NAME}: with tests enabled it is compiled with
+# HARDRT_TEST_HOOKS, whose diagnostics would end up in the timed paths.
+# Extra arguments are passed to add_library() (e.g. EXCLUDE_FROM_ALL).
+function(hardrt_add_kernel name cfg_tasks cfg_prio)
+  math(EXPR _max_tasks "${cfg_tasks} + 1")
+  add_library(${name} STATIC ${ARGN}
+          ${LIBRARY_SOURCES}
+          "${SOURCE_PORT_DIR}/posix/port_posix.c"
+  )
+  target_compile_definitions(${name}
+          PUBLIC
+          HARDRT_MAX_TASKS=${_max_tasks}
+          HARDRT_MAX_PRIO=${cfg_prio}
+          HARDRT_STALL_ON_ERROR=0
+          HARDRT_DEBUG=${HARDRT_DEBUG}
+          HARDRT_STATS=${HARDRT_STATS}
+          HARDRT_TRACE=${HARDRT_TRACE}
+          HARDRT_LATENCY=${HARDRT_LATENCY}
+          HARDRT_STACK_CHECK=${HARDRT_STACK_CHECK}
+          HARDRT_OBJ_STATS=${HARDRT_OBJ_STATS}
+          HARDRT_IRQOFF=${HARDRT_IRQOFF}
+          HARDRT_ISR_DEFER=${HARDRT_ISR_DEFER}
+          HARDRT_POSIX_GUARD_PAGES=${HARDRT_POSIX_GUARD_PAGES}
+          HARDRT_POSIX_PERF=${HARDRT_POSIX_PERF}
+          HARDRT_POSIX_PROF=${HARDRT_POSIX_PROF}
+          HARDRT_POSIX_SHM=${HARDRT_POSIX_SHM}
+  )
+  target_include_directories(${name}
+          PUBLIC ${INCLUDE_DIR} ${CMAKE_BINARY_DIR}/generated
+  )
+  target_compile_features(${name} PUBLIC c_std_11)
+  # Exactly ${LIB_NAME}'s options: the directory-wide HARDRT_STRICT warnings are
+  # added after ${LIB_NAME} is created and must not leak into this copy either.
+  get_target_property(_lib_opts ${LIB_NAME} COMPILE_OPTIONS)
+  set_property(TARGET ${name} PROPERTY COMPILE_OPTIONS ${_lib_opts} ${HARDRT_BENCH_OPT})
+  target_link_libraries(${name} PUBLIC Threads::Threads)
+  if(HARDRT_POSIX_PROF)
+    target_link_libraries(${name} PUBLIC rt ${CMAKE_DL_LIBS})
+    target_link_options(${name} PUBLIC -rdynamic)
+  endif ()
+  if(HARDRT_POSIX_SHM)
+    target_link_libraries(${name} PUBLIC rt)
+  endif ()
+endfunction()
+
+hardrt_add_kernel(hardrt_bench_kernel ${HARDRT_CFG_MAX_TASKS} ${HARDRT_CFG_MAX_PRIO})
+
+add_executable(hardrt_bench ${CMAKE_SOURCE_DIR}/bench/hardrt_bench.c)
+target_link_libraries(hardrt_bench PRIVATE hardrt_bench_kernel)
+target_compile_features(hardrt_bench PRIVATE c_std_11)
+target_compile_options(hardrt_bench PRIVATE ${HARDRT_BENCH_OPT})
+
+# Synthetic periodic task sets (UUniFast) run under every policy; deadline misses and R/D
+add_executable(hardrt_stress ${CMAKE_SOURCE_DIR}/bench/hardrt_stress.c)
+target_link_libraries(hardrt_stress PRIVATE hardrt_bench_kernel m)
+target_compile_features(hardrt_stress PRIVATE c_std_11)
+target_compile_options(hardrt_stress PRIVATE ${HARDRT_BENCH_OPT})
+
+# Smoke runs so the suite keeps building and running; not a performance check
+if(HARDRT_BUILD_TESTS)
+  add_test(NAME hardrt_bench_smoke COMMAND hardrt_bench --quick)
+  add_test(NAME hardrt_stress_smoke COMMAND hardrt_stress --quick)
+endif()
+
+# ---- Performance regression gate ----
+# hardrt_perf_gate compares medians (normalised to a host swapcontext) with a checked-in
+# baseline and fails on a slowdown beyond the tolerance. It is skipped (CTest code 77)
+# when the baseline was recorded for another configuration. Re-record on purpose with
+# `cmake --build . --target hardrt_perf_baseline`.
+set(HARDRT_PERF_BASELINE "${CMAKE_SOURCE_DIR}/bench/baseline_posix.json" CACHE FILEPATH "Baseline for hardrt_perf_gate")
+set(HARDRT_PERF_TOLERANCE "25" CACHE STRING "Allowed slowdown in percent before hardrt_perf_gate fails")
+set(_hrt_perf_args --iters 20000 --reps 7)
+
+if(HARDRT_BUILD_TESTS)
+  add_test(NAME hardrt_perf_gate
+          COMMAND hardrt_bench ${_hrt_perf_args} --check ${HARDRT_PERF_BASELINE} --tolerance ${HARDRT_PERF_TOLERANCE})
+  set_tests_properties(hardrt_perf_gate PROPERTIES LABELS perf SKIP_RETURN_CODE 77 RUN_SERIAL TRUE)
+endif()
+
+add_custom_target(hardrt_perf_baseline
+        COMMAND hardrt_bench ${_hrt_perf_args} --json ${HARDRT_PERF_BASELINE}
+        DEPENDS hardrt_bench
+        USES_TERMINAL
+        VERBATIM
+        COMMENT "Recording ${HARDRT_PERF_BASELINE}"
+)
+
+# ---- Configuration matrix (built and run on demand: `cmake --build . --target hardrt_bench_matrix`) ----
+# One kernel + hardrt_scale per grid point; each prints a row of ns/op and object sizes.
+set(HARDRT_BENCH_MATRIX_TASKS "8;16;32;64;128;255" CACHE STRING "HARDRT_CFG_MAX_TASKS values for hardrt_bench_matrix")
+set(HARDRT_BENCH_MATRIX_PRIOS "1;2;4;8;12" CACHE STRING "HARDRT_CFG_MAX_PRIO values for hardrt_bench_matrix")
+
+set(_hrt_matrix_exes "")
+foreach(_t IN LISTS HARDRT_BENCH_MATRIX_TASKS)
+  foreach(_p IN LISTS HARDRT_BENCH_MATRIX_PRIOS)
+    if(_t LESS _p)
+      continue()
+    endif()
+    hardrt_add_kernel(hardrt_kernel_t${_t}_p${_p} ${_t} ${_p} EXCLUDE_FROM_ALL)
+    add_executable(hardrt_scale_t${_t}_p${_p} EXCLUDE_FROM_ALL ${CMAKE_SOURCE_DIR}/bench/hardrt_scale.c)
+    target_link_libraries(hardrt_scale_t${_t}_p${_p} PRIVATE hardrt_kernel_t${_t}_p${_p})
+    target_compile_options(hardrt_scale_t${_t}_p${_p} PRIVATE ${HARDRT_BENCH_OPT})
+    list(APPEND _hrt_matrix_exes hardrt_scale_t${_t}_p${_p})
+  endforeach()
+endforeach()
+
+set(_hrt_matrix_files "")
+foreach(_exe IN LISTS _hrt_matrix_exes)
+  list(APPEND _hrt_matrix_files "$<TARGET_FILE:${_exe}>")
+endforeach()
+string(REPLACE ";" "|" _hrt_matrix_files "${_hrt_matrix_files}")
+
+add_custom_target(hardrt_bench_matrix
+        COMMAND ${CMAKE_COMMAND}
+                "-DEXES=${_hrt_matrix_files}"
+                "-DOUT=${CMAKE_BINARY_DIR}/bench_matrix.txt"
+                -P ${CMAKE_CURRENT_LIST_DIR}/hardrt_bench_matrix.cmake
+        DEPENDS ${_hrt_matrix_exes}
+        USES_TERMINAL
+        VERBATIM
+        COMMENT "Running the HardRT configuration matrix"
+)
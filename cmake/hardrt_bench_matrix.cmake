@@ -0,0 +1,26 @@
+# Script mode (cmake -P): run every hardrt_scale build and collect one table.
+#   EXES - '|'-separated list of executables, in grid order
+#   OUT  - file receiving the table (also printed)
+
+string(REPLACE "|" ";" _exes "${EXES}")
+set(_table "")
+set(_first TRUE)
+foreach(_exe IN LISTS _exes)
+  if(_first)
+    set(_args --header)
+    set(_first FALSE)
+  else()
+    set(_args "")
+  endif()
+  execute_process(COMMAND "${_exe}" ${_args}
+          OUTPUT_VARIABLE _row
+          RESULT_VARIABLE _rc)
+  if(NOT _rc EQUAL 0)
+    message(FATAL_ERROR "${_exe} failed (${_rc})")
+  endif()
+  string(APPEND _table "${_row}")
+endforeach()
+
+file(WRITE "${OUT}" "${_table}")
+message("${_table}")
+message(STATUS "Matrix written to ${OUT}")
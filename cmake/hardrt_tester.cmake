@@ -30,7 +30,21 @@ if(HARDRT_PORT STREQUAL "posix")
           ${CMAKE_SOURCE_DIR}/tests/test_task_return.c
           ${CMAKE_SOURCE_DIR}/tests/test_semaphore.c
           ${CMAKE_SOURCE_DIR}/tests/test_queue.c
+          ${CMAKE_SOURCE_DIR}/tests/test_select.c
           ${CMAKE_SOURCE_DIR}/tests/test_external_tick.c
+          ${CMAKE_SOURCE_DIR}/tests/test_virtual_time.c
+          ${CMAKE_SOURCE_DIR}/tests/test_irq_sim.c
+          ${CMAKE_SOURCE_DIR}/tests/test_stats.c
+          ${CMAKE_SOURCE_DIR}/tests/test_trace.c
+          ${CMAKE_SOURCE_DIR}/tests/test_stack.c
+          ${CMAKE_SOURCE_DIR}/tests/test_guard.c
+          ${CMAKE_SOURCE_DIR}/tests/test_latency.c
+          ${CMAKE_SOURCE_DIR}/tests/test_obj_stats.c
+          ${CMAKE_SOURCE_DIR}/tests/test_irqoff.c
+          ${CMAKE_SOURCE_DIR}/tests/test_isr.c
+          ${CMAKE_SOURCE_DIR}/tests/test_posix_perf.c
+          ${CMAKE_SOURCE_DIR}/tests/test_posix_prof.c
+          ${CMAKE_SOURCE_DIR}/tests/test_posix_shm.c
           ${CMAKE_SOURCE_DIR}/tests/test_idle_behavior.c
           ${CMAKE_SOURCE_DIR}/tests/test_mutex.c
           ${CMAKE_SOURCE_DIR}/tests/test_now_ms.c
@@ -3,6 +3,7 @@
 #include "hardrt_sem.h"
 #include "hardrt_queue.h"
 #include "hardrt_mutex.h"
+#include "hardrt_select.h"
 
 #include <array>
 #include <cstddef>
@@ -178,7 +179,7 @@ namespace hardrt {
          * @brief Initialize a semaphore. Binary by default, counting if max_count > 1.
          * @param init Initial state: 1 (available/given), 0 (unavailable/taken).
          */
-        explicit Semaphore(unsigned init = 0, uint8_t max_count = 1) {
+        explicit Semaphore(unsigned init = 0, uint32_t max_count = 1) {
             if (max_count <= 1) {
                 // Preserve strict binary semantics
                 hrt_sem_init(&_sem, init);
@@ -226,6 +227,8 @@ namespace hardrt {
             return hrt_sem_give_from_isr(&_sem, &need_switch);
         }
 
+        hrt_sem_t* native_handle() { return &_sem; }
+
     private:
         hrt_sem_t _sem;
     };
@@ -329,8 +332,8 @@ namespace hardrt {
 
     class Mutex {
     public:
-        Mutex() {
-            hrt_mutex_init(&_m);
+        explicit Mutex(hrt_mutex_mode_t mode = HRT_MUTEX_HANDOFF) {
+            hrt_mutex_init_mode(&_m, mode);
         }
 
         int lock() {
@@ -349,4 +352,75 @@ namespace hardrt {
         hrt_mutex_t _m;
     };
 
+    /**
+     * @brief Set of queues and semaphores waited on together (hrt_select_t).
+     *
+     * add() returns the member index that wait() reports. wait() consumes nothing:
+     * follow up with try_recv()/try_take() on that member, and wait again if it fails.
+     * Members point back at the set, so it cannot be copied.
+     */
+    class Select {
+    public:
+        Select() {
+            hrt_select_init(&_s);
+        }
+
+        Select(const Select&) = delete;
+        Select& operator=(const Select&) = delete;
+
+        int add(Semaphore& sem) {
+            return hrt_select_add_sem(&_s, sem.native_handle());
+        }
+
+        template <typename T>
+        int add(QueueRef<T>& q) {
+            return hrt_select_add_queue(&_s, q.native_handle());
+        }
+
+        template <typename T, size_t Capacity>
+        int add(StaticQueue<T, Capacity>& q) {
+            return hrt_select_add_queue(&_s, q.native_handle());
+        }
+
+        /**
+         * @brief Block until a member is ready.
+         * @return Index of the first ready member, or -1 if the set is empty.
+         */
+        int wait() {
+            return hrt_select_wait(&_s);
+        }
+
+        /**
+         * @brief Index of the first ready member, or -1 if none is ready.
+         */
+        int try_wait() {
+            return hrt_select_try(&_s);
+        }
+
+        hrt_select_t* native_handle() { return &_s; }
+
+    private:
+        hrt_select_t _s;
+    };
+
+    /**
+     * @brief ISR bracket for the scope of an interrupt handler.
+     *
+     * Calls hrt_isr_enter() on construction and hrt_isr_exit() on destruction,
+     * so the wake-ups of the handler end in at most one context switch.
+     */
+    class IsrScope {
+    public:
+        IsrScope() {
+            hrt_isr_enter();
+        }
+
+        ~IsrScope() {
+            hrt_isr_exit();
+        }
+
+        IsrScope(const IsrScope&) = delete;
+        IsrScope& operator=(const IsrScope&) = delete;
+    };
+
 } // namespace hardrt
@@ -1,5 +1,8 @@
 #include "hardrt.h"
 #include "hardrt_queue.h"
+#ifdef HARDRT_PORT_POSIX
+#include "hardrt_posix.h"
+#endif
 
 #include <stdio.h>
 #include <stdint.h>
@@ -57,6 +60,10 @@ int main(void) {
 
     /* init queue before starting tasks */
     hrt_queue_init(&q_u32, q_storage, 32, sizeof(uint32_t));
+#ifdef HARDRT_PORT_POSIX
+    /* With -DHARDRT_POSIX_SHM=ON, `hrt-top` shows its depth live (no-op otherwise) */
+    (void)hrt_posix_shm_watch("q_u32", &q_u32, HRT_SHM_OBJ_QUEUE);
+#endif
 
     const hrt_task_attr_t p0 = { .priority = HRT_PRIO0, .timeslice = 0 };
     const hrt_task_attr_t p1 = { .priority = HRT_PRIO1, .timeslice = 5 };
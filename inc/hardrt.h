@@ -31,6 +31,13 @@ extern "C" {
 #include "hardrt_sem.h"
 #include "hardrt_mutex.h"
 #include "hardrt_queue.h"
+#include "hardrt_stats.h"
+#include "hardrt_trace.h"
+#include "hardrt_stack.h"
+#include "hardrt_latency.h"
+#include "hardrt_objstats.h"
+#include "hardrt_irqoff.h"
+#include "hardrt_isr.h"
 
 
 /**
@@ -69,7 +76,8 @@ typedef enum {
     ERR_DUP_READY = 15,
     ERR_MUTEX_OWNER = 16,
     ERR_MUTEX_RECURSIVE = 17,
-    ERR_MUTEX_BAD_CTX = 18
+    ERR_MUTEX_BAD_CTX = 18,
+    ERR_STACK_OVERFLOW = 19
 }hrt_err;
 
 /**
@@ -105,7 +113,8 @@ typedef enum {
 
 typedef enum {
     HRT_TICK_SYSTICK = 0, // port owns the periodic tick (e.g., SysTick)
-    HRT_TICK_EXTERNAL = 1 // app owns a timer and calls hrt_tick_from_isr() in its ISR
+    HRT_TICK_EXTERNAL = 1, // app owns a timer and calls hrt_tick_from_isr() in its ISR
+    HRT_TICK_VIRTUAL = 2 // POSIX only: no timer; time jumps to the next wake deadline when idle
 } hrt_tick_source_t;
 
 /**
@@ -140,6 +149,15 @@ typedef struct {
     uint16_t  slice_left;
     uint8_t   prio;
     uint8_t   state;
+    void*     wait_buf;  /* item buffer of a blocked queue send/recv; NULL once a peer moved the item */
+#if HARDRT_STATS == 1
+    uint64_t  st_run_cycles;
+    uint64_t  st_win_cycles;   /* run_cycles at the start of the load window */
+    uint32_t  st_switches_in;
+    uint32_t  st_preempted;
+    uint32_t  st_voluntary;
+    uint16_t  st_load_permille;
+#endif
 } _hrt_tcb_t;
 
 _hrt_tcb_t *hrt__tcb(int id);
@@ -274,6 +292,18 @@ void hrt_set_default_timeslice(uint16_t t);
  */
 void hrt_port_start_systick(uint32_t tick_hz);
 
+/**
+ * @brief Free-running high-resolution counter used for kernel accounting.
+ * @return Current counter value; wraps at 32 bits.
+ * @note Cortex-M: DWT->CYCCNT. POSIX: CLOCK_MONOTONIC nanoseconds. Null: 0.
+ */
+uint32_t hrt_port_cycles(void);
+
+/**
+ * @brief Frequency of hrt_port_cycles() in Hz (0 if the port has no counter).
+ */
+uint32_t hrt_port_cycles_hz(void);
+
 /**
  * @brief Optional low-power or blocking wait used by the idle loop.
  * @note Port may sleep the CPU until the next interrupt or event.
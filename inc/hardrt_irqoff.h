@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_IRQOFF_H
+#define HARDRT_IRQOFF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "hardrt_latency.h"
+
+/**
+ * @brief Measure how long the kernel keeps interrupts masked.
+ * @note Set through the HARDRT_IRQOFF CMake option. When 0 nothing is timed
+ *       and hrt_irqoff_stats() returns -1.
+ */
+#ifndef HARDRT_IRQOFF
+#define HARDRT_IRQOFF 0
+#endif
+
+/** @brief Kind of masked window. */
+typedef enum {
+    HRT_IRQOFF_CRIT = 0, /**< Outermost hrt_port_crit_enter() .. hrt_port_crit_exit() */
+    HRT_IRQOFF_SWITCH,   /**< Context-switch path: PendSV (Cortex-M), the port's tick/IRQ signal mask (POSIX) */
+    HRT_IRQOFF_SOURCES
+} hrt_irqoff_src_t;
+
+/**
+ * @brief Masked-window lengths of one source.
+ * @note Samples are in hrt_port_cycles() units; the histogram has the layout of
+ *       the wake-to-run latency one, so hrt_latency_percentile() applies.
+ */
+typedef struct {
+    hrt_latency_t hist;
+    uintptr_t max_site; /**< Return address in the caller that opened the longest window (0 for HRT_IRQOFF_SWITCH) */
+} hrt_irqoff_t;
+
+/**
+ * @brief Read the masked-time histogram of a source.
+ * @param src Source.
+ * @param out Destination.
+ * @return 0 on success; -1 on a bad source or if HARDRT_IRQOFF is off.
+ */
+int hrt_irqoff_stats(hrt_irqoff_src_t src, hrt_irqoff_t *out);
+
+/**
+ * @brief Clear all sources (hrt_init() does this too).
+ */
+void hrt_irqoff_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
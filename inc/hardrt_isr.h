@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_ISR_H
+#define HARDRT_ISR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Open an ISR bracket; call first thing in an ISR that uses *_from_isr() APIs.
+ * @note Inside a bracket the *_from_isr() calls only note what they woke; the
+ *       switch decision is taken once, by the outermost hrt_isr_exit(). Brackets
+ *       nest (count, not flag), so nested handlers can use them too. Calls made
+ *       outside any bracket pend a switch per wake-up, as before.
+ */
+void hrt_isr_enter(void);
+
+/**
+ * @brief Close an ISR bracket; call last thing in the ISR.
+ * @return 1 if this (outermost) exit pended a context switch, because a task it
+ *         woke outranks the interrupted one; 0 otherwise. With HARDRT_ISR_DEFER
+ *         the priority of a posted wake-up is not known yet, so any post pends.
+ */
+int hrt_isr_exit(void);
+
+/**
+ * @brief Defer the kernel work of *_from_isr() calls to the next scheduling point.
+ * @note Set through the HARDRT_ISR_DEFER CMake option. When 1,
+ *       hrt_sem_give_from_isr() and the wake-up half of the queue ISR calls only
+ *       post a command into a lock-free ring; the port applies the ring at PendSV
+ *       (Cortex-M) or on the way into the scheduler (POSIX), before the next pick.
+ *       A give therefore becomes visible to tasks at the next switch, and the ISR
+ *       call always reports *need_switch = 1 once something was posted.
+ */
+#ifndef HARDRT_ISR_DEFER
+#define HARDRT_ISR_DEFER 0
+#endif
+
+/**
+ * @brief Commands the post ring holds (power of two).
+ * @note When the ring is full the ISR call falls back to the direct path and the
+ *       overflow is counted. Can be overridden via -DHARDRT_ISR_DEFER_DEPTH.
+ */
+#ifndef HARDRT_ISR_DEFER_DEPTH
+#define HARDRT_ISR_DEFER_DEPTH 16u
+#endif
+
+/** @brief Post ring counters (since hrt_init()). */
+typedef struct {
+    uint32_t posted;     /**< Commands accepted from ISRs */
+    uint32_t applied;    /**< Commands applied at scheduling points */
+    uint32_t overflows;  /**< Calls that found the ring full and ran directly */
+    uint32_t high_water; /**< Most commands found pending by one drain */
+} hrt_isr_defer_stats_t;
+
+/**
+ * @brief Read the post ring counters.
+ * @param out Destination.
+ * @return 0 on success; -1 if HARDRT_ISR_DEFER is off.
+ */
+int hrt_isr_defer_stats(hrt_isr_defer_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
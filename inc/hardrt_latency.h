@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_LATENCY_H
+#define HARDRT_LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Enable wake-to-run latency histograms.
+ * @note Set through the HARDRT_LATENCY CMake option. When 0 no timestamps are
+ *       taken and hrt_task_latency() returns -1.
+ */
+#ifndef HARDRT_LATENCY
+#define HARDRT_LATENCY 0
+#endif
+
+/**
+ * @brief Number of log2 histogram bins.
+ * @note Bin 0 holds latencies of 0..1 counts, bin k (k >= 1) holds [2^k, 2^(k+1)).
+ *       32 bins cover the whole 32-bit counter range.
+ */
+#define HRT_LATENCY_BINS 32u
+
+/**
+ * @brief Wake-to-run latency summary of one task.
+ * @note A sample is the time from hrt__make_ready() (sleep expiry, semaphore,
+ *       queue or mutex wakeup) to the task being switched in, in
+ *       hrt_port_cycles() units. Resuming after preemption or a yield is not a sample.
+ */
+typedef struct {
+    uint32_t count;                   /**< Samples since the last reset */
+    uint32_t min_cycles;              /**< Smallest sample (0 if count == 0) */
+    uint32_t max_cycles;              /**< Largest sample */
+    uint32_t p99_cycles;              /**< 99th percentile, bin upper bound clamped to max */
+    uint64_t sum_cycles;              /**< Sum of samples, for the mean */
+    uint32_t bins[HRT_LATENCY_BINS];  /**< Log2 histogram */
+} hrt_latency_t;
+
+/**
+ * @brief Read the latency histogram of a task.
+ * @param id Task id.
+ * @param out Destination.
+ * @return 0 on success; -1 if the id is not in use or HARDRT_LATENCY is off.
+ */
+int hrt_task_latency(int id, hrt_latency_t *out);
+
+/**
+ * @brief Clear the latency histogram of a task, or of all tasks if id < 0.
+ */
+void hrt_task_latency_reset(int id);
+
+/**
+ * @brief Percentile estimate from a histogram.
+ * @param h Histogram read with hrt_task_latency().
+ * @param permille Percentile in 1/1000 (990 = p99).
+ * @return Upper bound of the bin holding the percentile, clamped to max_cycles.
+ */
+uint32_t hrt_latency_percentile(const hrt_latency_t *h, uint32_t permille);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
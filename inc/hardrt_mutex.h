@@ -7,25 +7,63 @@ extern "C" {
 
 #include <stdint.h>
 #include "hardrt.h"
+#include "hardrt_objstats.h"
 
 #define HRT_MUTEX_NO_OWNER (-1)
 
+/* hrt_mutex_t::locked bits. Uncontended lock and unlock flip HRT_MUTEX_HELD with a
+   compare-and-swap outside the kernel CS (unless HARDRT_OBJ_STATS is on); a set
+   HRT_MUTEX_WAITERS sends unlock to the CS path that serves the waiters. A barging
+   mutex can be free with only HRT_MUTEX_WAITERS set. */
+#define HRT_MUTEX_HELD    0x01u
+#define HRT_MUTEX_WAITERS 0x02u
+
+  /** @brief What unlock does when tasks are waiting. */
+  typedef enum {
+    HRT_MUTEX_HANDOFF = 0, /**< Ownership moves to the FIFO head waiter, then the caller yields (fair) */
+    HRT_MUTEX_BARGING = 1  /**< The mutex is freed and the head waiter woken; whoever runs first takes it */
+  } hrt_mutex_mode_t;
+
   typedef struct {
-    volatile uint8_t locked;        /* 0 = unlocked, 1 = locked */
-    int16_t owner;                  /* task id of owner (uint8), HRT_MUTEX_NO_OWNER if unlocked */
+    volatile uint8_t locked;        /* HRT_MUTEX_HELD | HRT_MUTEX_WAITERS, 0 = free, nobody queued */
+    volatile int16_t owner;         /* task id of owner (uint8), HRT_MUTEX_NO_OWNER if unlocked */
 
     uint8_t q[HARDRT_MAX_TASKS];    /* FIFO waiters */
     uint8_t head;
     uint8_t tail;
     uint8_t count_wait;
+    uint8_t mode;                   /* hrt_mutex_mode_t */
+#if HARDRT_OBJ_STATS == 1
+    hrt__obj_rec_t st;              /* contention and hold-time counters, see hrt_obj_stats() */
+#endif
   } hrt_mutex_t;
 
-  static inline void hrt_mutex_init(hrt_mutex_t *m) {
+  /**
+   * @brief Initialize a mutex with the given release mode.
+   *
+   * HRT_MUTEX_BARGING trades FIFO fairness for throughput: an unlock that finds
+   * waiters does not force a context switch, so a task that releases and re-locks
+   * in a loop keeps running instead of forming a convoy with the waiters. A woken
+   * waiter that loses the race re-queues at the head. A waiter that outranks the
+   * releasing task still preempts it.
+   *
+   * @param m Pointer to the mutex.
+   * @param mode HRT_MUTEX_HANDOFF (what hrt_mutex_init() uses) or HRT_MUTEX_BARGING.
+   */
+  static inline void hrt_mutex_init_mode(hrt_mutex_t *m, const hrt_mutex_mode_t mode) {
     m->locked = 0u;
     m->owner = HRT_MUTEX_NO_OWNER;
     m->head = 0u;
     m->tail = 0u;
     m->count_wait = 0u;
+    m->mode = (uint8_t)mode;
+#if HARDRT_OBJ_STATS == 1
+    hrt_obj_stats_reset(m, HRT_OBJ_MUTEX);
+#endif
+  }
+
+  static inline void hrt_mutex_init(hrt_mutex_t *m) {
+    hrt_mutex_init_mode(m, HRT_MUTEX_HANDOFF);
   }
 
   /**
@@ -0,0 +1,137 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_OBJSTATS_H
+#define HARDRT_OBJSTATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Enable contention and occupancy counters on semaphores, mutexes and queues.
+ * @note Set through the HARDRT_OBJ_STATS CMake option. When 0 the objects carry
+ *       no counters and the functions below return -1.
+ */
+#ifndef HARDRT_OBJ_STATS
+#define HARDRT_OBJ_STATS 0
+#endif
+
+/**
+ * @brief Queue items timestamped for enqueue-to-dequeue latency (power of two, <= 32).
+ * @note Only items sent while fewer than this many are queued carry a timestamp,
+ *       so deeper backlogs are sampled from their head. Can be overridden via
+ *       -DHARDRT_OBJ_STATS_QUEUE_TS.
+ */
+#ifndef HARDRT_OBJ_STATS_QUEUE_TS
+#define HARDRT_OBJ_STATS_QUEUE_TS 8u
+#endif
+
+/**
+ * @brief Slots in the object registry (hrt_obj_register()).
+ * @note Can be overridden via -DHARDRT_OBJ_REGISTRY.
+ */
+#ifndef HARDRT_OBJ_REGISTRY
+#define HARDRT_OBJ_REGISTRY 16u
+#endif
+
+/** @brief Kind of an instrumented object. */
+typedef enum {
+    HRT_OBJ_SEM = 1,
+    HRT_OBJ_MUTEX,
+    HRT_OBJ_QUEUE
+} hrt_obj_kind_t;
+
+/**
+ * @brief Counters of one object since its init (or hrt_obj_stats_reset()).
+ * @note Times are in hrt_port_cycles() units; see cycles_hz. An operation is a
+ *       semaphore take, a mutex lock or a queue send or receive; gives and
+ *       unlocks are not counted.
+ */
+typedef struct {
+    uint32_t ops;                /**< Successful operations, blocking and non-blocking */
+    uint32_t contended;          /**< Of those, blocking calls that had to wait (ops - contended ran straight through) */
+    uint32_t failed;             /**< Non-blocking attempts that found the object unavailable */
+    uint32_t max_blocked_cycles; /**< Longest wait of a contended call */
+    uint64_t blocked_cycles;     /**< Total wait of contended calls */
+
+    /* Mutex only */
+    uint64_t hold_cycles;        /**< Total time held; ops is the number of holds */
+    uint32_t max_hold_cycles;    /**< Longest hold */
+
+    /* Queue only */
+    uint32_t high_water;         /**< Deepest the queue has been */
+    uint32_t full_stalls;        /**< Sends that found the queue full (waited or failed) */
+    uint32_t empty_stalls;       /**< Receives that found the queue empty (waited or failed) */
+    uint32_t latency_samples;    /**< Items timed from send to receive */
+    uint32_t max_latency_cycles;
+    uint64_t latency_cycles;     /**< Sum of timed items, for the mean */
+
+    uint32_t cycles_hz;          /**< Port counter frequency (0 if the port has none) */
+} hrt_obj_stats_t;
+
+/**
+ * @brief Registry entry, see hrt_obj_enum().
+ */
+typedef struct {
+    const void *obj;
+    const char *name;
+    hrt_obj_kind_t kind;
+    hrt_obj_stats_t stats;
+} hrt_obj_info_t;
+
+#if HARDRT_OBJ_STATS == 1
+/** @brief Per-object bookkeeping embedded in the objects; not part of the API. */
+typedef struct {
+    hrt_obj_stats_t s;
+    uint32_t mark;  /**< Mutex: when the current hold started */
+} hrt__obj_rec_t;
+
+/** @brief Queue send timestamps, indexed by item sequence number. */
+typedef struct {
+    uint32_t ts[HARDRT_OBJ_STATS_QUEUE_TS];
+    uint32_t valid; /**< Bit per ts[] slot */
+    uint32_t seq_in, seq_out;
+} hrt__obj_qts_t;
+#endif
+
+/**
+ * @brief Read the counters of a semaphore, mutex or queue.
+ * @param obj hrt_sem_t, hrt_mutex_t or hrt_queue_t, matching kind.
+ * @param kind Kind of obj.
+ * @param out Destination.
+ * @return 0 on success; -1 on bad arguments or if HARDRT_OBJ_STATS is off.
+ */
+int hrt_obj_stats(const void *obj, hrt_obj_kind_t kind, hrt_obj_stats_t *out);
+
+/**
+ * @brief Zero the counters of an object (init does this too).
+ * @return 0 on success; -1 on bad arguments or if HARDRT_OBJ_STATS is off.
+ */
+int hrt_obj_stats_reset(void *obj, hrt_obj_kind_t kind);
+
+/**
+ * @brief Add an object to the registry so hrt_obj_enum() reports it.
+ * @param name Label kept by pointer (not copied); may be NULL.
+ * @return 0 on success (also if already registered, which updates the name);
+ *         -1 if the registry is full, on bad arguments or if HARDRT_OBJ_STATS is off.
+ * @note Unregister objects that go out of scope.
+ */
+int hrt_obj_register(const void *obj, hrt_obj_kind_t kind, const char *name);
+
+/**
+ * @brief Remove an object from the registry. Unknown objects are ignored.
+ */
+void hrt_obj_unregister(const void *obj);
+
+/**
+ * @brief Read registry entry `index` (0..n-1, in registration order) with its counters.
+ * @return 0 on success; -1 past the last entry or if HARDRT_OBJ_STATS is off.
+ */
+int hrt_obj_enum(int index, hrt_obj_info_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,8 +16,151 @@ extern "C" {
     int  hrt__get_current(void);
     int  hrt__pick_next_ready(void);
     uintptr_t hrt__schedule(uintptr_t old_sp);
+    int  hrt__next_wake_tick(uint32_t *out);  // earliest sleeper deadline; -1 if none
+    void hrt__skip_ticks(uint32_t n);         // advance tick without wake processing
 
 
+    /* Statistics hooks: no-ops unless HARDRT_STATS == 1 */
+#if HARDRT_STATS == 1
+    void hrt__stats_switch(int next);  // account time up to now, `next` runs from here (HRT_IDLE_ID = idle)
+    void hrt__stats_yield(void);       // mark the coming switch-out as voluntary
+    void hrt__stats_tick(void);        // clock sampling and load window, from the tick handler
+    void hrt__stats_reset(void);
+#define HRT_STATS_SWITCH(next) hrt__stats_switch(next)
+#define HRT_STATS_YIELD()      hrt__stats_yield()
+#define HRT_STATS_TICK()       hrt__stats_tick()
+#define HRT_STATS_RESET()      hrt__stats_reset()
+#else
+#define HRT_STATS_SWITCH(next) ((void)0)
+#define HRT_STATS_YIELD()      ((void)0)
+#define HRT_STATS_TICK()       ((void)0)
+#define HRT_STATS_RESET()      ((void)0)
+#endif
+
+    /* Trace points: compiled out unless HARDRT_TRACE == 1 */
+#if HARDRT_TRACE == 1
+    void hrt__trace(uint8_t ev, int task, uint16_t arg);
+    void hrt__trace_switch(int next);  // SWITCH_OUT for the previous task, SWITCH_IN for `next`
+    void hrt__trace_reset(void);
+#define HRT_TRACE(ev, arg)            hrt__trace((uint8_t)(ev), hrt__get_current(), (uint16_t)(arg))
+#define HRT_TRACE_TASK(ev, task, arg) hrt__trace((uint8_t)(ev), (task), (uint16_t)(arg))
+#define HRT_TRACE_SWITCH(next)        hrt__trace_switch(next)
+#define HRT_TRACE_RESET()             hrt__trace_reset()
+#else
+#define HRT_TRACE(ev, arg)            ((void)0)
+#define HRT_TRACE_TASK(ev, task, arg) ((void)0)
+#define HRT_TRACE_SWITCH(next)        ((void)0)
+#define HRT_TRACE_RESET()             ((void)0)
+#endif
+#define HRT_TRACE_OBJ(p) ((uint16_t)((uintptr_t)(p) >> 2))
+
+    /* Wake-to-run latency: compiled out unless HARDRT_LATENCY == 1 */
+#if HARDRT_LATENCY == 1
+    void hrt__lat_ready(int id);      // task made ready: start its latency clock
+    void hrt__lat_switch(int next);   // task switched in: close the sample if one is open
+    void hrt__lat_reset(void);
+#define HRT_LAT_READY(id)    hrt__lat_ready(id)
+#define HRT_LAT_SWITCH(next) hrt__lat_switch(next)
+#define HRT_LAT_RESET()      hrt__lat_reset()
+#else
+#define HRT_LAT_READY(id)    ((void)0)
+#define HRT_LAT_SWITCH(next) ((void)0)
+#define HRT_LAT_RESET()      ((void)0)
+#endif
+
+    /* Interrupt-masked time: compiled out unless HARDRT_IRQOFF == 1. Ports call these right
+       after masking and right before unmasking, outermost level only. */
+#if HARDRT_IRQOFF == 1
+    void hrt__irqoff_begin(int src, uintptr_t site);  // hrt_irqoff_src_t; site = caller's return address or 0
+    void hrt__irqoff_end(int src);
+#define HRT_IRQOFF_BEGIN(src, site) hrt__irqoff_begin((src), (uintptr_t)(site))
+#define HRT_IRQOFF_END(src)         hrt__irqoff_end(src)
+#define HRT_IRQOFF_RESET()          hrt_irqoff_reset()
+#else
+#define HRT_IRQOFF_BEGIN(src, site) ((void)0)
+#define HRT_IRQOFF_END(src)         ((void)0)
+#define HRT_IRQOFF_RESET()          ((void)0)
+#endif
+
+    /* Object contention counters: compiled out unless HARDRT_OBJ_STATS == 1. Callers hold the CS. */
+#if HARDRT_OBJ_STATS == 1
+    void hrt__obj_op(hrt__obj_rec_t *r);                   // operation completed
+    void hrt__obj_failed(hrt__obj_rec_t *r);               // non-blocking attempt found the object unavailable
+    void hrt__obj_waited(hrt__obj_rec_t *r, uint32_t cycles); // blocking call completed after waiting `cycles`
+    void hrt__obj_stall(hrt__obj_rec_t *r, int full);      // queue found full (send) or empty (receive)
+    void hrt__obj_hold_begin(hrt__obj_rec_t *r);
+    void hrt__obj_hold_end(hrt__obj_rec_t *r);
+    void hrt__obj_put(hrt__obj_rec_t *r, hrt__obj_qts_t *ts, uint16_t depth); // queue item added, `depth` after
+    void hrt__obj_get(hrt__obj_rec_t *r, hrt__obj_qts_t *ts);                 // queue item removed (FIFO)
+#define HRT_OBJ_CLOCK()            hrt_port_cycles()
+#define HRT_OBJ_OP(o)              hrt__obj_op(&(o)->st)
+#define HRT_OBJ_FAILED(o)          hrt__obj_failed(&(o)->st)
+#define HRT_OBJ_WAITED(o, cycles)  hrt__obj_waited(&(o)->st, (cycles))
+#define HRT_OBJ_STALL(o, full)     hrt__obj_stall(&(o)->st, (full))
+#define HRT_OBJ_HOLD_BEGIN(o)      hrt__obj_hold_begin(&(o)->st)
+#define HRT_OBJ_HOLD_END(o)        hrt__obj_hold_end(&(o)->st)
+#define HRT_OBJ_PUT(q)             hrt__obj_put(&(q)->st, &(q)->st_ts, (q)->count)
+#define HRT_OBJ_GET(q)             hrt__obj_get(&(q)->st, &(q)->st_ts)
+#else
+#define HRT_OBJ_CLOCK()            0u
+#define HRT_OBJ_OP(o)              ((void)0)
+#define HRT_OBJ_FAILED(o)          ((void)0)
+#define HRT_OBJ_WAITED(o, cycles)  ((void)(cycles))
+#define HRT_OBJ_STALL(o, full)     ((void)(full))
+#define HRT_OBJ_HOLD_BEGIN(o)      ((void)0)
+#define HRT_OBJ_HOLD_END(o)        ((void)0)
+#define HRT_OBJ_PUT(q)             ((void)0)
+#define HRT_OBJ_GET(q)             ((void)0)
+#endif
+
+    /* ISR brackets (hrt_isr_enter/exit): nesting depth and the wake-ups noted inside */
+    extern volatile uint8_t hrt__isr_nesting;
+    void hrt__isr_note_ready(uint8_t prio); // task of `prio` made ready inside a bracket; caller holds the CS
+    void hrt__isr_pend(void);               // *_from_isr() woke a task: pend now, or leave it to hrt_isr_exit()
+
+    /* Queue/semaphore sets: a member became ready (item in the ring, token stored). Wakes
+       the first task waiting on `sel` (NULL: not a member); caller holds the CS. Returns
+       the task made ready, or -1. */
+    int hrt__select_notify(struct hrt_select *sel);
+
+    /* Deferred ISR posts: compiled out unless HARDRT_ISR_DEFER == 1. Ports call HRT_ISR_DRAIN()
+       at the switch point from a context that ISRs can preempt, before picking the next task. */
+#if HARDRT_ISR_DEFER == 1
+    typedef enum {
+        HRT__POST_SEM_GIVE = 1, // hrt_sem_give() on behalf of an ISR
+        HRT__POST_QUEUE_RX,     // wake one receiver of a queue an ISR sent to
+        HRT__POST_QUEUE_TX      // wake one sender of a queue an ISR received from
+    } hrt__post_op_t;
+    int  hrt__isr_post(uint8_t op, void *obj); // lock-free; 0 posted (switch pended, or left to hrt_isr_exit()), -1 ring full
+    void hrt__isr_drain(void);
+    void hrt__isr_reset(void);
+    void hrt__sem_post_apply(hrt_sem_t *s);
+    void hrt__queue_post_apply(hrt_queue_t *q, int rx);
+#define HRT_ISR_DRAIN() hrt__isr_drain()
+#define HRT_ISR_RESET() hrt__isr_reset()
+#else
+#define HRT_ISR_DRAIN() ((void)0)
+#define HRT_ISR_RESET() ((void)0)
+#endif
+
+    /* All per-switch instrumentation; every switch site (ports and hrt__schedule) calls this
+       right before `next` runs, with HRT_IDLE_ID when the CPU goes idle */
+#define HRT_SWITCH_HOOK(next) do { HRT_STATS_SWITCH(next); HRT_TRACE_SWITCH(next); HRT_LAT_SWITCH(next); } while (0)
+
+    /* Stack painting: compiled out unless HARDRT_STACK_CHECK == 1 */
+#if HARDRT_STACK_CHECK == 1
+    void hrt__stack_paint(uint32_t *base, size_t words);
+    void hrt__stack_reset(void);
+    void hrt__stack_idle_check(void);  // periodic low-margin scan, from the idle path only
+#define HRT_STACK_PAINT_WORDS(base, words) hrt__stack_paint((base), (words))
+#define HRT_STACK_RESET()                  hrt__stack_reset()
+#define HRT_STACK_IDLE_CHECK()             hrt__stack_idle_check()
+#else
+#define HRT_STACK_PAINT_WORDS(base, words) ((void)0)
+#define HRT_STACK_RESET()                  ((void)0)
+#define HRT_STACK_IDLE_CHECK()             ((void)0)
+#endif
+
     /**
      * @brief function to identify the stack pointer validity.
      *
@@ -0,0 +1,261 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_POSIX_H
+#define HARDRT_POSIX_H
+
+/**
+ * @brief POSIX port extensions (host simulation only).
+ * @note Everything declared here is implemented by the POSIX port only.
+ */
+
+#include <stdint.h>
+
+#include "hardrt_shm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of simulated interrupt lines (max 32).
+ * @note Can be overridden at compile time via -DHARDRT_POSIX_IRQ_LINES.
+ */
+#ifndef HARDRT_POSIX_IRQ_LINES
+#define HARDRT_POSIX_IRQ_LINES 16
+#endif
+
+/**
+ * @brief Number of simulated priority levels; 0 is the most urgent.
+ * @note Mirrors a Cortex-M NVIC with 4 implemented priority bits.
+ */
+#define HRT_POSIX_IRQ_PRIO_LEVELS 16u
+
+/**
+ * @brief Simulated priority of the SIGALRM system tick (SysTick equivalent).
+ */
+#ifndef HARDRT_POSIX_TICK_IRQ_PRIO
+#define HARDRT_POSIX_TICK_IRQ_PRIO 14u
+#endif
+
+/**
+ * @brief Simulated BASEPRI threshold applied by hrt_port_crit_enter().
+ * @note Lines with priority >= this value are held off inside kernel critical
+ *       sections; only those lines may call *_from_isr() kernel APIs.
+ *       Same macro and default as the Cortex-M port.
+ */
+#ifndef HARDRT_MAX_SYSCALL_IRQ_PRIO
+#define HARDRT_MAX_SYSCALL_IRQ_PRIO 5u
+#endif
+
+/**
+ * @brief Simulated interrupt handler.
+ * @param line Line number that fired.
+ * @param arg Opaque pointer registered with hrt_posix_irq_attach().
+ */
+typedef void (*hrt_posix_irq_fn)(int line, void *arg);
+
+/**
+ * @brief Attach a handler to a simulated interrupt line and enable it.
+ * @param line Line number (0..HARDRT_POSIX_IRQ_LINES-1).
+ * @param prio Priority (0..HRT_POSIX_IRQ_PRIO_LEVELS-1, 0 is most urgent).
+ * @param fn Handler; NULL detaches the line.
+ * @param arg Opaque pointer forwarded to the handler.
+ * @return 0 on success, -1 on invalid arguments.
+ * @note Call from the kernel thread after hrt_init().
+ */
+int hrt_posix_irq_attach(int line, uint8_t prio, hrt_posix_irq_fn fn, void *arg);
+
+/**
+ * @brief Enable or disable delivery of a line; a pending raise is kept while disabled.
+ * @return 0 on success, -1 on invalid line.
+ */
+int hrt_posix_irq_enable(int line, int enable);
+
+/**
+ * @brief Raise (pend) a simulated interrupt line.
+ * @param line Line number.
+ * @return 0 on success, -1 on invalid line.
+ * @note Safe from any host thread, timer callback, task or handler. Raising an
+ *       already pending line coalesces like a hardware pending bit; the
+ *       timestamp of the first raise is kept.
+ */
+int hrt_posix_irq_raise(int line);
+
+/**
+ * @brief Monotonic timestamp (ns) at which the line was last raised.
+ * @note Inside the handler this is the raise that is being serviced.
+ */
+uint64_t hrt_posix_irq_raised_ns(int line);
+
+/**
+ * @brief Priority of the handler currently executing, or -1 in thread mode.
+ */
+int hrt_posix_irq_active_prio(void);
+
+/**
+ * @brief Block the tick and IRQ signals in the calling host thread.
+ * @note Call first thing in every host thread (e.g. a device model that raises
+ *       lines) so SIGALRM and line handlers are only ever serviced on the kernel thread.
+ */
+void hrt_posix_host_thread_init(void);
+
+/**
+ * @brief Monotonic host clock in nanoseconds (CLOCK_MONOTONIC).
+ */
+uint64_t hrt_posix_now_ns(void);
+
+/**
+ * @brief Write the kernel trace ring to a binary file (hrt_trace_hdr_t + records).
+ * @param path Output file path.
+ * @return Number of records written, or -1 if HARDRT_TRACE is off or the file cannot be written.
+ * @note Convert with the host tool: `hrt_trace2json dump.bin > trace.json`.
+ */
+int hrt_posix_trace_dump(const char *path);
+
+/**
+ * @brief Events counted per task when built with HARDRT_POSIX_PERF (Linux perf_event).
+ */
+typedef enum {
+    HRT_POSIX_PERF_INSTRUCTIONS = 0,
+    HRT_POSIX_PERF_CYCLES,
+    HRT_POSIX_PERF_CACHE_MISSES,
+    HRT_POSIX_PERF_BRANCH_MISSES,
+    HRT_POSIX_PERF_TASK_CLOCK,     /**< Software event: ns on CPU; works without a hardware PMU */
+    HRT_POSIX_PERF_EVENTS
+} hrt_posix_perf_event_t;
+
+/**
+ * @brief Per-task counter totals (user space only).
+ */
+typedef struct {
+    uint64_t count[HRT_POSIX_PERF_EVENTS]; /**< Indexed by hrt_posix_perf_event_t */
+    uint32_t runs;                         /**< Times the task was switched in */
+} hrt_posix_perf_t;
+
+/**
+ * @brief Events the host could open, as a mask of (1u << hrt_posix_perf_event_t).
+ * @return 0 when HARDRT_POSIX_PERF is off or perf_event_open() is refused.
+ */
+uint32_t hrt_posix_perf_available(void);
+
+/**
+ * @brief Copy the counters charged to a task since hrt_init() or the last reset.
+ * @param id Task id, or HRT_IDLE_ID for the scheduler and idle path.
+ * @return 0 on success, -1 on invalid arguments or when HARDRT_POSIX_PERF is off.
+ * @note Events missing from hrt_posix_perf_available() stay at zero.
+ */
+int hrt_posix_perf_task(int id, hrt_posix_perf_t *out);
+
+/**
+ * @brief Zero all per-task counters. hrt_init() does this as well.
+ */
+void hrt_posix_perf_reset(void);
+
+/**
+ * @brief Write the per-task counter table as text ("-" for stdout).
+ * @return 0 on success, -1 if HARDRT_POSIX_PERF is off or the file cannot be written.
+ * @note The same table goes to stderr at process exit once counters were opened.
+ */
+int hrt_posix_perf_dump(const char *path);
+
+/**
+ * @brief Deepest backtrace kept per profiler sample (frames).
+ * @note Can be overridden at compile time via -DHARDRT_POSIX_PROF_DEPTH.
+ */
+#ifndef HARDRT_POSIX_PROF_DEPTH
+#define HARDRT_POSIX_PROF_DEPTH 24
+#endif
+
+/**
+ * @brief Distinct (task, backtrace) entries the profiler can hold; further new stacks are dropped.
+ * @note Can be overridden at compile time via -DHARDRT_POSIX_PROF_STACKS.
+ */
+#ifndef HARDRT_POSIX_PROF_STACKS
+#define HARDRT_POSIX_PROF_STACKS 2048
+#endif
+
+/**
+ * @brief Default sampling rate in Hz of kernel-thread CPU time (prime, so it does not beat with the tick).
+ * @note Can be overridden at compile time via -DHARDRT_POSIX_PROF_HZ.
+ */
+#ifndef HARDRT_POSIX_PROF_HZ
+#define HARDRT_POSIX_PROF_HZ 997
+#endif
+
+/**
+ * @brief Sampling profiler totals since the last reset.
+ */
+typedef struct {
+    uint32_t samples; /**< Samples recorded, each weighted by its timer overruns */
+    uint32_t dropped; /**< Samples lost because the stack table was full */
+    uint32_t stacks;  /**< Distinct (task, backtrace) entries held */
+} hrt_posix_prof_stats_t;
+
+/**
+ * @brief Start sampling the kernel thread with SIGPROF (HARDRT_POSIX_PROF builds).
+ * @param hz Samples per second of kernel-thread CPU time; 0 selects HARDRT_POSIX_PROF_HZ.
+ * @return 0 on success, -1 before hrt_init(), if the timer cannot be created, or when HARDRT_POSIX_PROF is off.
+ * @note Each sample records the running task and its backtrace. Setting HARDRT_PROF=<file> in the
+ *       environment starts the profiler in hrt_init() and writes the folded stacks there at exit.
+ */
+int hrt_posix_prof_start(uint32_t hz);
+
+/**
+ * @brief Stop sampling; recorded stacks are kept until reset.
+ */
+void hrt_posix_prof_stop(void);
+
+/**
+ * @brief Drop all recorded samples.
+ */
+void hrt_posix_prof_reset(void);
+
+/**
+ * @brief Copy the profiler totals.
+ * @return 0 on success, -1 on NULL or when HARDRT_POSIX_PROF is off.
+ */
+int hrt_posix_prof_stats(hrt_posix_prof_stats_t *out);
+
+/**
+ * @brief Samples charged to one context.
+ * @param id Task id, HRT_IDLE_ID for the scheduler and idle path, or -1 for host code outside hrt_sim_run_for().
+ * @return Weighted sample count; 0 for invalid ids or when HARDRT_POSIX_PROF is off.
+ */
+uint32_t hrt_posix_prof_task_samples(int id);
+
+/**
+ * @brief Write the samples as folded stacks, one "ctx;outer;...;leaf count" line per stack ("-" for stdout).
+ * @return 0 on success, -1 if HARDRT_POSIX_PROF is off or the file cannot be written.
+ * @note ctx is task<N>, idle or host. Frames are resolved with dladdr(): link with -rdynamic (the library
+ *       adds it when the option is on) for names; static functions appear as module+0xoffset.
+ *       The output feeds flamegraph.pl directly; grep one ctx for a per-task flame graph.
+ */
+int hrt_posix_prof_dump(const char *path);
+
+/**
+ * @brief Name of the live telemetry page (HARDRT_POSIX_SHM builds), e.g. "/hardrt.1234".
+ * @return NULL when HARDRT_POSIX_SHM is off or the page could not be created.
+ * @note Created in the first hrt_init() and unlinked at exit. Read it with `hrt-top`.
+ *       Layout: hrt_shm_page_t in hardrt_shm.h.
+ */
+const char *hrt_posix_shm_name(void);
+
+/**
+ * @brief Publish a kernel object's level and waiters in the telemetry page.
+ * @param name Label shown by hrt-top (truncated to HRT_SHM_NAME_LEN - 1).
+ * @param obj hrt_sem_t, hrt_mutex_t or hrt_queue_t matching `kind`; must outlive the kernel run.
+ * @param kind HRT_SHM_OBJ_SEM, HRT_SHM_OBJ_MUTEX or HRT_SHM_OBJ_QUEUE.
+ * @return Slot index, or -1 if the table is full, arguments are invalid or HARDRT_POSIX_SHM is off.
+ * @note hrt_init() clears the list.
+ */
+int hrt_posix_shm_watch(const char *name, const void *obj, hrt_shm_obj_kind_t kind);
+
+/**
+ * @brief Take a full snapshot now instead of waiting for HARDRT_POSIX_SHM_PERIOD_MS.
+ */
+void hrt_posix_shm_update(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -10,6 +10,9 @@ extern "C" {
 #include <stdint.h>
 
 #include "hardrt.h"
+#include "hardrt_port.h"
+#include "hardrt_objstats.h"
+#include "hardrt_trace.h"
 
 /**
  * @brief Fixed-size message queue (ring buffer) for inter-task communication.
@@ -22,11 +25,15 @@ extern "C" {
  *   semaphore feature set.
  */
 
+struct hrt_select;
+
 typedef struct {
     /* Application-provided backing store: capacity * item_size bytes */
     uint8_t *buf;
     size_t   item_size;
     uint16_t capacity;
+    uint16_t mask;       /* capacity - 1 if a power of two, else 0 (wrap by compare) */
+    uint8_t  copy_words; /* item_size / 4 if items move as word assignments, else 0 (memcpy) */
 
     /* Ring state */
     volatile uint16_t head;
@@ -40,8 +47,127 @@ typedef struct {
     /* Sender wait queue (FIFO) */
     uint8_t tx_q[HARDRT_MAX_TASKS];
     uint8_t tx_head, tx_tail, tx_wait;
+
+    /* Set this queue is a member of, or NULL (see hardrt_select.h) */
+    struct hrt_select *sel;
+
+#if HARDRT_OBJ_STATS == 1
+    /* Contention, occupancy and latency counters, see hrt_obj_stats() */
+    hrt__obj_rec_t st;
+    hrt__obj_qts_t st_ts;
+#endif
 } hrt_queue_t;
 
+/** @brief Largest item, in 32-bit words, copied by word assignments instead of memcpy. */
+#define HRT_QUEUE_WORD_COPY_MAX 4u
+
+/* Per-queue copy and wrap parameters, shared by hrt_queue_init() and HRT_QUEUE_INITIALIZER */
+#define HRT__QUEUE_MASK(capacity) \
+    ((uint16_t)((((capacity) & ((capacity) - 1u)) == 0u) ? (capacity) - 1u : 0u))
+#define HRT__QUEUE_WORDS(item_size) \
+    ((uint8_t)((((item_size) % 4u) == 0u && (item_size) / 4u <= HRT_QUEUE_WORD_COPY_MAX) ? (item_size) / 4u : 0u))
+
+/**
+ * @brief Static initializer equivalent to hrt_queue_init() (C only).
+ * @param storage Byte buffer of size (cap * size).
+ * @param cap Number of items (> 0).
+ * @param size Size of each item in bytes (> 0).
+ */
+#define HRT_QUEUE_INITIALIZER(storage, cap, size) \
+    { .buf = (uint8_t *)(storage), .item_size = (size), .capacity = (cap), \
+      .mask = HRT__QUEUE_MASK(cap), .copy_words = HRT__QUEUE_WORDS(size) }
+
+/* Typed fast paths are compiled out when the per-object counters or the tracer
+   must see every transfer; the calls then go straight to the core. */
+#if HARDRT_OBJ_STATS == 0 && HARDRT_TRACE == 0
+#define HRT__QUEUE_TYPED_FAST 1
+#else
+#define HRT__QUEUE_TYPED_FAST 0
+#endif
+
+/**
+ * @brief Define a typed queue of `cap` items of `type` (C only).
+ *
+ * Expands to a statically initialized `hrt_queue_t name` with its storage and
+ * inline, type-checked calls:
+ * `name_send()`, `name_try_send()`, `name_try_send_from_isr()`, `name_recv()`,
+ * `name_try_recv()`, `name_try_recv_from_isr()`, `name_count()` and `name_reset()`
+ * (re-initializes, e.g. after hrt_init()).
+ *
+ * `cap` must be a power of two. While no task waits on the other side (and the
+ * queue is in no set), a transfer is done inline under the critical section: a
+ * `type` assignment into the typed storage and a wrap with the constant `cap - 1`.
+ * Anything involving a waiter, a set or a full/empty blocking call goes to the
+ * generic core, so `name` keeps its waiter queues and handoff logic unchanged
+ * and stays usable with the generic API.
+ */
+#define HRT_QUEUE_DEFINE(name, type, cap) \
+    _Static_assert((cap) > 0 && ((cap) & ((cap) - 1)) == 0, #name ": capacity must be a power of two"); \
+    static type name##_storage[(cap)]; \
+    static hrt_queue_t name = HRT_QUEUE_INITIALIZER(name##_storage, (cap), sizeof(type)); \
+    /* 0 sent, -1 full, 1 left to the core (a receiver waits, set member, fast path off) */ \
+    static inline int name##__put(const type *item) { \
+        int r = 1; \
+        if (!HRT__QUEUE_TYPED_FAST) return r; \
+        hrt_port_crit_enter(); \
+        if (name.rx_wait == 0u && name.sel == NULL) { \
+            r = -1; \
+            if (name.count < (cap)) { \
+                name##_storage[name.tail] = *item; \
+                name.tail = (uint16_t) ((name.tail + 1u) & ((cap) - 1u)); \
+                name.count++; \
+                r = 0; \
+            } \
+        } \
+        hrt_port_crit_exit(); \
+        return r; \
+    } \
+    /* 0 received, -1 empty, 1 left to the core (a sender waits, fast path off) */ \
+    static inline int name##__get(type *out) { \
+        int r = 1; \
+        if (!HRT__QUEUE_TYPED_FAST) return r; \
+        hrt_port_crit_enter(); \
+        if (name.tx_wait == 0u) { \
+            r = -1; \
+            if (name.count > 0u) { \
+                *out = name##_storage[name.head]; \
+                name.head = (uint16_t) ((name.head + 1u) & ((cap) - 1u)); \
+                name.count--; \
+                r = 0; \
+            } \
+        } \
+        hrt_port_crit_exit(); \
+        return r; \
+    } \
+    static inline int name##_send(const type *item) { \
+        return name##__put(item) == 0 ? 0 : hrt_queue_send(&name, item); \
+    } \
+    static inline int name##_try_send(const type *item) { \
+        const int r = name##__put(item); \
+        return r <= 0 ? r : hrt_queue_try_send(&name, item); \
+    } \
+    static inline int name##_try_send_from_isr(const type *item, int *need_switch) { \
+        const int r = name##__put(item); \
+        if (r > 0) return hrt_queue_try_send_from_isr(&name, item, need_switch); \
+        if (need_switch) *need_switch = 0; \
+        return r; \
+    } \
+    static inline int name##_recv(type *out) { \
+        return name##__get(out) == 0 ? 0 : hrt_queue_recv(&name, out); \
+    } \
+    static inline int name##_try_recv(type *out) { \
+        const int r = name##__get(out); \
+        return r <= 0 ? r : hrt_queue_try_recv(&name, out); \
+    } \
+    static inline int name##_try_recv_from_isr(type *out, int *need_switch) { \
+        const int r = name##__get(out); \
+        if (r > 0) return hrt_queue_try_recv_from_isr(&name, out, need_switch); \
+        if (need_switch) *need_switch = 0; \
+        return r; \
+    } \
+    static inline uint16_t name##_count(void) { return hrt_queue_count(&name); } \
+    static inline void name##_reset(void) { hrt_queue_init(&name, name##_storage, (cap), sizeof(type)); }
+
 /**
  * @brief Initialize a queue.
  *
@@ -72,6 +198,7 @@ int hrt_queue_try_send(hrt_queue_t *q, const void *item);
  * @param item Pointer to item to copy.
  * @param need_switch Optional out: set to 1 if a waiter was woken and a switch is advised.
  * @return 0 on success, -1 if full.
+ * @note Inside hrt_isr_enter()/hrt_isr_exit() the switch is left to hrt_isr_exit().
  */
 int hrt_queue_try_send_from_isr(hrt_queue_t *q, const void *item, int *need_switch);
 
@@ -95,6 +222,7 @@ int hrt_queue_try_recv(hrt_queue_t *q, void *out);
  * @param out Destination buffer.
  * @param need_switch Optional out: set to 1 if a waiter was woken and a switch is advised.
  * @return 0 on success, -1 if empty.
+ * @note Inside hrt_isr_enter()/hrt_isr_exit() the switch is left to hrt_isr_exit().
  */
 int hrt_queue_try_recv_from_isr(hrt_queue_t *q, void *out, int *need_switch);
 
@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_SELECT_H
+#define HARDRT_SELECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "hardrt.h"
+#include "hardrt_sem.h"
+#include "hardrt_queue.h"
+
+/**
+ * @brief Members one set can hold.
+ * @note Sizes hrt_select_t, so the library and its users must agree on it. Can be
+ *       overridden via -DHARDRT_SELECT_MAX.
+ */
+#ifndef HARDRT_SELECT_MAX
+#define HARDRT_SELECT_MAX 8u
+#endif
+
+/** @brief Kind of a set member. */
+typedef enum {
+    HRT_SELECT_QUEUE = 1, /**< Ready while it holds an item */
+    HRT_SELECT_SEM   = 2  /**< Ready while it stores a token */
+} hrt_select_kind_t;
+
+/**
+ * @brief Set of queues and semaphores one task can wait on together.
+ * @details Each member points back at its set. Whenever an item lands in a member
+ *          queue's ring or a member semaphore stores a token, the first task waiting
+ *          on the set is woken and rescans the members. A task blocked directly on
+ *          the object (hrt_queue_recv(), hrt_sem_take()) is still served first.
+ */
+typedef struct hrt_select {
+    void   *obj[HARDRT_SELECT_MAX];  /**< Members, in the order they were added */
+    uint8_t kind[HARDRT_SELECT_MAX]; /**< hrt_select_kind_t of each member */
+    uint8_t count;                   /**< Members added */
+    uint8_t q[HARDRT_MAX_TASKS];     /**< Wait queue (task ids) */
+    uint8_t head, tail, count_wait;  /**< Queue indices and length */
+} hrt_select_t;
+
+/**
+ * @brief Initialize an empty set.
+ * @param s Set object.
+ */
+void hrt_select_init(hrt_select_t *s);
+
+/**
+ * @brief Add a queue; it is ready while it holds at least one item.
+ * @param s Set.
+ * @param q Initialized queue. A queue belongs to one set at most, and
+ *          hrt_queue_init() detaches it again.
+ * @return Member index (0-based, in the order added), or -1 if the set is full
+ *         or the queue is already in another set.
+ */
+int hrt_select_add_queue(hrt_select_t *s, hrt_queue_t *q);
+
+/**
+ * @brief Add a semaphore; it is ready while it stores a token.
+ * @param s Set.
+ * @param sem Initialized semaphore, same rules as for queues. Gives to a member
+ *            always take the kernel critical section (no lock-free give).
+ * @return Member index, or -1 as for hrt_select_add_queue().
+ */
+int hrt_select_add_sem(hrt_select_t *s, hrt_sem_t *sem);
+
+/**
+ * @brief Block until a member is ready.
+ * @param s Set.
+ * @return Index of the first ready member, scanning in the order added; -1 if the
+ *         set is empty.
+ * @note Nothing is consumed: follow up with hrt_queue_try_recv() or
+ *       hrt_sem_try_take() on that member. If another task got there first the
+ *       try call fails; call hrt_select_wait() again.
+ */
+int hrt_select_wait(hrt_select_t *s);
+
+/**
+ * @brief Non-blocking variant of hrt_select_wait().
+ * @return Index of the first ready member, or -1 if none is ready.
+ */
+int hrt_select_try(hrt_select_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -7,16 +7,30 @@ extern "C" {
 /* SPDX-License-Identifier: Apache-2.0 */
 #include <stdint.h>
 #include "hardrt.h"
+#include "hardrt_objstats.h"
+
+/** @brief Flag in hrt_sem_t::count while tasks are queued (the token bits are 0 then). */
+#define HRT_SEM_WAITERS   0x80000000u
+/** @brief Largest max_count a counting semaphore accepts. */
+#define HRT_SEM_MAX_COUNT 0x7FFFFFFFu
+
+struct hrt_select;
 
 /**
- * @brief Binary semaphore type (count is 0 or 1).
+ * @brief Binary or counting semaphore.
  * @details Waiters are queued FIFO; per-priority round-robin is handled by the core scheduler.
+ *          Uncontended take and give update `count` with a compare-and-swap and skip the
+ *          kernel critical section (unless HARDRT_OBJ_STATS is on).
  */
 typedef struct {
-    volatile uint8_t count;      /**< Current token count (0..max_count). */
-    uint8_t max_count;           /**< Maximum token count (1 => binary semantics). */
+    volatile uint32_t count;     /**< Token count (0..max_count), or HRT_SEM_WAITERS. */
+    uint32_t max_count;          /**< Maximum token count (1 => binary semantics). */
     uint8_t q[HARDRT_MAX_TASKS]; /**< Wait queue (task ids) */
     uint8_t head, tail, count_wait; /**< Queue indices and length */
+    struct hrt_select *sel;      /**< Set this semaphore is a member of, or NULL */
+#if HARDRT_OBJ_STATS == 1
+    hrt__obj_rec_t st;           /**< Contention counters, see hrt_obj_stats() */
+#endif
 } hrt_sem_t;
 
 /**
@@ -28,15 +42,19 @@ static inline void hrt_sem_init(hrt_sem_t *s, const unsigned init) {
     s->max_count = 1u;
     s->count = (init ? 1u : 0u);
     s->head = s->tail = s->count_wait = 0;
+    s->sel = NULL;
+#if HARDRT_OBJ_STATS == 1
+    hrt_obj_stats_reset(s, HRT_OBJ_SEM);
+#endif
 }
 
 /**
  * @brief Initialize counting semaphore.
  * @param s Semaphore object to initialize.
  * @param init Initial token count (clamped to max_count).
- * @param max_count Maximum token count (must be >= 1; 1 preserves binary semantics).
+ * @param max_count Maximum token count (1..HRT_SEM_MAX_COUNT; 1 preserves binary semantics).
  */
-void hrt_sem_init_counting(hrt_sem_t *s, unsigned init, uint8_t max_count);
+void hrt_sem_init_counting(hrt_sem_t *s, unsigned init, uint32_t max_count);
 
 /**
  * @brief Take the semaphore, blocking until available.
@@ -64,6 +82,7 @@ int hrt_sem_give(hrt_sem_t *s);
  * @param s Semaphore to release.
  * @param need_switch Set to 1 if a higher-priority waiter was woken and a switch is needed.
  * @return 0.
+ * @note Inside hrt_isr_enter()/hrt_isr_exit() the switch is left to hrt_isr_exit().
  */
 int hrt_sem_give_from_isr(hrt_sem_t *s, int *need_switch);
 
@@ -0,0 +1,112 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_SHM_H
+#define HARDRT_SHM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Publish a live telemetry page in POSIX shared memory.
+ * @note Set through the HARDRT_POSIX_SHM CMake option (POSIX port only). This
+ *       header only describes the page layout, so host tools such as hrt-top
+ *       can read it without linking the kernel.
+ */
+#ifndef HARDRT_POSIX_SHM
+#define HARDRT_POSIX_SHM 0
+#endif
+
+/**
+ * @brief Minimum interval between full snapshots (task table and watched objects).
+ * @note Per-switch fields are always current. Can be overridden via -DHARDRT_POSIX_SHM_PERIOD_MS.
+ */
+#ifndef HARDRT_POSIX_SHM_PERIOD_MS
+#define HARDRT_POSIX_SHM_PERIOD_MS 50u
+#endif
+
+/** @brief Page magic ("HRTS" little-endian) and layout version. */
+#define HRT_SHM_MAGIC   0x53545248u
+#define HRT_SHM_VERSION 1u
+
+/** @brief Task slots in the page; task ids are 8-bit, `max_tasks` gives the slots in use. */
+#define HRT_SHM_TASKS    256u
+/** @brief Objects that can be watched with hrt_posix_shm_watch(). */
+#define HRT_SHM_OBJS     32u
+#define HRT_SHM_NAME_LEN 16u
+
+/** @brief Task slot state; mirrors hrt task states, plus RUNNING for the current task. */
+typedef enum {
+    HRT_SHM_READY = 0,
+    HRT_SHM_SLEEP,
+    HRT_SHM_BLOCKED,
+    HRT_SHM_UNUSED,
+    HRT_SHM_RUNNING
+} hrt_shm_state_t;
+
+/** @brief Kind of a watched object. */
+typedef enum {
+    HRT_SHM_OBJ_NONE = 0,
+    HRT_SHM_OBJ_SEM,
+    HRT_SHM_OBJ_MUTEX,
+    HRT_SHM_OBJ_QUEUE
+} hrt_shm_obj_kind_t;
+
+/**
+ * @brief One task slot (32 bytes).
+ * @note `run_ns` and `switches_in` are updated on every switch; the other fields by the periodic snapshot.
+ */
+typedef struct {
+    uint64_t run_ns;      /**< Wall time (CLOCK_MONOTONIC) spent running since hrt_init() */
+    uint32_t switches_in; /**< Times the task was switched in */
+    uint32_t wake_tick;   /**< Wake deadline while sleeping */
+    uint32_t stack_words;
+    uint16_t timeslice;   /**< Configured slice in ticks, 0 = cooperative */
+    uint16_t slice_left;
+    uint8_t state;        /**< hrt_shm_state_t */
+    uint8_t prio;
+    uint8_t reserved[2];
+} hrt_shm_task_t;
+
+/**
+ * @brief One watched object (32 bytes), refreshed by the periodic snapshot.
+ */
+typedef struct {
+    char name[HRT_SHM_NAME_LEN]; /**< NUL-terminated, truncated */
+    uint8_t kind;                /**< hrt_shm_obj_kind_t */
+    uint8_t waiters;             /**< Tasks blocked on the object (receivers + senders for a queue) */
+    int16_t owner;               /**< Mutex owner, -1 otherwise */
+    uint32_t level;              /**< Semaphore count, queue depth, 1 if a mutex is held */
+    uint32_t capacity;           /**< Semaphore max count, queue capacity, 1 for a mutex */
+    uint32_t reserved;
+} hrt_shm_obj_t;
+
+/**
+ * @brief The shared page, named "/hardrt.<pid>" unless HARDRT_SHM_NAME is set.
+ * @note Seqlock: the kernel makes `seq` odd, writes, then makes it even again.
+ *       A reader copies the page and retries while `seq` was odd or changed.
+ */
+typedef struct {
+    uint32_t magic;       /**< HRT_SHM_MAGIC */
+    uint16_t version;     /**< HRT_SHM_VERSION */
+    uint16_t page_bytes;  /**< sizeof(hrt_shm_page_t) */
+    volatile uint32_t seq;
+    uint32_t pid;
+    uint32_t max_tasks;   /**< HARDRT_MAX_TASKS of the writer; slot max_tasks-1 is idle */
+    uint32_t tick_hz;
+    uint32_t tick;        /**< Kernel tick at the last snapshot */
+    int32_t current;      /**< Running task, idle slot when idle, -1 outside the scheduler */
+    uint32_t policy;      /**< hrt_policy_t */
+    uint32_t nobjs;
+    uint64_t switches;    /**< Context switches since hrt_init() */
+    uint64_t update_ns;   /**< CLOCK_MONOTONIC time of the last update */
+    hrt_shm_task_t task[HRT_SHM_TASKS];
+    hrt_shm_obj_t obj[HRT_SHM_OBJS];
+} hrt_shm_page_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_STACK_H
+#define HARDRT_STACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Enable stack painting and high-water-mark measurement.
+ * @note Set through the HARDRT_STACK_CHECK CMake option. When 0 stacks are not
+ *       painted and the functions below are inert.
+ */
+#ifndef HARDRT_STACK_CHECK
+#define HARDRT_STACK_CHECK 0
+#endif
+
+/**
+ * @brief Word written over every task stack at creation.
+ */
+#ifndef HARDRT_STACK_PAINT
+#define HARDRT_STACK_PAINT 0xA5A5A5A5u
+#endif
+
+/**
+ * @brief Minimum number of ticks between two idle-time stack scans.
+ */
+#ifndef HARDRT_STACK_CHECK_PERIOD_TICKS
+#define HARDRT_STACK_CHECK_PERIOD_TICKS 100u
+#endif
+
+/**
+ * @brief Low-margin callback.
+ * @param id Task whose stack margin dropped below the threshold.
+ * @param unused_words Words of that stack never written so far.
+ * @note Runs from the idle path; do not block.
+ */
+typedef void (*hrt_stack_hook_fn)(int id, uint32_t unused_words);
+
+/**
+ * @brief Stack high-water mark of a task.
+ * @param id Task id (HRT_IDLE_ID reports the idle stack on ports that have one).
+ * @return Words at the low end of the stack never written since creation;
+ *         -1 if the id has no stack or HARDRT_STACK_CHECK is off.
+ * @note Scans from the stack limit up to the first overwritten word: O(unused).
+ */
+int32_t hrt_task_stack_unused(int id);
+
+/**
+ * @brief Install a hook called from the idle path when a stack margin runs low.
+ * @param fn Callback, or NULL to disable the periodic scan.
+ * @param min_unused_words The hook fires once per task when its margin falls below this.
+ */
+void hrt_stack_set_hook(hrt_stack_hook_fn fn, uint32_t min_unused_words);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_STATS_H
+#define HARDRT_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Enable per-task CPU time and context-switch accounting.
+ * @note Set through the HARDRT_STATS CMake option. When 0 the kernel carries no
+ *       counters and the query functions below return -1.
+ */
+#ifndef HARDRT_STATS
+#define HARDRT_STATS 0
+#endif
+
+/**
+ * @brief Length of the CPU-load window in ticks.
+ * @note Load figures cover the most recently completed window and are refreshed
+ *       once per window from the tick handler.
+ */
+#ifndef HARDRT_STATS_WINDOW_TICKS
+#define HARDRT_STATS_WINDOW_TICKS 1000u
+#endif
+
+/**
+ * @brief Per-task accounting snapshot.
+ * @note Times are in port counter units; see hrt_sys_stats_t::cycles_hz.
+ */
+typedef struct {
+    uint64_t run_cycles;    /**< Cumulative time spent running */
+    uint32_t switches_in;   /**< Times the task was switched in */
+    uint32_t preempted;     /**< Switched out while still READY (involuntary) */
+    uint32_t voluntary;     /**< Switched out after yield, sleep, block or exit */
+    uint16_t load_permille; /**< Share of the last load window spent running (0..1000) */
+} hrt_task_stats_t;
+
+/**
+ * @brief System-wide accounting snapshot.
+ */
+typedef struct {
+    uint64_t run_cycles;       /**< Time attributed to tasks since hrt_init() */
+    uint64_t idle_cycles;      /**< Time spent with no task ready since hrt_init() */
+    uint32_t context_switches; /**< Task switches since hrt_init() */
+    uint32_t cycles_hz;        /**< Port counter frequency (0 if the port has none) */
+    uint16_t load_permille;    /**< Non-idle share of the last load window (0..1000) */
+} hrt_sys_stats_t;
+
+/**
+ * @brief Read the accounting counters of a task.
+ * @param id Task id returned by hrt_create_task().
+ * @param out Destination snapshot.
+ * @return 0 on success; -1 if the id is not in use or HARDRT_STATS is off.
+ */
+int hrt_task_stats(int id, hrt_task_stats_t *out);
+
+/**
+ * @brief Read the system-wide accounting counters.
+ * @param out Destination snapshot.
+ * @return 0 on success; -1 if HARDRT_STATS is off.
+ */
+int hrt_sys_stats(hrt_sys_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
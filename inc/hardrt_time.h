@@ -19,6 +19,39 @@ extern "C" {
  */
 void hrt_tick_from_isr(void);
 
+/**
+ * @brief Run the kernel in virtual time for a number of ticks, then return.
+ *
+ * @details Only meaningful with `tick_src = HRT_TICK_VIRTUAL` on the POSIX port.
+ * Runs every ready task, jumps the tick straight to the next wake deadline
+ * whenever all tasks are idle, and returns once the tick has advanced by
+ * @p ticks and no task is ready. Use it instead of hrt_start() to drive the
+ * kernel in lockstep from a host program or co-simulator.
+ *
+ * @param ticks Number of ticks to advance (0 runs ready tasks without advancing time).
+ * @return Tick count on return.
+ */
+uint32_t hrt_sim_run_for(uint32_t ticks);
+
+/**
+ * @brief Advance virtual time by exactly one tick; equivalent to hrt_sim_run_for(1).
+ * @return Tick count on return.
+ */
+uint32_t hrt_sim_step(void);
+
+/**
+ * @brief Model CPU work by the calling task in virtual time.
+ *
+ * @details Advances the tick by @p ticks while the caller keeps the CPU, running
+ * the tick handler once per tick. Sleepers wake and round-robin slices expire as
+ * they would under a real tick; when that requests a switch, the caller is
+ * preempted to the tail of its priority class and resumes once it is picked again.
+ * No effect outside `HRT_TICK_VIRTUAL` or when called from the host.
+ *
+ * @param ticks Execution time to consume, in ticks.
+ */
+void hrt_sim_consume(uint32_t ticks);
+
 
 // internal tick isr function.
 /**
@@ -0,0 +1,112 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef HARDRT_TRACE_H
+#define HARDRT_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Enable the kernel event tracer.
+ * @note Set through the HARDRT_TRACE CMake option. When 0 no trace points are
+ *       compiled into the kernel and the functions below are inert.
+ */
+#ifndef HARDRT_TRACE
+#define HARDRT_TRACE 0
+#endif
+
+/**
+ * @brief Number of records in the trace ring (power of two).
+ * @note When full the oldest records are overwritten (flight recorder).
+ */
+#ifndef HARDRT_TRACE_EVENTS
+#define HARDRT_TRACE_EVENTS 1024u
+#endif
+
+/**
+ * @brief Trace event kinds.
+ */
+typedef enum {
+    HRT_EV_SWITCH_IN = 0, /**< task starts running (task = incoming) */
+    HRT_EV_SWITCH_OUT,    /**< task stops running (task = outgoing) */
+    HRT_EV_READY,         /**< task made ready (task = woken task) */
+    HRT_EV_BLOCK,         /**< task blocks or sleeps (arg = object, 0 for sleep) */
+    HRT_EV_SEM_GIVE,
+    HRT_EV_SEM_TAKE,
+    HRT_EV_QUEUE_SEND,
+    HRT_EV_QUEUE_RECV,
+    HRT_EV_MUTEX_LOCK,
+    HRT_EV_MUTEX_UNLOCK,
+    HRT_EV_ISR_ENTER,     /**< arg = interrupt line / number */
+    HRT_EV_ISR_EXIT,
+    HRT_EV_TICK,          /**< arg = low 16 bits of the tick count */
+    HRT_EV_USER,          /**< application marker, see hrt_trace_user() */
+    HRT_EV_COUNT
+} hrt_trace_ev_t;
+
+/** @brief Task field value when no task is current (before hrt_start()). */
+#define HRT_TRACE_NO_TASK 0xFFu
+
+/**
+ * @brief One trace record (8 bytes).
+ * @note `ts` is hrt_port_cycles() at the time of the event. For kernel
+ *       objects `arg` holds address bits 2..17 of the object, enough to tell
+ *       objects apart in a decoded trace.
+ */
+typedef struct {
+    uint32_t ts;
+    uint8_t  ev;   /**< hrt_trace_ev_t */
+    uint8_t  task;
+    uint16_t arg;
+} hrt_trace_rec_t;
+
+/** @brief Dump file magic ("HRTT" little-endian). */
+#define HRT_TRACE_MAGIC   0x54545248u
+#define HRT_TRACE_VERSION 1u
+
+/**
+ * @brief Header of a trace dump; followed by `count` hrt_trace_rec_t, oldest first.
+ */
+typedef struct {
+    uint32_t magic;     /**< HRT_TRACE_MAGIC */
+    uint16_t version;   /**< HRT_TRACE_VERSION */
+    uint16_t rec_size;  /**< sizeof(hrt_trace_rec_t) */
+    uint32_t cycles_hz; /**< timestamp rate, see hrt_port_cycles_hz() */
+    uint32_t count;     /**< records that follow */
+    uint32_t lost;      /**< records overwritten before the dump */
+} hrt_trace_hdr_t;
+
+/**
+ * @brief Start or stop recording.
+ * @note Recording starts at hrt_init(). Stopping freezes the ring for a post-mortem read.
+ */
+void hrt_trace_enable(int on);
+
+/**
+ * @brief Discard all recorded events.
+ */
+void hrt_trace_clear(void);
+
+/**
+ * @brief Record an application marker event.
+ * @param arg Free-form 16-bit value shown in the decoded trace.
+ * @note Safe from tasks and ISRs.
+ */
+void hrt_trace_user(uint16_t arg);
+
+/**
+ * @brief Copy the recorded events out, oldest first.
+ * @param hdr Filled with the dump header (may be NULL).
+ * @param dst Destination array (may be NULL to query the count only).
+ * @param max Capacity of `dst` in records; the newest records are kept if it is too small.
+ * @return Number of records written to `dst` (0 if HARDRT_TRACE is off).
+ */
+uint32_t hrt_trace_snapshot(hrt_trace_hdr_t *hdr, hrt_trace_rec_t *dst, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
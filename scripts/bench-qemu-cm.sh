@@ -0,0 +1,96 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build HardRT for Cortex-M3, run the instruction-count benchmark under QEMU
+# mps2-an385 and compare it with bench/qemu_cm/baseline.txt.
+#
+#   scripts/bench-qemu-cm.sh                     # build, run, compare
+#   scripts/bench-qemu-cm.sh --update-baseline   # build, run, rewrite the baseline
+#
+# Exits non-zero when a path grew by more than TOLERANCE percent (default 1;
+# runs are deterministic under -icount, so any growth is a real code change).
+
+HARDRT_DIR="${HARDRT_DIR:-$(pwd)}"
+TC_FILE="${TC_FILE:-$HARDRT_DIR/cmake/toolchains/arm-none-eabi.cmake}"
+QEMU="${QEMU:-qemu-system-arm}"
+TOLERANCE="${TOLERANCE:-1}"
+JOBS="${JOBS:-$(nproc)}"
+MCU_FLAGS="-mcpu=cortex-m3 -mthumb"
+UPDATE=0
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    --update-baseline) UPDATE=1; shift 1;;
+    --tolerance) TOLERANCE="$2"; shift 2;;
+    -h|--help) echo "Usage: $0 [--update-baseline] [--tolerance PCT]"; exit 1;;
+    *) echo "Unknown arg: $1"; exit 1;;
+  esac
+done
+
+BENCH_DIR="$HARDRT_DIR/bench/qemu_cm"
+BASELINE="$BENCH_DIR/baseline.txt"
+BUILD_DIR="$HARDRT_DIR/build-qemu-cm"
+INSTALL_DIR="$BUILD_DIR/install"
+
+# -------- HardRT for Cortex-M3 (enough slots for the bench's 9 tasks) --------
+rm -rf "$BUILD_DIR"
+cmake -S "$HARDRT_DIR" -B "$BUILD_DIR/hardrt" \
+  -DHARDRT_PORT=cortex_m \
+  -DHARDRT_BUILD_EXAMPLES=OFF \
+  -DHARDRT_BUILD_TESTS=OFF \
+  -DHARDRT_CFG_MAX_TASKS=12 \
+  -DCMAKE_BUILD_TYPE=Release \
+  -DCMAKE_INSTALL_PREFIX="$INSTALL_DIR" \
+  -DCMAKE_TOOLCHAIN_FILE="$TC_FILE" \
+  -DMCU_FLAGS="$MCU_FLAGS"
+cmake --build "$BUILD_DIR/hardrt" -j"$JOBS"
+cmake --install "$BUILD_DIR/hardrt"
+
+# -------- Bench image --------
+cmake -S "$BENCH_DIR" -B "$BUILD_DIR/app" \
+  -DCMAKE_BUILD_TYPE=Release \
+  -DCMAKE_PREFIX_PATH="$INSTALL_DIR" \
+  -DCMAKE_TOOLCHAIN_FILE="$TC_FILE" \
+  -DMCU_FLAGS="$MCU_FLAGS"
+cmake --build "$BUILD_DIR/app" -j"$JOBS"
+
+# -------- Run: 1 ns of virtual time per instruction --------
+RESULTS="$BUILD_DIR/results.txt"
+timeout 60 "$QEMU" -M mps2-an385 -nographic -monitor none -serial none \
+  -icount shift=0 \
+  -semihosting-config enable=on,target=native \
+  -kernel "$BUILD_DIR/app/hardrt_qemu_bench.elf" \
+  | sed -n 's/^hrt_qemu_bench: \([a-z_]*\) \([0-9.]*\)$/\1 \2/p' > "$RESULTS"
+
+if [[ ! -s "$RESULTS" ]]; then
+  echo "[ERROR] no results from $QEMU"
+  exit 1
+fi
+cat "$RESULTS"
+
+if [[ "$UPDATE" == 1 ]]; then
+  { grep '^#' "$BASELINE"; cat "$RESULTS"; } > "$BASELINE.new"
+  mv "$BASELINE.new" "$BASELINE"
+  echo "[INFO] baseline updated: $BASELINE"
+  exit 0
+fi
+
+# -------- Compare --------
+# An empty baseline would pass every run without checking anything
+if ! grep -qv '^#' "$BASELINE"; then
+  echo "[ERROR] $BASELINE has no recorded paths; nothing was compared."
+  echo "[ERROR] Record it with: $0 --update-baseline (needs arm-none-eabi-gcc and $QEMU), then commit it."
+  exit 1
+fi
+
+awk -v tol="$TOLERANCE" '
+  FNR == NR { if ($1 !~ /^#/ && NF == 2) base[$1] = $2; next }
+  {
+    if (!($1 in base)) { printf "%-14s %10s  (no baseline)\n", $1, $2; next }
+    limit = base[$1] * (1 + tol / 100)
+    status = ($2 > limit) ? "REGRESSED" : "ok"
+    if ($2 > limit) bad = 1
+    printf "%-14s %10s  baseline %10s  %s\n", $1, $2, base[$1], status
+  }
+  END { exit bad }
+' "$BASELINE" "$RESULTS"
@@ -213,6 +213,12 @@ int hrt_init(const hrt_config_t *cfg) {
     }
 
     hrt_port_start_systick(g_tick_hz);
+    HRT_STATS_RESET();
+    HRT_TRACE_RESET();
+    HRT_STACK_RESET();
+    HRT_LAT_RESET();
+    HRT_IRQOFF_RESET();
+    HRT_ISR_RESET();
     hrt__init_idle_task();
     return 0;
 }
@@ -252,16 +258,21 @@ int hrt_create_task(hrt_task_fn fn, void *arg,
     t->stack_base = stack_words;
     t->stack_words = n_words;
 
+    HRT_STACK_PAINT_WORDS(stack_words, n_words);
     hrt_port_prepare_task_stack(id, hrt__task_trampoline, stack_words, n_words);
 #if HARDRT_DEBUG == 1
     dbg_ct_id = id;
     dbg_ct_sp = (uintptr_t)(t->sp);
     (void)dbg_ct_id; (void)dbg_ct_sp;
 #endif
+    /* Tasks may be created at runtime: publish under the critical section so a
+       tick ISR readying a sleeper cannot interleave with this ready-queue push. */
+    hrt_port_crit_enter();
     t->state = HRT_READY;
     /* timeslice_cfg already holds the effective slice (default applied if attr==NULL) */
     t->slice_left = t->timeslice_cfg;
     rq_push(t->prio, (uint8_t) id);
+    hrt_port_crit_exit();
     return id;
 }
 
@@ -307,6 +318,7 @@ void hrt_sleep(const uint32_t ms){
     const uint32_t ticks = hrt__ms_to_ticks(ms, g_tick_hz);
     t->wake_tick = g_tick + ticks;    // wrap-safe checked in the tick hook
     t->state     = HRT_SLEEP;
+    HRT_TRACE(HRT_EV_BLOCK, 0);
 
     // Request rescheduling; then voluntarily hop to scheduler for immediate handoff.
 
@@ -317,6 +329,16 @@ void hrt_sleep(const uint32_t ms){
     hrt_port_yield_to_scheduler();
 }
 
+/* The yield requeue must not interleave with a tick ISR pushing a woken sleeper.
+ * A port that calls hrt__on_scheduler_entry() masked on every switch (see
+ * HARDRT_PORT_SCHED_ENTRY_MASKED) gets the requeue done there; other ports pay
+ * for a critical section in hrt_yield(). */
+#define YIELD_REQUEUE_DEFERRED (HARDRT_PORT_SCHED_ENTRY_MASKED == 1)
+
+#if YIELD_REQUEUE_DEFERRED
+static int g_yield_requeue = -1; /* task whose yield requeue is pending, or -1 */
+#endif
+
 void hrt_yield(void) {
 #if HARDRT_DEBUG == 1
     if (g_current < 0) {
@@ -332,14 +354,22 @@ void hrt_yield(void) {
         return;
     }
 #endif
+#if YIELD_REQUEUE_DEFERRED
+    (void) t;
+    g_yield_requeue = g_current;
+#else
+    hrt_port_crit_enter();
     if (t->state == HRT_READY) {
         /* On yield, move to tail and refresh quantum (RR semantics). */
         t->slice_left = t->timeslice_cfg;
         rq_push(t->prio, (uint8_t) g_current);
     }
+    hrt_port_crit_exit();
+#endif
 #if HARDRT_DEBUG == 1
     dbg_pend_from_core++;
 #endif
+    HRT_STATS_YIELD();
     hrt__pend_context_switch(); /* request reschedule */
     hrt_port_yield_to_scheduler(); /* hop to scheduler */
 }
@@ -403,6 +433,9 @@ void hrt__make_ready(const int id) {
     /* Reset slice strictly to the task's configured value; 0 means cooperative */
     t->slice_left = t->timeslice_cfg;
     rq_push(t->prio, (uint8_t) id);
+    if (hrt__isr_nesting) hrt__isr_note_ready(t->prio);
+    HRT_TRACE_TASK(HRT_EV_READY, id, 0);
+    HRT_LAT_READY(id);
 
 }
 
@@ -464,6 +497,11 @@ void hrt__set_current(const int id) {
 }
 
 void hrt__inc_tick(void) { g_tick++; }
+void hrt__skip_ticks(const uint32_t n) {
+    g_tick += n;
+    /* No tick ISR runs for skipped ticks: keep the stats clock sampled and the load window moving */
+    HRT_STATS_TICK();
+}
 hrt_policy_t hrt__policy(void) { return g_policy; }
 uint32_t hrt__cfg_core_hz(void) { return g_core_hz; }
 hrt_tick_source_t hrt__cfg_tick_src(void) { return g_tick_src; }
@@ -506,6 +544,16 @@ void hrt__on_scheduler_entry(void) {
         hrt_error(ERR_TCB_NULL);
         return;
     }
+#endif
+#if YIELD_REQUEUE_DEFERRED
+    const int yielded = (g_yield_requeue == g_current);
+    g_yield_requeue = -1;
+    if (yielded && t->state == HRT_READY) {
+        /* On yield, move to tail and refresh quantum (RR semantics). */
+        t->slice_left = t->timeslice_cfg;
+        rq_push(t->prio, (uint8_t) g_current);
+        return;
+    }
 #endif
     if (t->state != HRT_READY) return;
     const hrt_policy_t pol = g_policy;
@@ -540,6 +588,9 @@ uint32_t hrt__test_get_tick(void) { return g_tick; }
 
 uintptr_t hrt__schedule(const uintptr_t old_sp)
 {
+    /* PendSV runs this with interrupts masked (cpsid i); the few handler instructions
+       around the call are not part of the measured window */
+    HRT_IRQOFF_BEGIN(HRT_IRQOFF_SWITCH, 0);
 
     /* Save current only if this is not the first switch */
     if (old_sp) {
@@ -575,6 +626,7 @@ uintptr_t hrt__schedule(const uintptr_t old_sp)
     }
 #endif
 
+    HRT_SWITCH_HOOK(next_id);
     hrt__set_current(next_id);
 
     const uintptr_t sp_new = (uintptr_t)_get_sp(next_id);
@@ -584,6 +636,7 @@ uintptr_t hrt__schedule(const uintptr_t old_sp)
     dbg_sp_load = sp_new;
 #endif
 
+    HRT_IRQOFF_END(HRT_IRQOFF_SWITCH);
     return sp_new;
 }
 
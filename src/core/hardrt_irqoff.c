@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <string.h>
+
+#include "hardrt.h"
+#include "hardrt_port.h"
+#include "hardrt_irqoff.h"
+#include "hardrt_port_int.h"
+
+#if HARDRT_IRQOFF == 1
+
+static hrt_irqoff_t g_irqoff[HRT_IRQOFF_SOURCES];
+
+/* Open window per source; kept apart from the histograms so a reset from inside a
+ * critical section does not lose the start of the window it runs in */
+static uint32_t g_irqoff_t0[HRT_IRQOFF_SOURCES];
+static uintptr_t g_irqoff_site[HRT_IRQOFF_SOURCES];
+
+static uint32_t _bin(const uint32_t v) {
+    return v < 2u ? 0u : (uint32_t) (31 - __builtin_clz(v));
+}
+
+void hrt__irqoff_begin(const int src, const uintptr_t site) {
+    g_irqoff_site[src] = site;
+    g_irqoff_t0[src] = hrt_port_cycles();
+}
+
+void hrt__irqoff_end(const int src) {
+    const uint32_t d = hrt_port_cycles() - g_irqoff_t0[src];
+    hrt_irqoff_t *s = &g_irqoff[src];
+    hrt_latency_t *h = &s->hist;
+    if (h->count == 0 || d < h->min_cycles) h->min_cycles = d;
+    if (h->count == 0 || d > h->max_cycles) {
+        h->max_cycles = d;
+        s->max_site = g_irqoff_site[src];
+    }
+    h->count++;
+    h->sum_cycles += d;
+    h->bins[_bin(d)]++;
+}
+
+void hrt_irqoff_reset(void) {
+    hrt_port_crit_enter();
+    memset(g_irqoff, 0, sizeof(g_irqoff));
+    hrt_port_crit_exit();
+}
+
+int hrt_irqoff_stats(const hrt_irqoff_src_t src, hrt_irqoff_t *out) {
+    if (!out) return -1;
+    if ((unsigned) src >= HRT_IRQOFF_SOURCES) {
+        memset(out, 0, sizeof(*out));
+        return -1;
+    }
+
+    hrt_port_crit_enter();
+    *out = g_irqoff[src];
+    hrt_port_crit_exit();
+    out->hist.p99_cycles = hrt_latency_percentile(&out->hist, 990u);
+    return 0;
+}
+
+#else /* HARDRT_IRQOFF == 0 */
+
+int hrt_irqoff_stats(const hrt_irqoff_src_t src, hrt_irqoff_t *out) {
+    (void) src;
+    if (out) memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+void hrt_irqoff_reset(void) {}
+
+#endif
@@ -0,0 +1,151 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <string.h>
+
+#include "hardrt.h"
+#include "hardrt_port.h"
+#include "hardrt_isr.h"
+#include "hardrt_port_int.h"
+
+/* ---- ISR brackets ----
+ * An ISR that preempts another one leaves the nesting count as it found it, so the
+ * plain increment/decrement is safe. Wake-ups are noted under the kernel CS. */
+#define NO_WAKE 0xFFu
+
+volatile uint8_t hrt__isr_nesting = 0;
+static uint8_t g_isr_wake = NO_WAKE; // most urgent priority made ready inside the current bracket
+static uint8_t g_isr_posted = 0;     // a deferred post pended nothing yet (priority unknown)
+
+void hrt_isr_enter(void) {
+    hrt__isr_nesting++;
+}
+
+int hrt_isr_exit(void) {
+    if (hrt__isr_nesting == 0) return 0; /* unbalanced exit */
+    if (--hrt__isr_nesting != 0) return 0;
+
+    /* Exchange, so an ISR that slips in after the decrement decides on its own share */
+    const uint8_t woke = __atomic_exchange_n(&g_isr_wake, NO_WAKE, __ATOMIC_ACQ_REL);
+    const uint8_t posted = __atomic_exchange_n(&g_isr_posted, 0u, __ATOMIC_ACQ_REL);
+    if (woke == NO_WAKE && !posted) return 0;
+
+    if (!posted) {
+        /* The interrupted task keeps the CPU unless it is outranked (or not runnable anymore) */
+        const int cur = hrt__get_current();
+        const _hrt_tcb_t *t = (cur >= 0 && cur != HRT_IDLE_ID) ? hrt__tcb(cur) : NULL;
+        if (t && t->state == HRT_READY && woke >= t->prio) return 0;
+    }
+    hrt__pend_context_switch();
+    return 1;
+}
+
+void hrt__isr_note_ready(const uint8_t prio) {
+    if (prio < g_isr_wake) g_isr_wake = prio;
+}
+
+void hrt__isr_pend(void) {
+    if (hrt__isr_nesting == 0) hrt__pend_context_switch();
+}
+
+#if HARDRT_ISR_DEFER == 1
+
+#if (HARDRT_ISR_DEFER_DEPTH & (HARDRT_ISR_DEFER_DEPTH - 1u)) != 0
+#error "HARDRT_ISR_DEFER_DEPTH must be a power of two"
+#endif
+#define POST_MASK (HARDRT_ISR_DEFER_DEPTH - 1u)
+
+typedef struct {
+    void *obj;
+    uint8_t op;    // hrt__post_op_t
+    uint8_t ready; // set by the producer once obj/op are written, cleared by the drain
+} _post_t;
+
+/* Multi-producer (any ISR, nested or not), single consumer (the drain, which only
+ * runs at the switch point). Producers reserve a slot by moving the tail with a
+ * CAS and publish it through `ready`; no producer ever masks interrupts. */
+static _post_t g_post[HARDRT_ISR_DEFER_DEPTH];
+static uint32_t g_post_head;
+static uint32_t g_post_tail;
+static uint32_t g_post_overflows;
+static uint32_t g_post_high;
+
+int hrt__isr_post(const uint8_t op, void *obj) {
+    uint32_t t = __atomic_load_n(&g_post_tail, __ATOMIC_RELAXED);
+    do {
+        if (t - __atomic_load_n(&g_post_head, __ATOMIC_ACQUIRE) >= HARDRT_ISR_DEFER_DEPTH) {
+            __atomic_fetch_add(&g_post_overflows, 1u, __ATOMIC_RELAXED);
+            return -1;
+        }
+    } while (!__atomic_compare_exchange_n(&g_post_tail, &t, t + 1u, 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    _post_t *p = &g_post[t & POST_MASK];
+    p->obj = obj;
+    p->op = op;
+    __atomic_store_n(&p->ready, 1u, __ATOMIC_RELEASE);
+    if (hrt__isr_nesting) {
+        __atomic_store_n(&g_isr_posted, 1u, __ATOMIC_RELEASE);
+    } else {
+        hrt__pend_context_switch();
+    }
+    return 0;
+}
+
+void hrt__isr_drain(void) {
+    uint32_t h = g_post_head;
+    const uint32_t end = __atomic_load_n(&g_post_tail, __ATOMIC_ACQUIRE);
+    if (end == h) return;
+    if (end - h > g_post_high) g_post_high = end - h;
+
+    /* Bounded by what was pending on entry; later posts pend another pass */
+    while (h != end) {
+        _post_t *p = &g_post[h & POST_MASK];
+        /* Reserved but not yet published: its producer was preempted (a task calling a
+           *_from_isr() API) and pends a switch once it finishes, so stop here */
+        if (!__atomic_load_n(&p->ready, __ATOMIC_ACQUIRE)) break;
+        void *obj = p->obj;
+        const uint8_t op = p->op;
+        p->ready = 0;
+        __atomic_store_n(&g_post_head, ++h, __ATOMIC_RELEASE);
+
+        switch (op) {
+            case HRT__POST_SEM_GIVE:
+                hrt__sem_post_apply((hrt_sem_t *) obj);
+                break;
+            case HRT__POST_QUEUE_RX:
+                hrt__queue_post_apply((hrt_queue_t *) obj, 1);
+                break;
+            case HRT__POST_QUEUE_TX:
+                hrt__queue_post_apply((hrt_queue_t *) obj, 0);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void hrt__isr_reset(void) {
+    hrt_port_crit_enter();
+    memset(g_post, 0, sizeof(g_post));
+    __atomic_store_n(&g_post_head, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_post_tail, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_post_overflows, 0u, __ATOMIC_RELAXED);
+    g_post_high = 0;
+    hrt_port_crit_exit();
+}
+
+int hrt_isr_defer_stats(hrt_isr_defer_stats_t *out) {
+    if (!out) return -1;
+    out->applied = __atomic_load_n(&g_post_head, __ATOMIC_ACQUIRE);
+    out->posted = __atomic_load_n(&g_post_tail, __ATOMIC_ACQUIRE);
+    out->overflows = __atomic_load_n(&g_post_overflows, __ATOMIC_RELAXED);
+    out->high_water = g_post_high;
+    return 0;
+}
+
+#else /* HARDRT_ISR_DEFER == 0 */
+
+int hrt_isr_defer_stats(hrt_isr_defer_stats_t *out) {
+    if (out) memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+#endif
@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <string.h>
+
+#include "hardrt.h"
+#include "hardrt_port.h"
+#include "hardrt_latency.h"
+#include "hardrt_port_int.h"
+
+uint32_t hrt_latency_percentile(const hrt_latency_t *h, const uint32_t permille) {
+    if (!h || h->count == 0) return 0;
+    /* Rank of the sample at `permille`, rounded up */
+    const uint64_t rank = ((uint64_t) h->count * permille + 999u) / 1000u;
+    uint64_t seen = 0;
+    for (uint32_t k = 0; k < HRT_LATENCY_BINS; ++k) {
+        seen += h->bins[k];
+        if (seen >= rank) {
+            const uint32_t upper = (k >= 31u) ? UINT32_MAX : ((2u << k) - 1u);
+            return upper < h->max_cycles ? upper : h->max_cycles;
+        }
+    }
+    return h->max_cycles;
+}
+
+#if HARDRT_LATENCY == 1
+
+typedef struct {
+    hrt_latency_t h;
+    uint32_t ready_ts; /* hrt_port_cycles() at make_ready */
+    uint8_t pending;   /* a wakeup is waiting for its switch-in */
+} _lat_t;
+
+static _lat_t g_lat[HARDRT_MAX_TASKS];
+
+static uint32_t _bin(const uint32_t v) {
+    return v < 2u ? 0u : (uint32_t) (31 - __builtin_clz(v));
+}
+
+void hrt__lat_ready(const int id) {
+    g_lat[id].ready_ts = hrt_port_cycles();
+    g_lat[id].pending = 1;
+}
+
+void hrt__lat_switch(const int next) {
+    if (next < 0 || next >= HARDRT_MAX_TASKS) return;
+    _lat_t *l = &g_lat[next];
+    if (!l->pending) return;
+    l->pending = 0;
+
+    const uint32_t d = hrt_port_cycles() - l->ready_ts;
+    hrt_latency_t *h = &l->h;
+    if (h->count == 0 || d < h->min_cycles) h->min_cycles = d;
+    if (d > h->max_cycles) h->max_cycles = d;
+    h->count++;
+    h->sum_cycles += d;
+    h->bins[_bin(d)]++;
+}
+
+void hrt__lat_reset(void) {
+    memset(g_lat, 0, sizeof(g_lat));
+}
+
+int hrt_task_latency(const int id, hrt_latency_t *out) {
+    if (!out || id < 0 || id >= HARDRT_MAX_TASKS) return -1;
+    if (hrt__tcb(id)->state == HRT_UNUSED) return -1;
+
+    hrt_port_crit_enter();
+    *out = g_lat[id].h;
+    hrt_port_crit_exit();
+    out->p99_cycles = hrt_latency_percentile(out, 990u);
+    return 0;
+}
+
+void hrt_task_latency_reset(const int id) {
+    hrt_port_crit_enter();
+    for (int i = 0; i < HARDRT_MAX_TASKS; ++i) {
+        if (id < 0 || i == id) memset(&g_lat[i].h, 0, sizeof(g_lat[i].h));
+    }
+    hrt_port_crit_exit();
+}
+
+#else /* HARDRT_LATENCY == 0 */
+
+int hrt_task_latency(const int id, hrt_latency_t *out) {
+    (void) id;
+    if (out) memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+void hrt_task_latency_reset(const int id) { (void) id; }
+
+#endif
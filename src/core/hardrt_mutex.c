@@ -1,6 +1,7 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 
 #include "hardrt_mutex.h"
+#include "hardrt_port_int.h"
 
 /* Core-private hooks */
 int hrt__get_current(void);
@@ -22,6 +23,14 @@ static void _waitq_push(hrt_mutex_t *m, uint8_t id) {
     m->count_wait++;
 }
 
+/* Re-queue a woken waiter that lost the race for a barging mutex */
+static void _waitq_push_front(hrt_mutex_t *m, uint8_t id) {
+    if (m->count_wait >= HARDRT_MAX_TASKS) return;
+    m->head = (uint8_t)((m->head + HARDRT_MAX_TASKS - 1u) % HARDRT_MAX_TASKS);
+    m->q[m->head] = id;
+    m->count_wait++;
+}
+
 static int _waitq_pop(hrt_mutex_t *m) {
     if (!m->count_wait) return -1;
     const int id = m->q[m->head];
@@ -30,23 +39,39 @@ static int _waitq_pop(hrt_mutex_t *m) {
     return id;
 }
 
-/*
- * Attempt to acquire the mutex without blocking.
- *
- * MUST be called from a task context (me >= 0).
- */
-int hrt_mutex_try_lock(hrt_mutex_t *m) {
-    int me = hrt__get_current();
-    if (me < 0 || me >= HARDRT_MAX_TASKS) {
-        hrt_error(ERR_MUTEX_BAD_CTX);
-        return -1;
+/* See hrt_mutex_t::locked. The per-object counters are kept under the CS, so
+   OBJ_STATS builds take it on every call as before. */
+#if HARDRT_OBJ_STATS == 1
+#define MUTEX_LOCKFREE 0
+#else
+#define MUTEX_LOCKFREE 1
+#endif
+
+/* Take a free mutex for `me`. Returns 1 if acquired. A barging mutex can be free
+   with HRT_MUTEX_WAITERS set; the flag is kept for the unlock that follows. */
+static int _acquire(hrt_mutex_t *m, const int me) {
+    uint8_t c = __atomic_load_n(&m->locked, __ATOMIC_RELAXED);
+    do {
+        if (c & HRT_MUTEX_HELD) return 0;
+    } while (!__atomic_compare_exchange_n(&m->locked, &c, (uint8_t) (c | HRT_MUTEX_HELD), 1,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+    m->owner = (int16_t) me;
+    return 1;
+}
+
+/* `nonblock`: a failure is the caller's final answer (counted), not a step before blocking */
+static int _try_lock(hrt_mutex_t *m, const int me, const int nonblock) {
+    if (MUTEX_LOCKFREE && _acquire(m, me)) {
+        HRT_TRACE(HRT_EV_MUTEX_LOCK, HRT_TRACE_OBJ(m));
+        return 0;
     }
 
     hrt_port_crit_enter();
 
-    if (!m->locked) {
-        m->locked = 1u;
-        m->owner = me;
+    if (_acquire(m, me)) {
+        HRT_OBJ_OP(m);
+        HRT_OBJ_HOLD_BEGIN(m);
+        HRT_TRACE(HRT_EV_MUTEX_LOCK, HRT_TRACE_OBJ(m));
         hrt_port_crit_exit();
         return 0;
     }
@@ -57,58 +82,98 @@ int hrt_mutex_try_lock(hrt_mutex_t *m) {
         return -1;
     }
 
+    if (nonblock) HRT_OBJ_FAILED(m);
     hrt_port_crit_exit();
     return -1;
 }
 
 /*
- * Block until the mutex is acquired.
+ * Attempt to acquire the mutex without blocking.
  *
  * MUST be called from a task context (me >= 0).
  */
-int hrt_mutex_lock(hrt_mutex_t *m) {
+int hrt_mutex_try_lock(hrt_mutex_t *m) {
     int me = hrt__get_current();
     if (me < 0 || me >= HARDRT_MAX_TASKS) {
         hrt_error(ERR_MUTEX_BAD_CTX);
         return -1;
     }
 
-    /* Fast path */
-    if (hrt_mutex_try_lock(m) == 0) return 0;
-
-    hrt_port_crit_enter();
+    return _try_lock(m, me, 1);
+}
 
-    /* Re-check under CS */
-    if (!m->locked) {
-        m->locked = 1u;
-        m->owner = me;
-        hrt_port_crit_exit();
-        return 0;
+/*
+ * Block until the mutex is acquired.
+ *
+ * MUST be called from a task context (me >= 0).
+ */
+int hrt_mutex_lock(hrt_mutex_t *m) {
+    int me = hrt__get_current();
+    if (me < 0 || me >= HARDRT_MAX_TASKS) {
+        hrt_error(ERR_MUTEX_BAD_CTX);
+        return -1;
     }
 
-    if (m->owner == me) {
+    /* Fast path */
+    if (_try_lock(m, me, 0) == 0) return 0;
+
+    uint32_t since = 0u;
+    for (int retry = 0;; retry = 1) {
+        hrt_port_crit_enter();
+
+        /* Re-check under CS; after a barging wake-up this is the race for the lock */
+        if (_acquire(m, me)) {
+            HRT_OBJ_OP(m);
+            HRT_OBJ_HOLD_BEGIN(m);
+            if (retry) HRT_OBJ_WAITED(m, HRT_OBJ_CLOCK() - since);
+            HRT_TRACE(HRT_EV_MUTEX_LOCK, HRT_TRACE_OBJ(m));
+            hrt_port_crit_exit();
+            return 0;
+        }
+
+        if (m->owner == me) {
+            hrt_port_crit_exit();
+            hrt_error(ERR_MUTEX_RECURSIVE);
+            return -1;
+        }
+
+        _hrt_tcb_t *t = hrt__tcb(me);
+        if (!t) {
+            hrt_port_crit_exit();
+            hrt_error(ERR_TCB_NULL);
+            return -1;
+        }
+
+        /* From here on unlock takes the CS path. A waiter that lost the race after a
+           barging wake-up keeps its place at the head of the queue. */
+        m->locked = HRT_MUTEX_HELD | HRT_MUTEX_WAITERS;
+        if (retry) {
+            _waitq_push_front(m, (uint8_t)me);
+        } else {
+            _waitq_push(m, (uint8_t)me);
+            since = HRT_OBJ_CLOCK();
+        }
+
+        t->state = HRT_BLOCKED;
+        HRT_TRACE(HRT_EV_BLOCK, HRT_TRACE_OBJ(m));
         hrt_port_crit_exit();
-        hrt_error(ERR_MUTEX_RECURSIVE);
-        return -1;
-    }
 
-    _waitq_push(m, (uint8_t)me);
+        hrt__pend_context_switch();
+        hrt_port_yield_to_scheduler();
 
-    _hrt_tcb_t *t = hrt__tcb(me);
-    if (!t) {
-        hrt_port_crit_exit();
-        hrt_error(ERR_TCB_NULL);
-        return -1;
+        /* With direct handoff, unlock() already made us the owner */
+        if (m->mode == HRT_MUTEX_HANDOFF) break;
     }
 
-    t->state = HRT_BLOCKED;
-
+#if HARDRT_OBJ_STATS == 1
+    hrt_port_crit_enter();
+    HRT_OBJ_OP(m);
+    HRT_OBJ_WAITED(m, HRT_OBJ_CLOCK() - since);
     hrt_port_crit_exit();
-
-    hrt__pend_context_switch();
-    hrt_port_yield_to_scheduler();
-
-    /* When resumed, ownership was transferred to us by unlock() */
+#else
+    (void) since;
+#endif
+    HRT_TRACE(HRT_EV_MUTEX_LOCK, HRT_TRACE_OBJ(m));
     return 0;
 }
 
@@ -124,20 +189,49 @@ int hrt_mutex_unlock(hrt_mutex_t *m) {
         return -1;
     }
 
+#if MUTEX_LOCKFREE
+    if (m->owner == me && m->locked == HRT_MUTEX_HELD) {
+        /* Clear the owner first: a task that locks right after the CAS sets its own */
+        m->owner = HRT_MUTEX_NO_OWNER;
+        uint8_t c = HRT_MUTEX_HELD;
+        if (__atomic_compare_exchange_n(&m->locked, &c, 0u, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            HRT_TRACE(HRT_EV_MUTEX_UNLOCK, HRT_TRACE_OBJ(m));
+            return 0;
+        }
+        m->owner = (int16_t) me; /* a waiter queued meanwhile; still ours to hand over */
+    }
+#endif
+
     hrt_port_crit_enter();
 
-    if (!m->locked || m->owner != me) {
+    if (!(m->locked & HRT_MUTEX_HELD) || m->owner != me) {
         hrt_port_crit_exit();
         hrt_error(ERR_MUTEX_OWNER);
         return -1;
     }
 
+    HRT_TRACE(HRT_EV_MUTEX_UNLOCK, HRT_TRACE_OBJ(m));
+    HRT_OBJ_HOLD_END(m);
     const int waiter = _waitq_pop(m);
 
+    if (waiter >= 0 && m->mode == HRT_MUTEX_BARGING) {
+        /* Competitive release: free the mutex and wake the waiter to race for it. The
+           caller keeps the CPU (and may re-lock) unless the waiter outranks it. */
+        m->owner = HRT_MUTEX_NO_OWNER;
+        m->locked = m->count_wait ? HRT_MUTEX_WAITERS : 0u;
+        hrt__make_ready(waiter);
+        const int outranked = hrt__tcb(waiter)->prio < hrt__tcb(me)->prio;
+        hrt_port_crit_exit();
+
+        if (outranked) hrt_yield();
+        return 0;
+    }
+
     if (waiter >= 0) {
         /* Direct handoff: mutex stays locked, ownership moves to waiter */
-        m->locked = 1u;
-        m->owner = waiter;
+        m->locked = m->count_wait ? (HRT_MUTEX_HELD | HRT_MUTEX_WAITERS) : HRT_MUTEX_HELD;
+        m->owner = (int16_t) waiter;
+        HRT_OBJ_HOLD_BEGIN(m);
         hrt__make_ready(waiter);
         hrt_port_crit_exit();
 
@@ -147,8 +241,8 @@ int hrt_mutex_unlock(hrt_mutex_t *m) {
     }
 
     /* Nobody waiting: release */
-    m->locked = 0u;
     m->owner = HRT_MUTEX_NO_OWNER;
+    m->locked = 0u;
     hrt_port_crit_exit();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,213 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <string.h>
+
+#include "hardrt.h"
+#include "hardrt_port.h"
+#include "hardrt_objstats.h"
+#include "hardrt_port_int.h"
+
+#if HARDRT_OBJ_STATS == 1
+
+#if HARDRT_OBJ_STATS_QUEUE_TS == 0 || HARDRT_OBJ_STATS_QUEUE_TS > 32 || \
+    (HARDRT_OBJ_STATS_QUEUE_TS & (HARDRT_OBJ_STATS_QUEUE_TS - 1)) != 0
+#error "HARDRT_OBJ_STATS_QUEUE_TS must be a power of two <= 32"
+#endif
+
+#define QTS_MASK (HARDRT_OBJ_STATS_QUEUE_TS - 1u)
+
+void hrt__obj_op(hrt__obj_rec_t *r) {
+    r->s.ops++;
+}
+
+void hrt__obj_failed(hrt__obj_rec_t *r) {
+    r->s.failed++;
+}
+
+void hrt__obj_waited(hrt__obj_rec_t *r, const uint32_t cycles) {
+    r->s.contended++;
+    r->s.blocked_cycles += cycles;
+    if (cycles > r->s.max_blocked_cycles) r->s.max_blocked_cycles = cycles;
+}
+
+void hrt__obj_stall(hrt__obj_rec_t *r, const int full) {
+    if (full) {
+        r->s.full_stalls++;
+    } else {
+        r->s.empty_stalls++;
+    }
+}
+
+void hrt__obj_hold_begin(hrt__obj_rec_t *r) {
+    r->mark = hrt_port_cycles();
+}
+
+void hrt__obj_hold_end(hrt__obj_rec_t *r) {
+    const uint32_t held = hrt_port_cycles() - r->mark;
+    r->s.hold_cycles += held;
+    if (held > r->s.max_hold_cycles) r->s.max_hold_cycles = held;
+}
+
+/* Items are numbered in FIFO order, so the item leaving is always seq_out. An item is
+ * stamped only if fewer than HARDRT_OBJ_STATS_QUEUE_TS were queued when it arrived;
+ * its slot then cannot be reused before it leaves. */
+void hrt__obj_put(hrt__obj_rec_t *r, hrt__obj_qts_t *ts, const uint16_t depth) {
+    r->s.ops++;
+    if (depth > r->s.high_water) r->s.high_water = depth;
+
+    const uint32_t slot = ts->seq_in++ & QTS_MASK;
+    if (depth <= HARDRT_OBJ_STATS_QUEUE_TS) {
+        ts->ts[slot] = hrt_port_cycles();
+        ts->valid |= 1u << slot;
+    }
+}
+
+void hrt__obj_get(hrt__obj_rec_t *r, hrt__obj_qts_t *ts) {
+    r->s.ops++;
+
+    const uint32_t slot = ts->seq_out++ & QTS_MASK;
+    if (ts->valid & (1u << slot)) {
+        ts->valid &= ~(1u << slot);
+        const uint32_t lat = hrt_port_cycles() - ts->ts[slot];
+        r->s.latency_samples++;
+        r->s.latency_cycles += lat;
+        if (lat > r->s.max_latency_cycles) r->s.max_latency_cycles = lat;
+    }
+}
+
+static hrt__obj_rec_t *_rec(const void *obj, const hrt_obj_kind_t kind) {
+    switch (kind) {
+        case HRT_OBJ_SEM:   return &((hrt_sem_t *) (uintptr_t) obj)->st;
+        case HRT_OBJ_MUTEX: return &((hrt_mutex_t *) (uintptr_t) obj)->st;
+        case HRT_OBJ_QUEUE: return &((hrt_queue_t *) (uintptr_t) obj)->st;
+        default:            return NULL;
+    }
+}
+
+int hrt_obj_stats(const void *obj, const hrt_obj_kind_t kind, hrt_obj_stats_t *out) {
+    if (!out) return -1;
+    const hrt__obj_rec_t *r = obj ? _rec(obj, kind) : NULL;
+    if (!r) {
+        memset(out, 0, sizeof(*out));
+        return -1;
+    }
+
+    hrt_port_crit_enter();
+    *out = r->s;
+    hrt_port_crit_exit();
+    out->cycles_hz = hrt_port_cycles_hz();
+    return 0;
+}
+
+int hrt_obj_stats_reset(void *obj, const hrt_obj_kind_t kind) {
+    hrt__obj_rec_t *r = obj ? _rec(obj, kind) : NULL;
+    if (!r) return -1;
+
+    hrt_port_crit_enter();
+    memset(r, 0, sizeof(*r));
+    if (kind == HRT_OBJ_QUEUE) {
+        /* Items already queued are numbered but unstamped */
+        hrt_queue_t *q = obj;
+        memset(&q->st_ts, 0, sizeof(q->st_ts));
+        q->st_ts.seq_in = q->count;
+    }
+    hrt_port_crit_exit();
+    return 0;
+}
+
+/* ---------------- Registry ---------------- */
+
+typedef struct {
+    const void *obj;
+    const char *name;
+    hrt_obj_kind_t kind;
+} _obj_reg_t;
+
+static _obj_reg_t g_obj_reg[HARDRT_OBJ_REGISTRY];
+static int g_obj_nreg = 0;
+
+static int _reg_find(const void *obj) {
+    for (int i = 0; i < g_obj_nreg; ++i) {
+        if (g_obj_reg[i].obj == obj) return i;
+    }
+    return -1;
+}
+
+int hrt_obj_register(const void *obj, const hrt_obj_kind_t kind, const char *name) {
+    if (!obj || !_rec(obj, kind)) return -1;
+
+    int rc = 0;
+    hrt_port_crit_enter();
+    int i = _reg_find(obj);
+    if (i < 0 && g_obj_nreg < (int) HARDRT_OBJ_REGISTRY) i = g_obj_nreg++;
+    if (i >= 0) {
+        g_obj_reg[i].obj = obj;
+        g_obj_reg[i].name = name;
+        g_obj_reg[i].kind = kind;
+    } else {
+        rc = -1;
+    }
+    hrt_port_crit_exit();
+    return rc;
+}
+
+void hrt_obj_unregister(const void *obj) {
+    hrt_port_crit_enter();
+    const int i = _reg_find(obj);
+    if (i >= 0) {
+        /* Keep registration order for hrt_obj_enum() */
+        memmove(&g_obj_reg[i], &g_obj_reg[i + 1], (size_t) (g_obj_nreg - i - 1) * sizeof(g_obj_reg[0]));
+        g_obj_nreg--;
+    }
+    hrt_port_crit_exit();
+}
+
+int hrt_obj_enum(const int index, hrt_obj_info_t *out) {
+    if (!out) return -1;
+
+    hrt_port_crit_enter();
+    const int ok = index >= 0 && index < g_obj_nreg;
+    _obj_reg_t e = {0};
+    if (ok) e = g_obj_reg[index];
+    hrt_port_crit_exit();
+
+    memset(out, 0, sizeof(*out));
+    if (!ok) return -1;
+    out->obj = e.obj;
+    out->name = e.name;
+    out->kind = e.kind;
+    return hrt_obj_stats(e.obj, e.kind, &out->stats);
+}
+
+#else /* HARDRT_OBJ_STATS == 0 */
+
+int hrt_obj_stats(const void *obj, const hrt_obj_kind_t kind, hrt_obj_stats_t *out) {
+    (void) obj;
+    (void) kind;
+    if (out) memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+int hrt_obj_stats_reset(void *obj, const hrt_obj_kind_t kind) {
+    (void) obj;
+    (void) kind;
+    return -1;
+}
+
+int hrt_obj_register(const void *obj, const hrt_obj_kind_t kind, const char *name) {
+    (void) obj;
+    (void) kind;
+    (void) name;
+    return -1;
+}
+
+void hrt_obj_unregister(const void *obj) {
+    (void) obj;
+}
+
+int hrt_obj_enum(const int index, hrt_obj_info_t *out) {
+    (void) index;
+    if (out) memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+#endif
@@ -1,6 +1,7 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 #include "hardrt.h"
 #include "hardrt_queue.h"
+#include "hardrt_port_int.h"
 
 #include <string.h>
 
@@ -43,21 +44,60 @@ void hrt_queue_init(hrt_queue_t *q, void *storage, uint16_t capacity, size_t ite
     q->buf = (uint8_t *)storage;
     q->item_size = item_size;
     q->capacity = capacity;
+    q->mask = HRT__QUEUE_MASK(capacity);
+    q->copy_words = HRT__QUEUE_WORDS(item_size);
 
     q->head = q->tail = q->count = 0;
 
     q->rx_head = q->rx_tail = q->rx_wait = 0;
     q->tx_head = q->tx_tail = q->tx_wait = 0;
+    q->sel = NULL;
+#if HARDRT_OBJ_STATS == 1
+    hrt_obj_stats_reset(q, HRT_OBJ_QUEUE);
+#endif
+}
+
+/* ---------------- Item copies and ring indexing ----------------
+ * Small word-sized items move as plain word assignments (no memcpy call) when both
+ * ends are word aligned, and the ring wraps with a mask or a compare instead of a
+ * division. Unrolled on purpose: a copy loop would be turned back into memcpy. */
+typedef uint32_t __attribute__((may_alias)) _word_t;
+
+static void _copy_item(const hrt_queue_t *q, void *dst, const void *src) {
+    if ((((uintptr_t) dst | (uintptr_t) src) & 3u) == 0u) {
+        _word_t *d = dst;
+        const _word_t *w = src;
+        switch (q->copy_words) {
+            case 4: d[3] = w[3]; /* fall through */
+            case 3: d[2] = w[2]; /* fall through */
+            case 2: d[1] = w[1]; /* fall through */
+            case 1: d[0] = w[0]; return;
+            default: break;
+        }
+    }
+    memcpy(dst, src, q->item_size);
+}
+
+static uint16_t _next(const hrt_queue_t *q, const uint16_t idx) {
+    if (q->mask) return (uint16_t)((idx + 1u) & q->mask);
+    return (uint16_t)(idx + 1u == q->capacity ? 0u : idx + 1u);
+}
+
+/* Copy into the ring tail: expects CS held and a free slot */
+static void _ring_put(hrt_queue_t *q, const void *item) {
+    const uint16_t idx = q->tail;
+    _copy_item(q, &q->buf[(size_t)idx * q->item_size], item);
+    q->tail = _next(q, idx);
+    q->count++;
+    HRT_OBJ_PUT(q);
 }
 
 /* Enqueue common: expects CS held, returns 0 if enqueued, -1 if full */
 static int _enqueue_cs(hrt_queue_t *q, const void *item) {
     if (q->count >= q->capacity) return -1;
 
-    const uint16_t idx = q->tail;
-    memcpy(&q->buf[(size_t)idx * q->item_size], item, q->item_size);
-    q->tail = (uint16_t)((q->tail + 1u) % q->capacity);
-    q->count++;
+    _ring_put(q, item);
+    HRT_TRACE(HRT_EV_QUEUE_SEND, HRT_TRACE_OBJ(q));
     return 0;
 }
 
@@ -66,58 +106,168 @@ static int _dequeue_cs(hrt_queue_t *q, void *out) {
     if (!q->count) return -1;
 
     const uint16_t idx = q->head;
-    memcpy(out, &q->buf[(size_t)idx * q->item_size], q->item_size);
-    q->head = (uint16_t)((q->head + 1u) % q->capacity);
+    _copy_item(q, out, &q->buf[(size_t)idx * q->item_size]);
+    q->head = _next(q, idx);
     q->count--;
+    HRT_OBJ_GET(q);
+    HRT_TRACE(HRT_EV_QUEUE_RECV, HRT_TRACE_OBJ(q));
     return 0;
 }
 
-int hrt_queue_try_send(hrt_queue_t *q, const void *item) {
-    HRT_ASSERT(q);
-    HRT_ASSERT(item);
+/* ---------------- Direct handoff ----------------
+ * A task that blocks registers its item buffer in its TCB (wait_buf). The peer that
+ * finds it at the head of the wait queue completes the transfer on its behalf and
+ * clears wait_buf, so the woken task returns without touching the ring again. A
+ * wake-up without a transfer (deferred ISR posts) leaves wait_buf set: retry. */
+
+/* Sender side, CS held: copy `item` straight into the first blocked receiver's buffer.
+ * Only while the ring is empty, so no queued item is overtaken. Returns the receiver
+ * made ready, or -1. */
+static int _handoff_to_rx(hrt_queue_t *q, const void *item) {
+    if (q->count) return -1;
+    const int waiter = _wq_pop(q->rx_q, &q->rx_head, &q->rx_wait);
+    if (waiter < 0) return -1;
+
+    _hrt_tcb_t *t = hrt__tcb(waiter);
+    _copy_item(q, t->wait_buf, item);
+    t->wait_buf = NULL;
+    HRT_OBJ_PUT(q);
+    HRT_OBJ_GET(q);
+    HRT_TRACE(HRT_EV_QUEUE_SEND, HRT_TRACE_OBJ(q));
+    hrt__make_ready(waiter);
+    return waiter;
+}
 
-    int ok;
-    int woken = 0;
+/* Receiver side, CS held, right after a dequeue: move the first blocked sender's item
+ * into the slot just freed. Returns the sender made ready, or -1. */
+static int _handoff_from_tx(hrt_queue_t *q) {
+    const int waiter = _wq_pop(q->tx_q, &q->tx_head, &q->tx_wait);
+    if (waiter < 0) return -1;
+
+    _hrt_tcb_t *t = hrt__tcb(waiter);
+    _ring_put(q, t->wait_buf);
+    t->wait_buf = NULL;
+    hrt__make_ready(waiter);
+    return waiter;
+}
 
+/* Send with the CS held: hand over to a blocked receiver, or enqueue. Returns 0 on
+ * success, -1 if full; *woken is the task made ready, or -1. */
+static int _send_cs(hrt_queue_t *q, const void *item, int *woken) {
+    *woken = _handoff_to_rx(q, item);
+    if (*woken >= 0) return 0;
+    if (_enqueue_cs(q, item) != 0) return -1;
+
+    /* A receiver still queued next to a non-empty ring was woken without a transfer
+       by a deferred ISR post that has not run yet; wake one more to retry. */
+    *woken = _wq_pop(q->rx_q, &q->rx_head, &q->rx_wait);
+    if (*woken >= 0) {
+        hrt__make_ready(*woken);
+    } else {
+        *woken = hrt__select_notify(q->sel); /* the item is for whoever waits on the set */
+    }
+    return 0;
+}
+
+/* Receive with the CS held: take the ring head and refill the slot from a blocked
+ * sender. Returns 0 on success, -1 if empty; *woken as for _send_cs(). */
+static int _recv_cs(hrt_queue_t *q, void *out, int *woken) {
+    *woken = -1;
+    if (_dequeue_cs(q, out) != 0) return -1;
+    *woken = _handoff_from_tx(q);
+    return 0;
+}
+
+/* Blocked send/recv resumed: 0 if a peer completed the transfer, -1 to retry */
+static int _handed_off(hrt_queue_t *q, const _hrt_tcb_t *t, const uint32_t waited) {
+    if (!t || t->wait_buf) return -1;
+#if HARDRT_OBJ_STATS == 1
     hrt_port_crit_enter();
-    ok = _enqueue_cs(q, item);
+    HRT_OBJ_WAITED(q, waited);
+    hrt_port_crit_exit();
+#else
+    (void) q;
+    (void) waited;
+#endif
+    return 0;
+}
+
+#if HARDRT_ISR_DEFER == 1
+/* Wake one receiver (`rx`) or sender. Drain side of a deferred ISR wake-up and its
+ * fallback when the post ring is full. A waiter retries its transfer when it runs,
+ * so waking it after the CS that changed the ring is safe even if another task got
+ * there first. */
+void hrt__queue_post_apply(hrt_queue_t *q, const int rx) {
+    hrt_port_crit_enter();
+    const int waiter = rx ? _wq_pop(q->rx_q, &q->rx_head, &q->rx_wait)
+                          : _wq_pop(q->tx_q, &q->tx_head, &q->tx_wait);
+    if (waiter >= 0) hrt__make_ready(waiter);
+    hrt_port_crit_exit();
+}
+
+/* ISR side: the data moved under a short CS; only post the wake-up */
+static void _isr_wake(hrt_queue_t *q, const int rx) {
+    if (hrt__isr_post(rx ? HRT__POST_QUEUE_RX : HRT__POST_QUEUE_TX, q) != 0) hrt__queue_post_apply(q, rx);
+}
+#endif
+
+/* Task-context send attempt. `parks` is -1 for hrt_queue_try_send(), otherwise how often
+ * the blocking caller has parked so far and `waited` how long, for the statistics. */
+static int _try_send(hrt_queue_t *q, const void *item, const int parks, const uint32_t waited) {
+    int waiter;
+
+    hrt_port_crit_enter();
+    const int ok = _send_cs(q, item, &waiter);
     if (ok == 0) {
-        /* If a receiver is waiting, wake exactly one. */
-        const int waiter = _wq_pop(q->rx_q, &q->rx_head, &q->rx_wait);
-        if (waiter >= 0) {
-            hrt__make_ready(waiter);
-            woken = 1;
-        }
+        if (parks > 0) HRT_OBJ_WAITED(q, waited);
+    } else if (parks < 0) {
+        HRT_OBJ_STALL(q, 1);
+        HRT_OBJ_FAILED(q);
     }
     hrt_port_crit_exit();
 
     /* Mirror semaphore behaviour: if we woke someone, yield to let it run. */
-    if (woken) hrt_yield();
+    if (waiter >= 0) hrt_yield();
     return ok;
 }
 
+int hrt_queue_try_send(hrt_queue_t *q, const void *item) {
+    HRT_ASSERT(q);
+    HRT_ASSERT(item);
+
+    return _try_send(q, item, -1, 0);
+}
+
 int hrt_queue_try_send_from_isr(hrt_queue_t *q, const void *item, int *need_switch) {
     HRT_ASSERT(q);
     HRT_ASSERT(item);
 
     int ok;
-    int woken = 0;
+    int woken;
 
     hrt_port_crit_enter();
+#if HARDRT_ISR_DEFER == 1
     ok = _enqueue_cs(q, item);
-    if (ok == 0) {
-        const int waiter = _wq_pop(q->rx_q, &q->rx_head, &q->rx_wait);
-        if (waiter >= 0) {
-            hrt__make_ready(waiter);
-            woken = 1;
-        }
+    woken = ok == 0 && q->rx_wait != 0; /* woken after the CS, see _isr_wake() */
+    /* A set waiter is woken here: the post ring carries queue and semaphore commands only */
+    const int sel_woken = ok == 0 && !woken && hrt__select_notify(q->sel) >= 0;
+#else
+    int waiter;
+    ok = _send_cs(q, item, &waiter);
+    woken = waiter >= 0;
+#endif
+    if (ok != 0) {
+        HRT_OBJ_STALL(q, 1);
+        HRT_OBJ_FAILED(q);
     }
     hrt_port_crit_exit();
+#if HARDRT_ISR_DEFER == 1
+    if (woken) _isr_wake(q, 1);
+    woken |= sel_woken;
+#endif
 
     if (need_switch) *need_switch = woken;
-    if (woken) {
-        hrt__pend_context_switch();
-    }
+    if (woken) hrt__isr_pend();
     return ok;
 }
 
@@ -125,82 +275,101 @@ int hrt_queue_send(hrt_queue_t *q, const void *item) {
     HRT_ASSERT(q);
     HRT_ASSERT(item);
 
+    int parks = 0;
+    uint32_t waited = 0;
     for (;;) {
         /* Fast path */
-        if (hrt_queue_try_send(q, item) == 0) return 0;
+        if (_try_send(q, item, parks, waited) == 0) return 0;
 
         /* Full: block the current task on TX waiters */
         const int me = hrt__get_current();
+        _hrt_tcb_t *t = hrt__tcb(me);
 
         hrt_port_crit_enter();
 
         /* Re-check after CS in case space appeared */
-        if (q->count < q->capacity) {
-            const int ok = _enqueue_cs(q, item);
-            /* Potentially wake receiver */
-            const int waiter = _wq_pop(q->rx_q, &q->rx_head, &q->rx_wait);
-            if (waiter >= 0) hrt__make_ready(waiter);
+        int waiter;
+        if (_send_cs(q, item, &waiter) == 0) {
+            if (parks > 0) HRT_OBJ_WAITED(q, waited);
             hrt_port_crit_exit();
-            return ok;
+            return 0;
         }
 
-        /* Queue still full: park ourselves */
+        /* Queue still full: park ourselves; the receiver that frees a slot fills it from `item` */
+        if (!parks) HRT_OBJ_STALL(q, 1);
         _wq_push(q->tx_q, &q->tx_tail, &q->tx_wait, (uint8_t)me);
-        _hrt_tcb_t *t = hrt__tcb(me);
-        if (t) t->state = HRT_BLOCKED;
+        if (t) {
+            t->wait_buf = (void *)(uintptr_t)item;
+            t->state = HRT_BLOCKED;
+        }
+        HRT_TRACE(HRT_EV_BLOCK, HRT_TRACE_OBJ(q));
+        const uint32_t since = HRT_OBJ_CLOCK();
         hrt_port_crit_exit();
 
         hrt__pend_context_switch();
         hrt_port_yield_to_scheduler();
-        /* When resumed, loop and retry */
+        waited += HRT_OBJ_CLOCK() - since;
+        parks++;
+        if (_handed_off(q, t, waited) == 0) {
+            HRT_TRACE(HRT_EV_QUEUE_SEND, HRT_TRACE_OBJ(q));
+            return 0;
+        }
+        /* Woken without a transfer: loop and retry */
     }
 }
 
-int hrt_queue_try_recv(hrt_queue_t *q, void *out) {
-    HRT_ASSERT(q);
-    HRT_ASSERT(out);
-
-    int ok;
-    int woken = 0;
+/* Task-context receive attempt; `parks` and `waited` as for _try_send() */
+static int _try_recv(hrt_queue_t *q, void *out, const int parks, const uint32_t waited) {
+    int waiter;
 
     hrt_port_crit_enter();
-    ok = _dequeue_cs(q, out);
+    const int ok = _recv_cs(q, out, &waiter);
     if (ok == 0) {
-        /* If a sender is waiting, wake exactly one (we just freed space). */
-        const int waiter = _wq_pop(q->tx_q, &q->tx_head, &q->tx_wait);
-        if (waiter >= 0) {
-            hrt__make_ready(waiter);
-            woken = 1;
-        }
+        if (parks > 0) HRT_OBJ_WAITED(q, waited);
+    } else if (parks < 0) {
+        HRT_OBJ_STALL(q, 0);
+        HRT_OBJ_FAILED(q);
     }
     hrt_port_crit_exit();
 
-    if (woken) hrt_yield();
+    if (waiter >= 0) hrt_yield();
     return ok;
 }
 
+int hrt_queue_try_recv(hrt_queue_t *q, void *out) {
+    HRT_ASSERT(q);
+    HRT_ASSERT(out);
+
+    return _try_recv(q, out, -1, 0);
+}
+
 int hrt_queue_try_recv_from_isr(hrt_queue_t *q, void *out, int *need_switch) {
     HRT_ASSERT(q);
     HRT_ASSERT(out);
 
     int ok;
-    int woken = 0;
+    int woken;
 
     hrt_port_crit_enter();
+#if HARDRT_ISR_DEFER == 1
     ok = _dequeue_cs(q, out);
-    if (ok == 0) {
-        const int waiter = _wq_pop(q->tx_q, &q->tx_head, &q->tx_wait);
-        if (waiter >= 0) {
-            hrt__make_ready(waiter);
-            woken = 1;
-        }
+    woken = ok == 0 && q->tx_wait != 0; /* woken after the CS, see _isr_wake() */
+#else
+    int waiter;
+    ok = _recv_cs(q, out, &waiter);
+    woken = waiter >= 0;
+#endif
+    if (ok != 0) {
+        HRT_OBJ_STALL(q, 0);
+        HRT_OBJ_FAILED(q);
     }
     hrt_port_crit_exit();
+#if HARDRT_ISR_DEFER == 1
+    if (woken) _isr_wake(q, 0);
+#endif
 
     if (need_switch) *need_switch = woken;
-    if (woken) {
-        hrt__pend_context_switch();
-    }
+    if (woken) hrt__isr_pend();
     return ok;
 }
 
@@ -208,32 +377,45 @@ int hrt_queue_recv(hrt_queue_t *q, void *out) {
     HRT_ASSERT(q);
     HRT_ASSERT(out);
 
+    int parks = 0;
+    uint32_t waited = 0;
     for (;;) {
         /* Fast path */
-        if (hrt_queue_try_recv(q, out) == 0) return 0;
+        if (_try_recv(q, out, parks, waited) == 0) return 0;
 
         /* Empty: block the current task on RX waiters */
         const int me = hrt__get_current();
+        _hrt_tcb_t *t = hrt__tcb(me);
 
         hrt_port_crit_enter();
 
         /* Re-check after CS in case data appeared */
-        if (q->count) {
-            const int ok = _dequeue_cs(q, out);
-            /* Potentially wake sender */
-            const int waiter = _wq_pop(q->tx_q, &q->tx_head, &q->tx_wait);
-            if (waiter >= 0) hrt__make_ready(waiter);
+        int waiter;
+        if (_recv_cs(q, out, &waiter) == 0) {
+            if (parks > 0) HRT_OBJ_WAITED(q, waited);
             hrt_port_crit_exit();
-            return ok;
+            return 0;
         }
 
-        /* Queue still empty: park ourselves */
+        /* Queue still empty: park ourselves; the next sender copies straight into `out` */
+        if (!parks) HRT_OBJ_STALL(q, 0);
         _wq_push(q->rx_q, &q->rx_tail, &q->rx_wait, (uint8_t)me);
-        _hrt_tcb_t *t = hrt__tcb(me);
-        if (t) t->state = HRT_BLOCKED;
+        if (t) {
+            t->wait_buf = out;
+            t->state = HRT_BLOCKED;
+        }
+        HRT_TRACE(HRT_EV_BLOCK, HRT_TRACE_OBJ(q));
+        const uint32_t since = HRT_OBJ_CLOCK();
         hrt_port_crit_exit();
 
         hrt__pend_context_switch();
         hrt_port_yield_to_scheduler();
+        waited += HRT_OBJ_CLOCK() - since;
+        parks++;
+        if (_handed_off(q, t, waited) == 0) {
+            HRT_TRACE(HRT_EV_QUEUE_RECV, HRT_TRACE_OBJ(q));
+            return 0;
+        }
+        /* Woken without a transfer: loop and retry */
     }
 }
@@ -28,6 +28,8 @@ void hrt__pend_context_switch(void);
 void hrt__tick_isr(void) {
     /* advance time */
     hrt__inc_tick();
+    HRT_STATS_TICK();
+    HRT_TRACE(HRT_EV_TICK, hrt_tick_now());
 
     uint8_t triggerPendSV = 0;
     /* wake sleepers */
@@ -76,6 +78,25 @@ void hrt__tick_isr(void) {
     }
 }
 
+/* Earliest wake tick among sleeping tasks (wrap-safe).
+   Returns 0 and writes *out if any task sleeps, -1 otherwise. */
+int hrt__next_wake_tick(uint32_t *out) {
+    const uint32_t now = hrt_tick_now();
+    int found = 0;
+    uint32_t best = 0;
+    for (int i = 0; i < HARDRT_MAX_TASKS; ++i) {
+        const _hrt_tcb_t *t = hrt__tcb(i);
+        if (!t || t->state != HRT_SLEEP) continue;
+        if (!found || (int32_t) (t->wake_tick - now) < (int32_t) (best - now)) {
+            best = t->wake_tick;
+            found = 1;
+        }
+    }
+    if (!found) return -1;
+    *out = best;
+    return 0;
+}
+
 void hrt_tick_from_isr(void) {
     // Only allow tick advancement when using EXTERNAL mode
 
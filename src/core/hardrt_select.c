@@ -0,0 +1,126 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#include "hardrt.h"
+#include "hardrt_select.h"
+#include "hardrt_port_int.h"
+
+/* Core-private hooks (same pattern as hardrt_sem.c) */
+int hrt__get_current(void);
+void hrt__make_ready(int id);
+
+/* Port-provided critical section (non-nestable minimal CS) */
+void hrt_port_crit_enter(void);
+void hrt_port_crit_exit(void);
+
+/* Port-provided yield trampoline (task context) */
+extern void hrt_port_yield_to_scheduler(void);
+
+/* ---------------- Internal waiter FIFO helpers ---------------- */
+static void _waitq_push(hrt_select_t *s, const uint8_t id) {
+    if (s->count_wait >= HARDRT_MAX_TASKS) return;
+    s->q[s->tail] = id;
+    s->tail = (uint8_t)((s->tail + 1u) % HARDRT_MAX_TASKS);
+    s->count_wait++;
+}
+
+static int _waitq_pop(hrt_select_t *s) {
+    if (!s->count_wait) return -1;
+    const int id = s->q[s->head];
+    s->head = (uint8_t)((s->head + 1u) % HARDRT_MAX_TASKS);
+    s->count_wait--;
+    return id;
+}
+
+void hrt_select_init(hrt_select_t *s) {
+    HRT_ASSERT(s);
+
+    for (unsigned i = 0; i < HARDRT_SELECT_MAX; ++i) {
+        s->obj[i] = NULL;
+        s->kind[i] = 0;
+    }
+    s->count = 0;
+    s->head = s->tail = s->count_wait = 0;
+}
+
+/* Link a member under the CS; `link` is the member's back-pointer */
+static int _add(hrt_select_t *s, void *obj, const uint8_t kind, struct hrt_select **link) {
+    int idx = -1;
+
+    hrt_port_crit_enter();
+    if (s->count < HARDRT_SELECT_MAX && (*link == NULL || *link == s)) {
+        idx = s->count++;
+        s->obj[idx] = obj;
+        s->kind[idx] = kind;
+        *link = s;
+    }
+    hrt_port_crit_exit();
+    return idx;
+}
+
+int hrt_select_add_queue(hrt_select_t *s, hrt_queue_t *q) {
+    HRT_ASSERT(s);
+    HRT_ASSERT(q);
+
+    return _add(s, q, HRT_SELECT_QUEUE, &q->sel);
+}
+
+int hrt_select_add_sem(hrt_select_t *s, hrt_sem_t *sem) {
+    HRT_ASSERT(s);
+    HRT_ASSERT(sem);
+
+    return _add(s, sem, HRT_SELECT_SEM, &sem->sel);
+}
+
+/* First ready member in the order added, or -1. Level-triggered: reads the member's
+ * state, so an item or token that arrived before the caller started waiting counts. */
+static int _ready(const hrt_select_t *s) {
+    for (int i = 0; i < s->count; ++i) {
+        if (s->kind[i] == HRT_SELECT_QUEUE) {
+            if (((const hrt_queue_t *)s->obj[i])->count) return i;
+        } else {
+            if (((const hrt_sem_t *)s->obj[i])->count & HRT_SEM_MAX_COUNT) return i;
+        }
+    }
+    return -1;
+}
+
+int hrt_select_try(hrt_select_t *s) {
+    HRT_ASSERT(s);
+
+    hrt_port_crit_enter();
+    const int idx = _ready(s);
+    hrt_port_crit_exit();
+    return idx;
+}
+
+int hrt_select_wait(hrt_select_t *s) {
+    HRT_ASSERT(s);
+
+    for (;;) {
+        hrt_port_crit_enter();
+        const int idx = _ready(s);
+        if (idx >= 0 || !s->count) {
+            hrt_port_crit_exit();
+            return idx;
+        }
+
+        /* Nothing ready: park until a member notifies the set. The scan and the park
+           share the CS with every notification, so none can slip in between. */
+        const int me = hrt__get_current();
+        _hrt_tcb_t *t = hrt__tcb(me);
+        _waitq_push(s, (uint8_t)me);
+        if (t) t->state = HRT_BLOCKED;
+        HRT_TRACE(HRT_EV_BLOCK, HRT_TRACE_OBJ(s));
+        hrt_port_crit_exit();
+
+        hrt__pend_context_switch();
+        hrt_port_yield_to_scheduler();
+        /* Woken by a notification: rescan, another task may have emptied the member */
+    }
+}
+
+int hrt__select_notify(struct hrt_select *sel) {
+    if (!sel) return -1;
+    const int waiter = _waitq_pop(sel);
+    if (waiter >= 0) hrt__make_ready(waiter);
+    return waiter;
+}
@@ -2,6 +2,7 @@
 #include "hardrt.h"
 #include "hardrt_sem.h"
 #include "hardrt_time.h"
+#include "hardrt_port_int.h"
 
 /* Local debug prints for this file only. Not overridable from outside. */
 #undef HRT_SEM_DEBUG
@@ -58,29 +59,80 @@ static int _waitq_pop(hrt_sem_t *s) {
     return id;
 }
 
-void hrt_sem_init_counting(hrt_sem_t *s, unsigned init, uint8_t max_count) {
+void hrt_sem_init_counting(hrt_sem_t *s, unsigned init, uint32_t max_count) {
     /* Clamp to sane range. max_count==0 treated as binary. */
     if (max_count == 0u) max_count = 1u;
+    if (max_count > HRT_SEM_MAX_COUNT) max_count = HRT_SEM_MAX_COUNT;
     s->max_count = max_count;
     if (init > max_count) init = max_count;
-    s->count = (uint8_t)init;
+    s->count = (uint32_t)init;
     s->head = s->tail = s->count_wait = 0;
+    s->sel = NULL;
+#if HARDRT_OBJ_STATS == 1
+    hrt_obj_stats_reset(s, HRT_OBJ_SEM);
+#endif
 }
 
-int hrt_sem_try_take(hrt_sem_t *s) {
+/* Uncontended take and give skip the CS: `count` is claimed and refilled with a CAS,
+ * and HRT_SEM_WAITERS (set under the CS by the first task to queue) sends every give
+ * to the slow path until the queue drains. The per-object counters are kept under the
+ * CS, so OBJ_STATS builds take it on every call as before. */
+#if HARDRT_OBJ_STATS == 1
+#define SEM_LOCKFREE 0
+#else
+#define SEM_LOCKFREE 1
+#endif
+
+/* Claim one stored token. Returns 0 on success, -1 if none is stored. */
+static int _claim(hrt_sem_t *s) {
+    uint32_t c = __atomic_load_n(&s->count, __ATOMIC_RELAXED);
+    while (c & HRT_SEM_MAX_COUNT) {
+        if (__atomic_compare_exchange_n(&s->count, &c, c - 1u, 1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return 0;
+    }
+    return -1;
+}
+
+/* Store one token, saturating at max_count. Returns -1 if tasks are queued: the
+ * token belongs to the first of them, which only _give_cs() may hand it to. */
+static int _store(hrt_sem_t *s) {
+    uint32_t c = __atomic_load_n(&s->count, __ATOMIC_RELAXED);
+    do {
+        if (c & HRT_SEM_WAITERS) return -1;
+        if (c >= s->max_count) return 0;
+    } while (!__atomic_compare_exchange_n(&s->count, &c, c + 1u, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    return 0;
+}
+
+/* `nonblock`: a failure is the caller's final answer (counted), not a step before blocking */
+static int _try_take(hrt_sem_t *s, const int nonblock) {
     int ok = -1;
+#if SEM_LOCKFREE
+    (void) nonblock;
+    if (_claim(s) == 0) {
+        ok = 0;
+        HRT_TRACE(HRT_EV_SEM_TAKE, HRT_TRACE_OBJ(s));
+    }
+#else
     hrt_port_crit_enter();
-    if (s->count) {
-        s->count--;
+    if (_claim(s) == 0) {
         ok = 0;
+        HRT_OBJ_OP(s);
+        HRT_TRACE(HRT_EV_SEM_TAKE, HRT_TRACE_OBJ(s));
+    } else if (nonblock) {
+        HRT_OBJ_FAILED(s);
     }
     hrt_port_crit_exit();
+#endif
     return ok;
 }
 
+int hrt_sem_try_take(hrt_sem_t *s) {
+    return _try_take(s, 1);
+}
+
 int hrt_sem_take(hrt_sem_t *s) {
     /* Fast-path: try without blocking */
-    if (hrt_sem_try_take(s) == 0) return 0;
+    if (_try_take(s, 0) == 0) return 0;
 
     /* Block current task */
     int me = hrt__get_current();
@@ -94,11 +146,19 @@ int hrt_sem_take(hrt_sem_t *s) {
 
     hrt_port_crit_enter();
 
-    /* Re-check after taking CS */
-    if (s->count) {
-        s->count--;
-        hrt_port_crit_exit();
-        return 0;
+    /* Re-check after taking CS, then flag the queue so gives take the slow path.
+       The flag goes in with a CAS from zero: a deferred-mode ISR stores lock-free
+       even inside the CS, and a token it adds meanwhile is claimed, not lost. */
+    uint32_t c = 0;
+    while (!__atomic_compare_exchange_n(&s->count, &c, HRT_SEM_WAITERS, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        if (c & HRT_SEM_WAITERS) break; /* an earlier waiter already flagged it */
+        if (_claim(s) == 0) {
+            HRT_OBJ_OP(s);
+            HRT_TRACE(HRT_EV_SEM_TAKE, HRT_TRACE_OBJ(s));
+            hrt_port_crit_exit();
+            return 0;
+        }
+        c = 0;
     }
 
     /* Put current into the semaphore wait queue and mark blocked */
@@ -113,25 +173,38 @@ int hrt_sem_take(hrt_sem_t *s) {
 #endif
 
     t->state = HRT_BLOCKED;
+    HRT_TRACE(HRT_EV_BLOCK, HRT_TRACE_OBJ(s));
 
     /* Request rescheduling and yield to scheduler from the task context */
     extern void hrt_port_yield_to_scheduler(void);
 
+    const uint32_t since = HRT_OBJ_CLOCK();
     hrt_port_crit_exit();
 
     hrt__pend_context_switch();
     hrt_port_yield_to_scheduler();
 
     /* When we resume, we must have been given the semaphore. */
+#if HARDRT_OBJ_STATS == 1
+    hrt_port_crit_enter();
+    HRT_OBJ_OP(s);
+    HRT_OBJ_WAITED(s, HRT_OBJ_CLOCK() - since);
+    hrt_port_crit_exit();
+#else
+    (void) since;
+#endif
+    HRT_TRACE(HRT_EV_SEM_TAKE, HRT_TRACE_OBJ(s));
     return 0;
 }
 
-static int _give_common(hrt_sem_t *s, int is_isr, int *need_switch) {
+/* Hand the token to the first waiter or store it; caller holds the CS. Returns 1 if a task woke. */
+static int _give_cs(hrt_sem_t *s) {
     int woken = 0;
 
-    hrt_port_crit_enter();
+    HRT_TRACE(HRT_EV_SEM_GIVE, HRT_TRACE_OBJ(s));
 
     int waiter = _waitq_pop(s);
+    if (s->count_wait == 0) s->count &= ~HRT_SEM_WAITERS; /* last waiter left: gives may store again */
     if (waiter >= 0) {
         /* Wake exactly one waiter */
         _hrt_tcb_t *tw = hrt__tcb(waiter);
@@ -147,23 +220,30 @@ static int _give_common(hrt_sem_t *s, int is_isr, int *need_switch) {
         printf("[sem] give: woke waiter %d\n", waiter);
 #endif
     } else {
-        /* No waiter: store a token, saturating at max_count */
-        if (s->count < s->max_count) {
-            s->count++;
-        }
+        /* No waiter: store a token, saturating at max_count, and tell the set if any */
+        (void) _store(s);
+        woken = hrt__select_notify(s->sel) >= 0;
 #ifdef HARDRT_TEST_HOOKS
         printf("[sem] give: no waiters, count=%u (max=%u)\n", (unsigned)s->count, (unsigned)s->max_count);
 #endif
     }
+    return woken;
+}
 
-    hrt_port_crit_exit();
+static int _give_common(hrt_sem_t *s, int is_isr, int *need_switch) {
+    int woken = 0;
+    /* A set member gives under the CS, so the set's waiter is woken with the token */
+    if (SEM_LOCKFREE && !s->sel && _store(s) == 0) {
+        HRT_TRACE(HRT_EV_SEM_GIVE, HRT_TRACE_OBJ(s));
+    } else {
+        hrt_port_crit_enter();
+        woken = _give_cs(s);
+        hrt_port_crit_exit();
+    }
 
     if (is_isr) {
         if (need_switch) *need_switch = woken;
-        if (woken) {
-
-            hrt__pend_context_switch();
-        }
+        if (woken) hrt__isr_pend();
     } else {
         if (woken) {
             /* Requeue the current task appropriately and yield, similar to hrt_yield().
@@ -181,5 +261,29 @@ int hrt_sem_give(hrt_sem_t *s) {
 }
 
 int hrt_sem_give_from_isr(hrt_sem_t *s, int *need_switch) {
+#if HARDRT_ISR_DEFER == 1
+    /* With no task queued the token is stored lock-free (the CAS needs no CS, even
+       with OBJ_STATS); only a give that must wake someone is posted, and
+       hrt__sem_post_apply() runs it at the next switch point. */
+    if (!s->sel && _store(s) == 0) {
+        HRT_TRACE(HRT_EV_SEM_GIVE, HRT_TRACE_OBJ(s));
+        if (need_switch) *need_switch = 0;
+        return 0;
+    }
+    if (hrt__isr_post(HRT__POST_SEM_GIVE, s) == 0) {
+        if (need_switch) *need_switch = 1;
+        return 0;
+    }
+    /* Ring full: give directly, as without deferral */
+#endif
     return _give_common(s, 1, need_switch);
-}
\ No newline at end of file
+}
+
+#if HARDRT_ISR_DEFER == 1
+/* Drain side of a deferred give; the switch point that runs it picks up a woken task */
+void hrt__sem_post_apply(hrt_sem_t *s) {
+    hrt_port_crit_enter();
+    (void) _give_cs(s);
+    hrt_port_crit_exit();
+}
+#endif
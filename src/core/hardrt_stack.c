@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <string.h>
+
+#include "hardrt.h"
+#include "hardrt_stack.h"
+#include "hardrt_port_int.h"
+
+#if HARDRT_STACK_CHECK == 1
+
+static hrt_stack_hook_fn g_stk_hook = NULL;
+static uint32_t g_stk_min = 0;
+static uint32_t g_stk_last_scan = 0;
+static uint8_t g_stk_reported[HARDRT_MAX_TASKS];
+
+void hrt__stack_paint(uint32_t *base, const size_t words) {
+    for (size_t i = 0; i < words; ++i) base[i] = HARDRT_STACK_PAINT;
+}
+
+void hrt__stack_reset(void) {
+    g_stk_hook = NULL;
+    g_stk_min = 0;
+    g_stk_last_scan = hrt_tick_now();
+    memset(g_stk_reported, 0, sizeof(g_stk_reported));
+}
+
+/* Stacks grow down on every supported port: untouched words sit at the base */
+static uint32_t _unused_words(const _hrt_tcb_t *t) {
+    const uint32_t *p = t->stack_base;
+    uint32_t n = 0;
+    while (n < t->stack_words && p[n] == HARDRT_STACK_PAINT) n++;
+    return n;
+}
+
+int32_t hrt_task_stack_unused(const int id) {
+    if (id < 0 || id >= HARDRT_MAX_TASKS) return -1;
+    const _hrt_tcb_t *t = hrt__tcb(id);
+    if (!t->stack_base || (t->state == HRT_UNUSED && id != HRT_IDLE_ID)) return -1;
+    return (int32_t) _unused_words(t);
+}
+
+void hrt_stack_set_hook(const hrt_stack_hook_fn fn, const uint32_t min_unused_words) {
+    g_stk_hook = fn;
+    g_stk_min = min_unused_words;
+    memset(g_stk_reported, 0, sizeof(g_stk_reported));
+}
+
+void hrt__stack_idle_check(void) {
+    if (!g_stk_hook) return;
+    const uint32_t now = hrt_tick_now();
+    if ((uint32_t) (now - g_stk_last_scan) < HARDRT_STACK_CHECK_PERIOD_TICKS) return;
+    g_stk_last_scan = now;
+
+    for (int i = 0; i < HARDRT_MAX_TASKS; ++i) {
+        if (g_stk_reported[i]) continue;
+        const int32_t unused = hrt_task_stack_unused(i);
+        if (unused >= 0 && (uint32_t) unused < g_stk_min) {
+            g_stk_reported[i] = 1;
+            g_stk_hook(i, (uint32_t) unused);
+        }
+    }
+}
+
+#else /* HARDRT_STACK_CHECK == 0 */
+
+int32_t hrt_task_stack_unused(const int id) {
+    (void) id;
+    return -1;
+}
+
+void hrt_stack_set_hook(const hrt_stack_hook_fn fn, const uint32_t min_unused_words) {
+    (void) fn; (void) min_unused_words;
+}
+
+#endif
@@ -0,0 +1,148 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <string.h>
+
+#include "hardrt.h"
+#include "hardrt_port.h"
+#include "hardrt_stats.h"
+#include "hardrt_port_int.h"
+
+#if HARDRT_STATS == 1
+
+/* Who the accounting clock is currently charging: task id, HRT_IDLE_ID, or -1 before start */
+static int g_st_running = -1;
+static uint32_t g_st_last = 0;
+static uint8_t g_st_yield = 0;
+
+static uint64_t g_st_run = 0;
+static uint64_t g_st_idle = 0;
+static uint32_t g_st_switches = 0;
+
+/* Load window */
+static uint32_t g_st_win_tick = 0;
+static uint64_t g_st_win_run = 0;
+static uint64_t g_st_win_idle = 0;
+static uint16_t g_st_load = 0;
+
+void hrt__stats_reset(void) {
+    g_st_running = -1;
+    g_st_last = hrt_port_cycles();
+    g_st_yield = 0;
+    g_st_run = g_st_idle = 0;
+    g_st_switches = 0;
+    g_st_win_tick = hrt_tick_now();
+    g_st_win_run = g_st_win_idle = 0;
+    g_st_load = 0;
+}
+
+/* Charge elapsed counter time to whoever is running. Caller masks the tick. */
+static void _charge(void) {
+    const uint32_t now = hrt_port_cycles();
+    const uint32_t delta = now - g_st_last;
+    g_st_last = now;
+
+    if (g_st_running == HRT_IDLE_ID) {
+        g_st_idle += delta;
+    } else if (g_st_running >= 0) {
+        hrt__tcb(g_st_running)->st_run_cycles += delta;
+        g_st_run += delta;
+    }
+}
+
+void hrt__stats_yield(void) {
+    g_st_yield = 1;
+}
+
+void hrt__stats_switch(const int next) {
+    _charge();
+
+    const int prev = g_st_running;
+    if (next != prev) {
+        if (prev >= 0 && prev != HRT_IDLE_ID) {
+            _hrt_tcb_t *t = hrt__tcb(prev);
+            if (t->state == HRT_READY && !g_st_yield) {
+                t->st_preempted++;
+            } else {
+                t->st_voluntary++;
+            }
+        }
+        if (next != HRT_IDLE_ID) {
+            hrt__tcb(next)->st_switches_in++;
+            g_st_switches++;
+        }
+        g_st_running = next;
+    }
+    g_st_yield = 0;
+}
+
+static uint16_t _permille(const uint64_t part, const uint64_t whole) {
+    if (whole == 0) return 0;
+    const uint64_t p = (part * 1000u) / whole;
+    return (uint16_t) (p > 1000u ? 1000u : p);
+}
+
+void hrt__stats_tick(void) {
+    /* Charge on every tick, not just per window: the 32-bit counter wraps (every
+       ~4.29 s on the POSIX ns clock) and a delta spanning a wrap would be lost. */
+    _charge();
+    if ((uint32_t) (hrt_tick_now() - g_st_win_tick) < HARDRT_STATS_WINDOW_TICKS) return;
+    g_st_win_tick = hrt_tick_now();
+
+    const uint64_t run = g_st_run - g_st_win_run;
+    const uint64_t idle = g_st_idle - g_st_win_idle;
+    const uint64_t total = run + idle;
+    g_st_win_run = g_st_run;
+    g_st_win_idle = g_st_idle;
+    g_st_load = _permille(run, total);
+
+    for (int i = 0; i < HARDRT_MAX_TASKS; ++i) {
+        _hrt_tcb_t *t = hrt__tcb(i);
+        if (t->state == HRT_UNUSED) continue;
+        t->st_load_permille = _permille(t->st_run_cycles - t->st_win_cycles, total);
+        t->st_win_cycles = t->st_run_cycles;
+    }
+}
+
+int hrt_task_stats(const int id, hrt_task_stats_t *out) {
+    if (!out || id < 0 || id >= HARDRT_MAX_TASKS) return -1;
+    const _hrt_tcb_t *t = hrt__tcb(id);
+    if (t->state == HRT_UNUSED) return -1;
+
+    hrt_port_crit_enter();
+    _charge();
+    out->run_cycles = t->st_run_cycles;
+    out->switches_in = t->st_switches_in;
+    out->preempted = t->st_preempted;
+    out->voluntary = t->st_voluntary;
+    out->load_permille = t->st_load_permille;
+    hrt_port_crit_exit();
+    return 0;
+}
+
+int hrt_sys_stats(hrt_sys_stats_t *out) {
+    if (!out) return -1;
+
+    hrt_port_crit_enter();
+    _charge();
+    out->run_cycles = g_st_run;
+    out->idle_cycles = g_st_idle;
+    out->context_switches = g_st_switches;
+    out->cycles_hz = hrt_port_cycles_hz();
+    out->load_permille = g_st_load;
+    hrt_port_crit_exit();
+    return 0;
+}
+
+#else /* HARDRT_STATS == 0 */
+
+int hrt_task_stats(const int id, hrt_task_stats_t *out) {
+    (void) id;
+    if (out) memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+int hrt_sys_stats(hrt_sys_stats_t *out) {
+    if (out) memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+#endif
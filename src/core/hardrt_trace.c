@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#include <string.h>
+
+#include "hardrt.h"
+#include "hardrt_port.h"
+#include "hardrt_trace.h"
+#include "hardrt_port_int.h"
+
+#if HARDRT_TRACE == 1
+
+#if (HARDRT_TRACE_EVENTS & (HARDRT_TRACE_EVENTS - 1u)) != 0 || HARDRT_TRACE_EVENTS == 0
+#error "HARDRT_TRACE_EVENTS must be a power of two"
+#endif
+
+/* Ring and write index; exposed (non-static) so a debugger can dump them from a halted target */
+hrt_trace_rec_t hrt_trace_buf[HARDRT_TRACE_EVENTS];
+volatile uint32_t hrt_trace_head = 0;
+static volatile uint8_t g_tr_on = 0;
+static int g_tr_running = -1; /* last task traced as switched in */
+
+void hrt__trace(const uint8_t ev, const int task, const uint16_t arg) {
+    if (!g_tr_on) return;
+    /* Reserve a slot first: a nested ISR gets its own slot, no lock needed */
+    const uint32_t i = __atomic_fetch_add(&hrt_trace_head, 1u, __ATOMIC_RELAXED);
+    hrt_trace_rec_t *r = &hrt_trace_buf[i & (HARDRT_TRACE_EVENTS - 1u)];
+    r->ts = hrt_port_cycles();
+    r->ev = ev;
+    r->task = (uint8_t) task;
+    r->arg = arg;
+}
+
+void hrt__trace_switch(const int next) {
+    if (next == g_tr_running) return;
+    if (g_tr_running >= 0) hrt__trace(HRT_EV_SWITCH_OUT, g_tr_running, 0);
+    hrt__trace(HRT_EV_SWITCH_IN, next, 0);
+    g_tr_running = next;
+}
+
+void hrt__trace_reset(void) {
+    hrt_trace_head = 0;
+    g_tr_running = -1;
+    g_tr_on = 1;
+}
+
+void hrt_trace_enable(const int on) {
+    g_tr_on = (uint8_t) (on != 0);
+}
+
+void hrt_trace_clear(void) {
+    hrt_port_crit_enter();
+    hrt_trace_head = 0;
+    hrt_port_crit_exit();
+}
+
+void hrt_trace_user(const uint16_t arg) {
+    HRT_TRACE(HRT_EV_USER, arg);
+}
+
+uint32_t hrt_trace_snapshot(hrt_trace_hdr_t *hdr, hrt_trace_rec_t *dst, const uint32_t max) {
+    hrt_port_crit_enter();
+    const uint32_t head = hrt_trace_head;
+    uint32_t avail = head < HARDRT_TRACE_EVENTS ? head : HARDRT_TRACE_EVENTS;
+    const uint32_t lost_ring = head - avail;
+
+    uint32_t n = 0;
+    if (dst) {
+        n = avail < max ? avail : max;
+        for (uint32_t k = 0; k < n; ++k) {
+            dst[k] = hrt_trace_buf[(head - n + k) & (HARDRT_TRACE_EVENTS - 1u)];
+        }
+    }
+    hrt_port_crit_exit();
+
+    if (hdr) {
+        hdr->magic = HRT_TRACE_MAGIC;
+        hdr->version = HRT_TRACE_VERSION;
+        hdr->rec_size = (uint16_t) sizeof(hrt_trace_rec_t);
+        hdr->cycles_hz = hrt_port_cycles_hz();
+        hdr->count = dst ? n : avail;
+        hdr->lost = lost_ring + (dst ? avail - n : 0u);
+    }
+    return n;
+}
+
+#else /* HARDRT_TRACE == 0 */
+
+void hrt_trace_enable(const int on) { (void) on; }
+
+void hrt_trace_clear(void) {}
+
+void hrt_trace_user(const uint16_t arg) { (void) arg; }
+
+uint32_t hrt_trace_snapshot(hrt_trace_hdr_t *hdr, hrt_trace_rec_t *dst, const uint32_t max) {
+    (void) dst; (void) max;
+    if (hdr) memset(hdr, 0, sizeof(*hdr));
+    return 0;
+}
+
+#endif
@@ -1,5 +1,6 @@
 
 .extern hrt__schedule
+.weak   hrt__isr_drain   @ only defined when HARDRT_ISR_DEFER=1; resolves to 0 otherwise
 
 .syntax unified
 .thumb
@@ -12,6 +13,9 @@
  * Contract with C side:
  *   - uint32_t hrt__schedule(uint32_t old_sp):
  *       Saves the updated PSP (after pushing r4-r11) into the current TCB ,returns next sp.
+ *   - void hrt__isr_drain(void) (HARDRT_ISR_DEFER only):
+ *       Applies deferred ISR posts. Called first, with interrupts still enabled, so the
+ *       kernel work ISRs handed over runs at PendSV priority instead of under cpsid.
  *
  * Stack layout expected when switching OUT of a running task:
  *   [high addr]
@@ -35,6 +39,13 @@
  */
 
 PendSV_Handler:
+    ldr     r0, =hrt__isr_drain
+    cbz     r0, switch_begin @ deferral not linked in
+    push    {r4, lr}         @ keep EXC_RETURN; r4 keeps the stack 8-byte aligned
+    blx     r0
+    pop     {r4, lr}
+
+switch_begin:
     cpsid   i
 
     mrs     r0, psp          @ r0 = old PSP, or 0 on first switch?
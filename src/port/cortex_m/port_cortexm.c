@@ -41,6 +41,13 @@ extern uint8_t __RAM_END__;
 #define SysTick             ((SysTick_Type *) SysTick_BASE)
 #define SCB                 ((SCB_Type *)     SCB_BASE)
 
+/* DWT cycle counter (ARMv7-M); enabled through CoreDebug DEMCR.TRCENA */
+#define HRT_DEMCR               (*(volatile uint32_t *) 0xE000EDFCUL)
+#define HRT_DWT_CTRL            (*(volatile uint32_t *) 0xE0001000UL)
+#define HRT_DWT_CYCCNT          (*(volatile uint32_t *) 0xE0001004UL)
+#define HRT_DEMCR_TRCENA        (1UL << 24)
+#define HRT_DWT_CTRL_CYCCNTENA  (1UL << 0)
+
 /* SCB->ICSR bits */
 #define SCB_ICSR_PENDSVSET_Msk   (1UL << 28)
 
@@ -132,6 +139,7 @@ void hrt_port_crit_enter(void){
         g_basepri_prev = prev;            /* save only on outermost enter */
         _set_BASEPRI(_prio_to_basepri(HARDRT_MAX_SYSCALL_IRQ_PRIO));               /* raise BASEPRI threshold */
         _hrt_port_barrier();
+        HRT_IRQOFF_BEGIN(HRT_IRQOFF_CRIT, __builtin_return_address(0));
     }
     g_cs_nest++;
 }
@@ -143,6 +151,7 @@ void hrt_port_crit_exit(void){
     }
     g_cs_nest--;
     if (g_cs_nest == 0u) {
+        HRT_IRQOFF_END(HRT_IRQOFF_CRIT);
         /* restore previous threshold on outermost exit */
         _set_BASEPRI(g_basepri_prev);
         //__asm volatile("dsb sy\nisb");
@@ -159,6 +168,7 @@ void hrt_port_idle_wait(void){
 static void hrt_idle_task(void *arg) {
     (void)arg;
     for (;;) {
+        HRT_STACK_IDLE_CHECK();
         hrt_port_idle_wait();
     }
 }
@@ -174,6 +184,11 @@ void hrt__init_idle_task(void)
     g_idle_tcb.entry         = hrt_idle_task;
     g_idle_tcb.arg           = NULL;
 
+    // Paint and register the idle stack so hrt_task_stack_unused(HRT_IDLE_ID) can report it
+    HRT_STACK_PAINT_WORDS(g_idle_stack, HARDRT_IDLE_STACK_WORDS);
+    hrt__tcb(HRT_IDLE_ID)->stack_base  = g_idle_stack;
+    hrt__tcb(HRT_IDLE_ID)->stack_words = HARDRT_IDLE_STACK_WORDS;
+
     // Build initial stack frame exactly like hrt_create_task does:
     uint32_t *sp = &g_idle_stack[HARDRT_IDLE_STACK_WORDS];
 
@@ -217,8 +232,23 @@ void hrt_port_yield_to_scheduler(void){
     /* execution continues; the switch happens at exception return */
 }
 
+/* -------- Accounting counter (DWT->CYCCNT) -------- */
+uint32_t hrt_port_cycles(void) {
+    return HRT_DWT_CYCCNT;
+}
+
+uint32_t hrt_port_cycles_hz(void) {
+    return hrt_port_get_core_hz();
+}
+
 /* -------- Start SysTick at requested Hz -------- */
 void hrt_port_start_systick(uint32_t tick_hz){
+#if HARDRT_STATS == 1 || HARDRT_TRACE == 1 || HARDRT_LATENCY == 1 || HARDRT_OBJ_STATS == 1 || HARDRT_IRQOFF == 1
+    /* Free-running cycle counter for hrt_port_cycles() */
+    HRT_DEMCR |= HRT_DEMCR_TRCENA;
+    HRT_DWT_CYCCNT = 0;
+    HRT_DWT_CTRL |= HRT_DWT_CTRL_CYCCNTENA;
+#endif
     if (!tick_hz) return;
     /* If EXTERNAL tick mode, bypass here in that case. */
     if (hrt__cfg_tick_src() == HRT_TICK_EXTERNAL) {
@@ -16,6 +16,8 @@
    - If a port has a scheduler loop, it should call `hrt__on_scheduler_entry()`
      right after returning from a task back to the scheduler context, where it is
      safe to rotate a time-sliced task to the tail of its ready queue.
+   - With HARDRT_ISR_DEFER, a port calls `HRT_ISR_DRAIN()` at every switch point before
+     picking the next task, from a context ISRs can still preempt.
 */
 
 
@@ -26,11 +28,34 @@ void hrt_port_enter_scheduler(void) {
     /* No scheduler in null port; hrt_start() returns immediately. */
 }
 
+/* Virtual-time driver: nothing to run on the null port, time does not move. */
+uint32_t hrt_sim_run_for(const uint32_t ticks) {
+    (void) ticks;
+    return hrt_tick_now();
+}
+
+uint32_t hrt_sim_step(void) {
+    return hrt_tick_now();
+}
+
+void hrt_sim_consume(const uint32_t ticks) {
+    (void) ticks;
+}
+
 void hrt_port_start_systick(const uint32_t tick_hz) {
     (void) tick_hz;
     /* No timer. Real ports will start a tick source and call hrt_tick_from_isr(). */
 }
 
+/* No counter: accounting reads stay at zero. */
+uint32_t hrt_port_cycles(void) {
+    return 0;
+}
+
+uint32_t hrt_port_cycles_hz(void) {
+    return 0;
+}
+
 void hrt_port_idle_wait(void) {
     /* Nothing. Real ports could WFI or sleep. */
 }
@@ -1,17 +1,68 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 #define _XOPEN_SOURCE 700
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS */
+#if defined(HARDRT_POSIX_PROF) && HARDRT_POSIX_PROF == 1
+#define _GNU_SOURCE /* dladdr */
+#endif
 #include <ucontext.h>
 #include <signal.h>
 #include <sys/time.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
-#include <time.h>   /* nanosleep */
+#include <time.h>   /* nanosleep, clock_gettime */
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "hardrt.h"
 #include "hardrt_time.h"
+#include "hardrt_posix.h"
 #include "hardrt_port_int.h"
 
+#if HARDRT_POSIX_IRQ_LINES > 32
+#error "HARDRT_POSIX_IRQ_LINES must be <= 32"
+#endif
+
+#ifndef HARDRT_POSIX_GUARD_PAGES
+#define HARDRT_POSIX_GUARD_PAGES 0
+#endif
+
+#ifndef HARDRT_POSIX_PERF
+#define HARDRT_POSIX_PERF 0
+#endif
+
+#if HARDRT_POSIX_PERF == 1
+#include <stdlib.h>          /* atexit */
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#ifndef HARDRT_POSIX_PROF
+#define HARDRT_POSIX_PROF 0
+#endif
+
+#ifndef HARDRT_POSIX_SHM
+#define HARDRT_POSIX_SHM 0
+#endif
+
+#if HARDRT_POSIX_SHM == 1
+#include <stdlib.h>          /* atexit, getenv */
+#include <fcntl.h>           /* O_* for shm_open */
+#include <sys/stat.h>
+#include "hardrt_sem.h"
+#include "hardrt_mutex.h"
+#include "hardrt_queue.h"
+#endif
+
+#if HARDRT_POSIX_PROF == 1
+#include <stdlib.h>          /* atexit, getenv, qsort */
+#include <errno.h>
+#include <dlfcn.h>           /* dladdr */
+#include <execinfo.h>        /* backtrace */
+#include <sys/syscall.h>
+#endif
+
 
 static int g_crit_depth = 0;
 static sigset_t g_saved_mask;
@@ -25,6 +76,10 @@ void hrt__make_ready(int id);
 
 void hrt__on_scheduler_entry(void);
 
+void hrt__requeue_noreset(int id);
+
+hrt_policy_t hrt__policy(void);
+
 int hrt__get_current(void);
 
 void hrt__set_current(int id);
@@ -37,12 +92,39 @@ typedef struct {
     void *stk_ptr;
     size_t stk_bytes;
     int valid;
+    void *map;        /* guard-page mode: PROT_NONE page followed by the stack */
+    size_t map_bytes;
 } _port_ctx_t;
 
 static _port_ctx_t g_ctxs[HARDRT_MAX_TASKS];
 static ucontext_t g_sched_ctx;
 static volatile sig_atomic_t g_switch_pending = 0;
 static sigset_t g_sigalrm_set;
+static sigset_t g_switch_set; /* SIGALRM + IRQ signal: masked on the switch path */
+
+/* Tick and IRQ handlers run on their own stack, like the Cortex-M MSP, so task
+ * stacks never have to absorb a signal frame (several KB with AVX-512 state). */
+#define HRT_SIG_STACK_BYTES (64u * 1024u)
+static uint8_t g_sig_stack[HRT_SIG_STACK_BYTES] __attribute__((aligned(16)));
+
+/* ---- Simulated interrupt controller (virtual NVIC) state ---- */
+#define HRT_IRQ_SIGNAL       SIGUSR2
+#define HRT_IRQ_PRIO_THREAD  0xFFu   /* "active priority" while in thread mode */
+
+typedef struct {
+    hrt_posix_irq_fn fn;
+    void *arg;
+    uint8_t prio;
+    volatile uint8_t enabled;
+    volatile uint64_t raised_ns;
+} _irq_line_t;
+
+static _irq_line_t g_irq[HARDRT_POSIX_IRQ_LINES];
+static volatile uint32_t g_irq_pending = 0;                 /* one bit per line */
+static volatile uint32_t g_irq_active = HRT_IRQ_PRIO_THREAD; /* priority being serviced */
+static sigset_t g_irq_set;
+static pthread_t g_kernel_thread;
+static volatile int g_irq_ready = 0;
 
 #ifdef HARDRT_TEST_HOOKS
  static volatile sig_atomic_t g_test_stop = 0;
@@ -80,15 +162,780 @@ static sigset_t g_sigalrm_set;
  uint32_t hrt__test_get_tick(void);
  #endif
 
-/* ---- Helpers to mask/unmask SIGALRM around critical regions ---- */
+/* ---- Helpers to mask/unmask the tick and IRQ signals around a context switch ----
+ * A masked window may close in another context: the task switched to unmasks it. */
 static inline void block_sigalrm(sigset_t *old) {
-    sigprocmask(SIG_BLOCK, &g_sigalrm_set, old);
+    sigprocmask(SIG_BLOCK, &g_switch_set, old);
+#if HARDRT_IRQOFF == 1
+    if (!sigismember(old, SIGALRM)) HRT_IRQOFF_BEGIN(HRT_IRQOFF_SWITCH, 0);
+#endif
 }
 
 static inline void unblock_sigalrm(const sigset_t *old) {
+#if HARDRT_IRQOFF == 1
+    if (!sigismember(old, SIGALRM)) HRT_IRQOFF_END(HRT_IRQOFF_SWITCH);
+#endif
     sigprocmask(SIG_SETMASK, old, NULL);
 }
 
+/* ---- Simulated interrupt controller ----
+ * Each line has a priority (0 most urgent). A pending, enabled line is taken
+ * when its priority beats both the active handler (nesting) and, inside a
+ * kernel critical section, HARDRT_MAX_SYSCALL_IRQ_PRIO (BASEPRI). Handlers
+ * run in the context of a signal delivered to the kernel thread. Like the
+ * tick, they only pend a switch; the port never swaps contexts from them. */
+static int _irq_pick(void) {
+    uint32_t thr = g_irq_active;
+    if (g_crit_depth > 0 && HARDRT_MAX_SYSCALL_IRQ_PRIO < thr) thr = HARDRT_MAX_SYSCALL_IRQ_PRIO;
+
+    const uint32_t pend = __atomic_load_n(&g_irq_pending, __ATOMIC_ACQUIRE);
+    int best = -1;
+    for (int i = 0; i < HARDRT_POSIX_IRQ_LINES; ++i) {
+        const _irq_line_t *l = &g_irq[i];
+        if (!(pend & (1u << i)) || !l->enabled || !l->fn) continue;
+        if (l->prio < thr) {
+            thr = l->prio;
+            best = i;
+        }
+    }
+    return best;
+}
+
+static void _irq_dispatch(void) {
+    sigset_t entry;
+    pthread_sigmask(SIG_BLOCK, &g_irq_set, &entry);
+    for (;;) {
+        const int line = _irq_pick();
+        if (line < 0) break;
+        const _irq_line_t *l = &g_irq[line];
+        __atomic_fetch_and(&g_irq_pending, ~(1u << line), __ATOMIC_ACQ_REL);
+
+        const uint32_t prev = g_irq_active;
+        g_irq_active = l->prio;
+
+        /* Let more urgent lines nest; hold off the tick if we outrank it */
+        sigset_t run = entry;
+        sigdelset(&run, HRT_IRQ_SIGNAL);
+        if (l->prio < HARDRT_POSIX_TICK_IRQ_PRIO) sigaddset(&run, SIGALRM);
+        pthread_sigmask(SIG_SETMASK, &run, NULL);
+
+        HRT_TRACE(HRT_EV_ISR_ENTER, line);
+        l->fn(line, l->arg);
+        HRT_TRACE(HRT_EV_ISR_EXIT, line);
+
+        pthread_sigmask(SIG_BLOCK, &g_irq_set, NULL);
+        g_irq_active = prev;
+    }
+    pthread_sigmask(SIG_SETMASK, &entry, NULL);
+}
+
+static void _irq_sighandler(const int signo) {
+    (void) signo;
+    _irq_dispatch();
+}
+
+static void _irq_init(void) {
+    const stack_t ss = {.ss_sp = g_sig_stack, .ss_size = sizeof(g_sig_stack), .ss_flags = 0};
+    sigaltstack(&ss, NULL);
+
+    memset(g_irq, 0, sizeof(g_irq));
+    g_irq_pending = 0;
+    g_irq_active = HRT_IRQ_PRIO_THREAD;
+
+    sigemptyset(&g_irq_set);
+    sigaddset(&g_irq_set, HRT_IRQ_SIGNAL);
+    g_kernel_thread = pthread_self();
+
+    struct sigaction sa = {0};
+    sa.sa_handler = _irq_sighandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART | SA_ONSTACK;
+    sigaction(HRT_IRQ_SIGNAL, &sa, NULL);
+    g_irq_ready = 1;
+}
+
+int hrt_posix_irq_attach(const int line, const uint8_t prio, const hrt_posix_irq_fn fn, void *arg) {
+    if (line < 0 || line >= HARDRT_POSIX_IRQ_LINES || prio >= HRT_POSIX_IRQ_PRIO_LEVELS) return -1;
+    sigset_t old;
+    pthread_sigmask(SIG_BLOCK, &g_irq_set, &old);
+    g_irq[line].fn = fn;
+    g_irq[line].arg = arg;
+    g_irq[line].prio = prio;
+    g_irq[line].enabled = (fn != NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    return 0;
+}
+
+int hrt_posix_irq_enable(const int line, const int enable) {
+    if (line < 0 || line >= HARDRT_POSIX_IRQ_LINES) return -1;
+    g_irq[line].enabled = (uint8_t) (enable ? 1 : 0);
+    /* Re-deliver anything that was held pending while disabled */
+    if (enable && g_irq_ready && (g_irq_pending & (1u << line))) {
+        pthread_kill(g_kernel_thread, HRT_IRQ_SIGNAL);
+    }
+    return 0;
+}
+
+int hrt_posix_irq_raise(const int line) {
+    if (line < 0 || line >= HARDRT_POSIX_IRQ_LINES || !g_irq_ready) return -1;
+    const uint32_t bit = 1u << line;
+    if (!(__atomic_load_n(&g_irq_pending, __ATOMIC_ACQUIRE) & bit)) {
+        g_irq[line].raised_ns = hrt_posix_now_ns();
+    }
+    __atomic_fetch_or(&g_irq_pending, bit, __ATOMIC_ACQ_REL);
+    pthread_kill(g_kernel_thread, HRT_IRQ_SIGNAL);
+    return 0;
+}
+
+uint64_t hrt_posix_irq_raised_ns(const int line) {
+    if (line < 0 || line >= HARDRT_POSIX_IRQ_LINES) return 0;
+    return g_irq[line].raised_ns;
+}
+
+void hrt_posix_host_thread_init(void) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGALRM);
+    sigaddset(&set, HRT_IRQ_SIGNAL);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+}
+
+int hrt_posix_irq_active_prio(void) {
+    return (g_irq_active == HRT_IRQ_PRIO_THREAD) ? -1 : (int) g_irq_active;
+}
+
+uint64_t hrt_posix_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+/* Accounting counter: monotonic nanoseconds, truncated (deltas are wrap-safe) */
+uint32_t hrt_port_cycles(void) {
+    return (uint32_t) hrt_posix_now_ns();
+}
+
+uint32_t hrt_port_cycles_hz(void) {
+    return 1000000000u;
+}
+
+int hrt_posix_trace_dump(const char *path) {
+#if HARDRT_TRACE == 1
+    static hrt_trace_rec_t recs[HARDRT_TRACE_EVENTS];
+    hrt_trace_hdr_t hdr;
+    const uint32_t n = hrt_trace_snapshot(&hdr, recs, HARDRT_TRACE_EVENTS);
+
+    FILE *f = path ? fopen(path, "wb") : NULL;
+    if (!f) return -1;
+    const int ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+                   fwrite(recs, sizeof(recs[0]), n, f) == n;
+    if (fclose(f) != 0 || !ok) return -1;
+    return (int) n;
+#else
+    (void) path;
+    return -1;
+#endif
+}
+
+/* ---- perf_event counters ----
+ * One counter group on the kernel thread, counting user space only. Every
+ * switch reads the group in one syscall and charges the delta to the task
+ * that was running; HRT_IDLE_ID collects the scheduler and idle path. */
+#if HARDRT_POSIX_PERF == 1
+static const struct {
+    uint32_t type;
+    uint64_t config;
+    const char *name;
+} k_perf_events[HRT_POSIX_PERF_EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache-misses"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch-misses"},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task-clock-ns"},
+};
+
+static int g_perf_leader = -1;
+static int g_perf_tried = 0;
+static int g_perf_nslots = 0;
+static uint8_t g_perf_slot_ev[HRT_POSIX_PERF_EVENTS]; /* group read order -> event */
+static uint32_t g_perf_mask = 0;
+static uint64_t g_perf_last[HRT_POSIX_PERF_EVENTS];   /* by slot */
+static int g_perf_owner = -1;                          /* -1: host code, not charged */
+static hrt_posix_perf_t g_perf[HARDRT_MAX_TASKS];
+
+static int _perf_read(uint64_t *vals) {
+    uint64_t buf[1 + HRT_POSIX_PERF_EVENTS];
+    const ssize_t n = read(g_perf_leader, buf, sizeof(buf));
+    if (n < (ssize_t) sizeof(buf[0]) || buf[0] != (uint64_t) g_perf_nslots) return -1;
+    memcpy(vals, &buf[1], (size_t) g_perf_nslots * sizeof(buf[0]));
+    return 0;
+}
+
+static void _perf_write(FILE *f) {
+    fprintf(f, "hardrt perf (user space)\n%-6s %10s", "task", "runs");
+    for (int e = 0; e < HRT_POSIX_PERF_EVENTS; ++e) fprintf(f, " %14s", k_perf_events[e].name);
+    fprintf(f, "\n");
+    for (int i = 0; i < HARDRT_MAX_TASKS; ++i) {
+        const hrt_posix_perf_t *p = &g_perf[i];
+        if (p->runs == 0 && p->count[HRT_POSIX_PERF_TASK_CLOCK] == 0) continue;
+        if (i == HRT_IDLE_ID) fprintf(f, "%-6s", "idle");
+        else fprintf(f, "%-6d", i);
+        fprintf(f, " %10u", (unsigned) p->runs);
+        for (int e = 0; e < HRT_POSIX_PERF_EVENTS; ++e) {
+            if (g_perf_mask & (1u << e)) fprintf(f, " %14llu", (unsigned long long) p->count[e]);
+            else fprintf(f, " %14s", "-");
+        }
+        fprintf(f, "\n");
+    }
+}
+
+static void _perf_summary(void) {
+    _perf_write(stderr);
+}
+
+/* Open the group once per process; events the host lacks (e.g. no PMU in a VM) are left out */
+static void _perf_open(void) {
+    if (g_perf_tried) return;
+    g_perf_tried = 1;
+    for (int e = 0; e < HRT_POSIX_PERF_EVENTS; ++e) {
+        struct perf_event_attr a;
+        memset(&a, 0, sizeof(a));
+        a.size = sizeof(a);
+        a.type = k_perf_events[e].type;
+        a.config = k_perf_events[e].config;
+        a.exclude_kernel = 1;
+        a.exclude_hv = 1;
+        a.read_format = PERF_FORMAT_GROUP;
+        a.pinned = (g_perf_leader < 0); /* never multiplexed: deltas stay exact */
+        const int fd = (int) syscall(SYS_perf_event_open, &a, 0, -1, g_perf_leader, 0);
+        if (fd < 0) continue;
+        if (g_perf_leader < 0) g_perf_leader = fd;
+        g_perf_slot_ev[g_perf_nslots++] = (uint8_t) e;
+        g_perf_mask |= 1u << e;
+    }
+    if (g_perf_leader >= 0) atexit(_perf_summary);
+}
+
+static void _perf_switch(const int next) {
+    uint64_t now[HRT_POSIX_PERF_EVENTS];
+    if (g_perf_leader < 0 || _perf_read(now) != 0) return;
+    if (g_perf_owner >= 0) {
+        hrt_posix_perf_t *p = &g_perf[g_perf_owner];
+        for (int s = 0; s < g_perf_nslots; ++s) p->count[g_perf_slot_ev[s]] += now[s] - g_perf_last[s];
+    }
+    memcpy(g_perf_last, now, sizeof(now));
+    g_perf_owner = next;
+    if (next >= 0) g_perf[next].runs++;
+}
+
+#define HRT_PERF_SWITCH(next) _perf_switch(next)
+#else
+#define HRT_PERF_SWITCH(next) ((void) 0)
+#endif
+
+uint32_t hrt_posix_perf_available(void) {
+#if HARDRT_POSIX_PERF == 1
+    return g_perf_mask;
+#else
+    return 0u;
+#endif
+}
+
+int hrt_posix_perf_task(const int id, hrt_posix_perf_t *out) {
+#if HARDRT_POSIX_PERF == 1
+    if (id < 0 || id >= HARDRT_MAX_TASKS || !out) return -1;
+    *out = g_perf[id];
+    return 0;
+#else
+    (void) id;
+    (void) out;
+    return -1;
+#endif
+}
+
+void hrt_posix_perf_reset(void) {
+#if HARDRT_POSIX_PERF == 1
+    memset(g_perf, 0, sizeof(g_perf));
+    g_perf_owner = -1;
+#endif
+}
+
+int hrt_posix_perf_dump(const char *path) {
+#if HARDRT_POSIX_PERF == 1
+    if (!path) return -1;
+    FILE *f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!f) return -1;
+    _perf_write(f);
+    if (f != stdout && fclose(f) != 0) return -1;
+    return 0;
+#else
+    (void) path;
+    return -1;
+#endif
+}
+
+/* ---- SIGPROF sampling profiler ----
+ * A CPU-time timer on the kernel thread delivers SIGPROF to that thread only.
+ * The handler charges the sample to the context the port last switched to
+ * (hrt__get_current() lags while the scheduler idles) and stores the backtrace
+ * in a fixed hash table: no allocation in the handler. SIGPROF is masked with
+ * the tick on the switch path, so no sample unwinds a half-switched context. */
+#if HARDRT_POSIX_PROF == 1
+#define HRT_PROF_SKIP   2   /* _prof_sighandler and the sigreturn trampoline */
+#define HRT_PROF_HOST  (-1)
+
+typedef struct {
+    uint32_t count;         /* 0: free slot */
+    int16_t ctx;            /* task id, HRT_IDLE_ID or HRT_PROF_HOST */
+    uint16_t depth;
+    void *pc[HARDRT_POSIX_PROF_DEPTH];
+} _prof_stack_t;
+
+static _prof_stack_t g_prof[HARDRT_POSIX_PROF_STACKS];
+static uint32_t g_prof_ctx_samples[HARDRT_MAX_TASKS + 1]; /* last slot: host */
+static uint32_t g_prof_samples = 0;
+static uint32_t g_prof_dropped = 0;
+static uint32_t g_prof_nstacks = 0;
+static volatile int g_prof_ctx = HRT_PROF_HOST;
+static pid_t g_prof_tid = 0;
+static timer_t g_prof_timer;
+static int g_prof_armed = 0;
+static int g_prof_env_tried = 0;
+static const char *g_prof_env_path = NULL;
+
+static void _prof_record(const int ctx, void *const *pc, const int depth, const uint32_t weight) {
+    uint32_t h = 2166136261u ^ (uint32_t) (ctx + 1);
+    for (int i = 0; i < depth; ++i) h = (h ^ (uint32_t) ((uintptr_t) pc[i] >> 2)) * 16777619u;
+
+    g_prof_samples += weight;
+    g_prof_ctx_samples[ctx >= 0 ? ctx : HARDRT_MAX_TASKS] += weight;
+    for (uint32_t n = 0; n < HARDRT_POSIX_PROF_STACKS; ++n) {
+        _prof_stack_t *e = &g_prof[(h + n) % HARDRT_POSIX_PROF_STACKS];
+        if (e->count == 0) {
+            e->ctx = (int16_t) ctx;
+            e->depth = (uint16_t) depth;
+            memcpy(e->pc, pc, (size_t) depth * sizeof(pc[0]));
+            e->count = weight;
+            g_prof_nstacks++;
+            return;
+        }
+        if (e->ctx == ctx && e->depth == depth && memcmp(e->pc, pc, (size_t) depth * sizeof(pc[0])) == 0) {
+            e->count += weight;
+            return;
+        }
+    }
+    g_prof_dropped += weight;
+}
+
+static void _prof_sighandler(const int signo, siginfo_t *si, void *uc) {
+    (void) signo;
+    (void) uc;
+    const int saved_errno = errno;
+    void *pc[HARDRT_POSIX_PROF_DEPTH + HRT_PROF_SKIP];
+    const int n = backtrace(pc, HARDRT_POSIX_PROF_DEPTH + HRT_PROF_SKIP);
+    /* A CPU-time timer only fires on a scheduler tick; overruns carry the missed periods */
+    const uint32_t weight = 1u + (uint32_t) (si->si_overrun > 0 ? si->si_overrun : 0);
+    if (n > HRT_PROF_SKIP) _prof_record(g_prof_ctx, &pc[HRT_PROF_SKIP], n - HRT_PROF_SKIP, weight);
+    errno = saved_errno;
+}
+
+/* Symbol for one frame: exported name, else module+offset, else the raw address */
+static int _prof_frame(char *buf, const size_t len, void *pc, const int leaf) {
+    /* Return addresses point past the call; step back into the calling function */
+    const uintptr_t a = (uintptr_t) pc - (leaf ? 0u : 1u);
+    Dl_info di;
+    if (dladdr((void *) a, &di) && di.dli_sname) return snprintf(buf, len, "%s", di.dli_sname);
+    if (di.dli_fname && di.dli_fbase) {
+        const char *base = strrchr(di.dli_fname, '/');
+        return snprintf(buf, len, "%s+0x%lx", base ? base + 1 : di.dli_fname,
+                        (unsigned long) (a - (uintptr_t) di.dli_fbase));
+    }
+    return snprintf(buf, len, "0x%lx", (unsigned long) a);
+}
+
+typedef struct {
+    char *line;
+    uint32_t count;
+} _prof_line_t;
+
+static int _prof_line_cmp(const void *a, const void *b) {
+    return strcmp(((const _prof_line_t *) a)->line, ((const _prof_line_t *) b)->line);
+}
+
+/* Symbolise every stack, then merge stacks that resolve to the same frames */
+static int _prof_write(FILE *f) {
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGPROF);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+
+    const size_t line_max = 32u + (size_t) HARDRT_POSIX_PROF_DEPTH * 128u;
+    _prof_line_t *lines = calloc(g_prof_nstacks ? g_prof_nstacks : 1u, sizeof(*lines));
+    uint32_t n = 0;
+    int rc = lines ? 0 : -1;
+    for (uint32_t i = 0; rc == 0 && i < HARDRT_POSIX_PROF_STACKS; ++i) {
+        const _prof_stack_t *e = &g_prof[i];
+        if (e->count == 0) continue;
+        char *buf = malloc(line_max);
+        if (!buf) {
+            rc = -1;
+            break;
+        }
+        size_t off;
+        if (e->ctx == HRT_PROF_HOST) off = (size_t) snprintf(buf, line_max, "host");
+        else if (e->ctx == HRT_IDLE_ID) off = (size_t) snprintf(buf, line_max, "idle");
+        else off = (size_t) snprintf(buf, line_max, "task%d", e->ctx);
+        /* Folded stacks go root first; backtrace() gives the leaf first */
+        for (int d = e->depth - 1; d >= 0 && off + 2u < line_max; --d) {
+            buf[off++] = ';';
+            const int w = _prof_frame(buf + off, line_max - off, e->pc[d], d == 0);
+            if (w > 0) off += (size_t) w < line_max - off ? (size_t) w : line_max - off - 1u;
+        }
+        lines[n].line = buf;
+        lines[n].count = e->count;
+        n++;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (rc == 0) {
+        qsort(lines, n, sizeof(*lines), _prof_line_cmp);
+        for (uint32_t i = 0; i < n;) {
+            uint32_t total = 0;
+            uint32_t j = i;
+            while (j < n && strcmp(lines[j].line, lines[i].line) == 0) total += lines[j++].count;
+            if (fprintf(f, "%s %u\n", lines[i].line, (unsigned) total) < 0) rc = -1;
+            i = j;
+        }
+    }
+    for (uint32_t i = 0; lines && i < n; ++i) free(lines[i].line);
+    free(lines);
+    return rc;
+}
+
+static void _prof_env_dump(void) {
+    hrt_posix_prof_stop();
+    if (hrt_posix_prof_dump(g_prof_env_path) != 0) {
+        fprintf(stderr, "hardrt: cannot write profile to %s\n", g_prof_env_path);
+    }
+}
+
+/* Kernel thread, from hrt_init(): remember the thread and honour HARDRT_PROF=<file> once */
+static void _prof_init(void) {
+    g_prof_tid = (pid_t) syscall(SYS_gettid);
+    if (g_prof_env_tried) return;
+    g_prof_env_tried = 1;
+    g_prof_env_path = getenv("HARDRT_PROF");
+    if (g_prof_env_path && g_prof_env_path[0] && hrt_posix_prof_start(0) == 0) atexit(_prof_env_dump);
+}
+
+#define HRT_PROF_SWITCH(next) (g_prof_ctx = (next))
+#else
+#define HRT_PROF_SWITCH(next) ((void) 0)
+#endif
+
+int hrt_posix_prof_start(const uint32_t hz) {
+#if HARDRT_POSIX_PROF == 1
+    if (!g_irq_ready || g_prof_tid == 0) return -1;
+    if (g_prof_armed) hrt_posix_prof_stop();
+
+    /* backtrace() loads the unwinder on first use; never let that happen in the handler */
+    void *warm[2];
+    (void) backtrace(warm, 2);
+
+    struct sigaction sa = {0};
+    sa.sa_sigaction = _prof_sighandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_SIGINFO | SA_RESTART | SA_ONSTACK;
+    sigaction(SIGPROF, &sa, NULL);
+
+    clockid_t clk;
+    if (pthread_getcpuclockid(g_kernel_thread, &clk) != 0) return -1;
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGPROF;
+    sev._sigev_un._tid = g_prof_tid; /* sigev_notify_thread_id */
+    if (timer_create(clk, &sev, &g_prof_timer) != 0) return -1;
+
+    const long ns = 1000000000L / (long) (hz ? hz : HARDRT_POSIX_PROF_HZ);
+    struct itimerspec its = {0};
+    its.it_value.tv_sec = ns / 1000000000L;
+    its.it_value.tv_nsec = ns % 1000000000L;
+    its.it_interval = its.it_value;
+    if (timer_settime(g_prof_timer, 0, &its, NULL) != 0) {
+        timer_delete(g_prof_timer);
+        return -1;
+    }
+    g_prof_ctx = hrt__get_current();
+    g_prof_armed = 1;
+    return 0;
+#else
+    (void) hz;
+    return -1;
+#endif
+}
+
+void hrt_posix_prof_stop(void) {
+#if HARDRT_POSIX_PROF == 1
+    if (!g_prof_armed) return;
+    timer_delete(g_prof_timer);
+    g_prof_armed = 0;
+#endif
+}
+
+void hrt_posix_prof_reset(void) {
+#if HARDRT_POSIX_PROF == 1
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGPROF);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+    memset(g_prof, 0, sizeof(g_prof));
+    memset(g_prof_ctx_samples, 0, sizeof(g_prof_ctx_samples));
+    g_prof_samples = 0;
+    g_prof_dropped = 0;
+    g_prof_nstacks = 0;
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+#endif
+}
+
+int hrt_posix_prof_stats(hrt_posix_prof_stats_t *out) {
+#if HARDRT_POSIX_PROF == 1
+    if (!out) return -1;
+    out->samples = g_prof_samples;
+    out->dropped = g_prof_dropped;
+    out->stacks = g_prof_nstacks;
+    return 0;
+#else
+    (void) out;
+    return -1;
+#endif
+}
+
+uint32_t hrt_posix_prof_task_samples(const int id) {
+#if HARDRT_POSIX_PROF == 1
+    if (id == HRT_PROF_HOST) return g_prof_ctx_samples[HARDRT_MAX_TASKS];
+    if (id < 0 || id >= HARDRT_MAX_TASKS) return 0u;
+    return g_prof_ctx_samples[id];
+#else
+    (void) id;
+    return 0u;
+#endif
+}
+
+int hrt_posix_prof_dump(const char *path) {
+#if HARDRT_POSIX_PROF == 1
+    if (!path) return -1;
+    FILE *f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!f) return -1;
+    int rc = _prof_write(f);
+    if (f != stdout && fclose(f) != 0) rc = -1;
+    return rc;
+#else
+    (void) path;
+    return -1;
+#endif
+}
+
+/* ---- Shared-memory telemetry page ----
+ * One writer, the kernel thread, under a seqlock. A switch costs a clock read
+ * and a handful of stores (run time, switch count, current task); the task
+ * table and watched objects are copied at most every HARDRT_POSIX_SHM_PERIOD_MS,
+ * from a switch or the tick. Both run with the tick masked, so they never nest. */
+#if HARDRT_POSIX_SHM == 1
+static hrt_shm_page_t *g_shm = NULL;
+static char g_shm_name[64];
+static int g_shm_tried = 0;
+static int g_shm_owner = -1;
+static uint64_t g_shm_last_ns = 0;  /* owner charged up to here */
+static uint64_t g_shm_snap_ns = 0;
+static const void *g_shm_objs[HRT_SHM_OBJS];
+
+static inline void _shm_begin(void) {
+    __atomic_store_n(&g_shm->seq, g_shm->seq + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void _shm_end(void) {
+    __atomic_store_n(&g_shm->seq, g_shm->seq + 1u, __ATOMIC_RELEASE);
+}
+
+static void _shm_charge(const uint64_t now) {
+    if (g_shm_owner >= 0) g_shm->task[g_shm_owner].run_ns += now - g_shm_last_ns;
+    g_shm_last_ns = now;
+}
+
+static void _shm_snapshot(const uint64_t now) {
+    _shm_charge(now);
+    for (int i = 0; i < HARDRT_MAX_TASKS; ++i) {
+        const _hrt_tcb_t *t = hrt__tcb(i);
+        hrt_shm_task_t *d = &g_shm->task[i];
+        if (i == HRT_IDLE_ID) d->state = (i == g_shm_owner) ? HRT_SHM_RUNNING : HRT_SHM_READY;
+        else d->state = (i == g_shm_owner && t->state == HRT_READY) ? HRT_SHM_RUNNING : t->state;
+        d->prio = t->prio;
+        d->wake_tick = t->wake_tick;
+        d->timeslice = t->timeslice_cfg;
+        d->slice_left = t->slice_left;
+        d->stack_words = (uint32_t) t->stack_words;
+    }
+    for (uint32_t i = 0; i < g_shm->nobjs; ++i) {
+        hrt_shm_obj_t *d = &g_shm->obj[i];
+        switch (d->kind) {
+            case HRT_SHM_OBJ_SEM: {
+                const hrt_sem_t *o = g_shm_objs[i];
+                d->level = o->count & HRT_SEM_MAX_COUNT;
+                d->capacity = o->max_count;
+                d->waiters = o->count_wait;
+                break;
+            }
+            case HRT_SHM_OBJ_MUTEX: {
+                const hrt_mutex_t *o = g_shm_objs[i];
+                d->level = (o->locked & HRT_MUTEX_HELD) ? 1u : 0u;
+                d->capacity = 1u;
+                d->waiters = o->count_wait;
+                d->owner = o->owner;
+                break;
+            }
+            case HRT_SHM_OBJ_QUEUE: {
+                const hrt_queue_t *o = g_shm_objs[i];
+                d->level = o->count;
+                d->capacity = o->capacity;
+                d->waiters = (uint8_t) (o->rx_wait + o->tx_wait);
+                break;
+            }
+            default: break;
+        }
+    }
+    g_shm->tick = hrt_tick_now();
+    g_shm->policy = (uint32_t) hrt__policy();
+    g_shm->update_ns = now;
+    g_shm_snap_ns = now;
+}
+
+static void _shm_unlink(void) {
+    shm_unlink(g_shm_name);
+}
+
+/* Create the page once per process; every hrt_init() starts it afresh */
+static void _shm_init(void) {
+    if (!g_shm_tried) {
+        g_shm_tried = 1;
+        const char *env = getenv("HARDRT_SHM_NAME");
+        if (env && env[0] == '/') snprintf(g_shm_name, sizeof(g_shm_name), "%s", env);
+        else snprintf(g_shm_name, sizeof(g_shm_name), "/hardrt.%ld", (long) getpid());
+        const int fd = shm_open(g_shm_name, O_CREAT | O_RDWR, 0644);
+        if (fd < 0) return;
+        void *p = MAP_FAILED;
+        if (ftruncate(fd, (off_t) sizeof(hrt_shm_page_t)) == 0) {
+            p = mmap(NULL, sizeof(hrt_shm_page_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (p == MAP_FAILED) {
+            shm_unlink(g_shm_name);
+            return;
+        }
+        g_shm = p;
+        atexit(_shm_unlink);
+    }
+    if (!g_shm) return;
+
+    _shm_begin();
+    const uint32_t seq = g_shm->seq;
+    memset(g_shm, 0, sizeof(*g_shm));
+    g_shm->seq = seq;
+    g_shm->magic = HRT_SHM_MAGIC;
+    g_shm->version = HRT_SHM_VERSION;
+    g_shm->page_bytes = (uint16_t) sizeof(hrt_shm_page_t);
+    g_shm->pid = (uint32_t) getpid();
+    g_shm->max_tasks = HARDRT_MAX_TASKS;
+    g_shm->tick_hz = hrt__cfg_tick_hz();
+    g_shm->current = -1;
+    for (uint32_t i = 0; i < HRT_SHM_TASKS; ++i) g_shm->task[i].state = HRT_SHM_UNUSED;
+    memset(g_shm_objs, 0, sizeof(g_shm_objs));
+    g_shm_owner = -1;
+    g_shm_last_ns = g_shm_snap_ns = hrt_posix_now_ns();
+    _shm_end();
+}
+
+static void _shm_switch(const int next) {
+    if (!g_shm) return;
+    const uint64_t now = hrt_posix_now_ns();
+    _shm_begin();
+    _shm_charge(now);
+    if (next >= 0 && next != g_shm_owner) {
+        g_shm->task[next].switches_in++;
+        g_shm->switches++;
+    }
+    g_shm->current = next;
+    g_shm_owner = next;
+    if (now - g_shm_snap_ns >= HARDRT_POSIX_SHM_PERIOD_MS * 1000000ull) _shm_snapshot(now);
+    else g_shm->update_ns = now;
+    _shm_end();
+}
+
+/* Tick handler: keep the page fresh while one task runs without switching */
+static void _shm_tick(void) {
+    if (!g_shm) return;
+    const uint64_t now = hrt_posix_now_ns();
+    if (now - g_shm_snap_ns < HARDRT_POSIX_SHM_PERIOD_MS * 1000000ull) return;
+    _shm_begin();
+    _shm_snapshot(now);
+    _shm_end();
+}
+
+#define HRT_SHM_SWITCH(next) _shm_switch(next)
+#else
+#define HRT_SHM_SWITCH(next) ((void) 0)
+#endif
+
+const char *hrt_posix_shm_name(void) {
+#if HARDRT_POSIX_SHM == 1
+    return g_shm ? g_shm_name : NULL;
+#else
+    return NULL;
+#endif
+}
+
+int hrt_posix_shm_watch(const char *name, const void *obj, const hrt_shm_obj_kind_t kind) {
+#if HARDRT_POSIX_SHM == 1
+    if (!g_shm || !name || !obj || kind == HRT_SHM_OBJ_NONE || kind > HRT_SHM_OBJ_QUEUE) return -1;
+    sigset_t old;
+    block_sigalrm(&old);
+    const uint32_t i = g_shm->nobjs;
+    if (i >= HRT_SHM_OBJS) {
+        unblock_sigalrm(&old);
+        return -1;
+    }
+    _shm_begin();
+    hrt_shm_obj_t *d = &g_shm->obj[i];
+    memset(d, 0, sizeof(*d));
+    snprintf(d->name, sizeof(d->name), "%s", name);
+    d->kind = (uint8_t) kind;
+    d->owner = -1;
+    g_shm_objs[i] = obj;
+    g_shm->nobjs = i + 1u;
+    _shm_end();
+    unblock_sigalrm(&old);
+    return (int) i;
+#else
+    (void) name;
+    (void) obj;
+    (void) kind;
+    return -1;
+#endif
+}
+
+void hrt_posix_shm_update(void) {
+#if HARDRT_POSIX_SHM == 1
+    if (!g_shm) return;
+    sigset_t old;
+    block_sigalrm(&old);
+    _shm_begin();
+    _shm_snapshot(hrt_posix_now_ns());
+    _shm_end();
+    unblock_sigalrm(&old);
+#endif
+}
+
 /* ---- Task trampoline ---- */
 void hrt__task_trampoline(void) {
     const int id = hrt__get_current();
@@ -98,11 +945,87 @@ void hrt__task_trampoline(void) {
     hrt_task_delete();
 }
 
+#if HARDRT_POSIX_GUARD_PAGES == 1
+/* ---- Guard pages ----
+ * Each task stack lives in its own mapping whose lowest page is PROT_NONE, so
+ * running off the end faults at once instead of corrupting a neighbour. The
+ * fault is taken on the signal stack, reported, and then re-raised with the
+ * default action so a debugger or core dump sees the original fault. */
+static size_t g_page_bytes = 0;
+
+static void _guard_write_str(const char *str) {
+    (void) !write(STDERR_FILENO, str, strlen(str));
+}
+
+static void _guard_segv(const int signo, siginfo_t *si, void *uc) {
+    (void) uc;
+    const uintptr_t addr = (uintptr_t) si->si_addr;
+    for (int i = 0; i < HARDRT_MAX_TASKS; ++i) {
+        const uintptr_t lo = (uintptr_t) g_ctxs[i].map;
+        if (!lo || addr < lo || addr >= lo + g_page_bytes) continue;
+
+        hrt_error(ERR_STACK_OVERFLOW);
+        char num[12];
+        int n = (int) sizeof(num) - 1;
+        num[n] = '\0';
+        int v = i;
+        do { num[--n] = (char) ('0' + v % 10); v /= 10; } while (v && n > 0);
+        _guard_write_str("hardrt: stack overflow in task ");
+        _guard_write_str(&num[n]);
+        _guard_write_str(" (guard page hit)\n");
+        break;
+    }
+    /* Not ours or reported: fault again with the default action */
+    signal(signo, SIG_DFL);
+}
+
+static void _guard_init(void) {
+    g_page_bytes = (size_t) sysconf(_SC_PAGESIZE);
+    struct sigaction sa = {0};
+    sa.sa_sigaction = _guard_segv;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_SIGINFO | SA_ONSTACK; /* the faulting stack is exhausted */
+    sigaction(SIGSEGV, &sa, NULL);
+    sigaction(SIGBUS, &sa, NULL);
+}
+
+/* Map (or reuse) a guarded stack for slot `id`; returns the usable base or NULL */
+static uint32_t *_guard_map(const int id, const size_t bytes) {
+    _port_ctx_t *c = &g_ctxs[id];
+    const size_t need = g_page_bytes + ((bytes + g_page_bytes - 1u) & ~(g_page_bytes - 1u));
+    if (c->map && c->map_bytes != need) {
+        munmap(c->map, c->map_bytes);
+        c->map = NULL;
+    }
+    if (!c->map) {
+        void *m = mmap(NULL, need, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (m == MAP_FAILED) return NULL;
+        if (mprotect(m, g_page_bytes, PROT_NONE) != 0) {
+            munmap(m, need);
+            return NULL;
+        }
+        c->map = m;
+        c->map_bytes = need;
+    }
+    /* The stack ends right at the guard: one word past the requested size faults */
+    return (uint32_t *) ((uint8_t *) c->map + g_page_bytes);
+}
+#endif
+
 /* Prepare ucontext for the task using the provided stack */
 void hrt_port_prepare_task_stack(const int id, void (*tramp)(void),
                                  uint32_t *stack_base, const size_t words) {
     (void) tramp; /* we use hrt__task_trampoline directly */
     const size_t bytes = words * sizeof(uint32_t);
+#if HARDRT_POSIX_GUARD_PAGES == 1
+    /* Same size as requested, but in a guarded mapping instead of the caller's array */
+    uint32_t *guarded = _guard_map(id, bytes);
+    if (guarded) {
+        stack_base = guarded;
+        hrt__tcb(id)->stack_base = guarded;
+        HRT_STACK_PAINT_WORDS(guarded, words);
+    }
+#endif
     getcontext(&g_ctxs[id].ctx);
     g_ctxs[id].ctx.uc_stack.ss_sp = (void *) stack_base;
     g_ctxs[id].ctx.uc_stack.ss_size = bytes;
@@ -116,23 +1039,55 @@ void hrt_port_prepare_task_stack(const int id, void (*tramp)(void),
 /* Tick handler: only set a flag; do not swap here */
 static void _tick_sighandler(const int signo) {
     (void) signo;
+    const uint32_t prev = g_irq_active;
+    g_irq_active = HARDRT_POSIX_TICK_IRQ_PRIO;
     hrt__tick_isr();
+#if HARDRT_POSIX_SHM == 1
+    _shm_tick();
+#endif
     g_switch_pending = 1;
+    g_irq_active = prev;
+    /* Lines that could not nest into the tick are taken now (tail-chain) */
+    if (g_irq_pending && _irq_pick() >= 0) _irq_dispatch();
 }
 
 /* Start periodic SIGALRM at the requested Hz */
 void hrt_port_start_systick(const uint32_t tick_hz) {
+#if HARDRT_POSIX_PERF == 1
+    _perf_open();
+    hrt_posix_perf_reset();
+#endif
+    sigemptyset(&g_sigalrm_set);
+    sigaddset(&g_sigalrm_set, SIGALRM);
+    _irq_init();
+#if HARDRT_POSIX_GUARD_PAGES == 1
+    _guard_init();
+#endif
+    g_switch_set = g_sigalrm_set;
+    sigaddset(&g_switch_set, HRT_IRQ_SIGNAL);
+#if HARDRT_POSIX_PROF == 1
+    sigaddset(&g_switch_set, SIGPROF); /* never unwind a half-switched context */
+    _prof_init();
+#endif
+#if HARDRT_POSIX_SHM == 1
+    _shm_init();
+#endif
+
     /* If an external tick is selected, do not start the SIGALRM timer. */
     if (hrt__cfg_tick_src() == HRT_TICK_EXTERNAL) {
         return;
     }
-    sigemptyset(&g_sigalrm_set);
-    sigaddset(&g_sigalrm_set, SIGALRM);
+    /* Virtual time: make sure no timer left over from a previous init keeps firing */
+    if (hrt__cfg_tick_src() == HRT_TICK_VIRTUAL) {
+        const struct itimerval off = {0};
+        setitimer(ITIMER_REAL, &off, NULL);
+        return;
+    }
 
     struct sigaction sa = {0};
     sa.sa_handler = _tick_sighandler;
     sigemptyset(&sa.sa_mask);
-    sa.sa_flags = SA_RESTART;
+    sa.sa_flags = SA_RESTART | SA_ONSTACK;
     sigaction(SIGALRM, &sa, NULL);
 
     struct itimerval it = {0};
@@ -157,18 +1112,84 @@ void hrt__pend_context_switch(void) {
     g_switch_pending = 1;
 }
 
-/* Task-context only: hop into the scheduler with SIGALRM masked */
+/* Task-context only: pick the next task with SIGALRM masked and swap straight
+ * into it. The scheduler context is only used when nothing is ready (idle). */
 void hrt_port_yield_to_scheduler(void) {
     const int cur = hrt__get_current();
     if (cur < 0 || cur == HRT_IDLE_ID || !g_ctxs[cur].valid) return;
+    /* Deferred ISR posts are applied before the pick, with the IRQ lines still open */
+    HRT_ISR_DRAIN();
     sigset_t old;
     block_sigalrm(&old);
-    swapcontext(&g_ctxs[cur].ctx, &g_sched_ctx);
+
+#ifdef HARDRT_TEST_HOOKS
+    if (g_test_stop) {
+        /* Let the scheduler loop observe the stop request and return */
+        swapcontext(&g_ctxs[cur].ctx, &g_sched_ctx);
+        unblock_sigalrm(&old);
+        return;
+    }
+#endif
+
+    /* Same rotation the scheduler loop applies on re-entry */
+    hrt__on_scheduler_entry();
+    g_switch_pending = 0;
+
+    const int next = hrt__pick_next_ready();
+    if (next < 0 || next == HRT_IDLE_ID) {
+        /* Nothing ready: park in the scheduler context, which idles until a tick wakes someone */
+        HRT_SWITCH_HOOK(HRT_IDLE_ID);
+        HRT_PERF_SWITCH(HRT_IDLE_ID);
+        HRT_PROF_SWITCH(HRT_IDLE_ID);
+        HRT_SHM_SWITCH(HRT_IDLE_ID);
+        swapcontext(&g_ctxs[cur].ctx, &g_sched_ctx);
+        unblock_sigalrm(&old);
+        return;
+    }
+    HRT_SWITCH_HOOK(next);
+    HRT_PERF_SWITCH(next);
+    HRT_PROF_SWITCH(next);
+    HRT_SHM_SWITCH(next);
+    if (next != cur) {
+        hrt__set_current(next);
+        swapcontext(&g_ctxs[cur].ctx, &g_ctxs[next].ctx);
+    }
+    /* next == cur: the yielding task is still the best candidate; keep running */
+
     unblock_sigalrm(&old);
 }
 
-/* Scheduler loop: pick and switch, with SIGALRM masked during critical sections */
-void hrt_port_enter_scheduler(void) {
+/* Virtual time, scheduler context only: nothing is ready, so jump the tick to
+ * the next wake deadline (clamped to `until` when bounded). Returns 1 when a
+ * bounded run has reached `until` and should hand control back to the host. */
+static int _virtual_idle(const int bounded, const uint32_t until) {
+    const uint32_t now = hrt_tick_now();
+    if (bounded && (int32_t) (until - now) <= 0) return 1;
+
+    uint32_t target;
+    if (hrt__next_wake_tick(&target) != 0) {
+        if (!bounded) {
+            /* Nothing will ever wake: behave like an idle CPU */
+            hrt_port_idle_wait();
+            return 0;
+        }
+        hrt__skip_ticks(until - now);
+        return 1;
+    }
+    if (bounded && (int32_t) (target - until) > 0) target = until;
+    if ((int32_t) (target - now) <= 0) target = now + 1u;
+
+    /* Skip the empty ticks, then run one real tick so sleepers wake as usual */
+    hrt__skip_ticks(target - now - 1u);
+    hrt__tick_isr();
+    g_switch_pending = 1;
+    return 0;
+}
+
+/* Scheduler loop: pick and switch, with SIGALRM masked during critical sections.
+ * `bounded` runs (virtual time only) return once the tick reaches `until` and idle. */
+static void _scheduler_loop(const int bounded, const uint32_t until) {
+    const int virt = (hrt__cfg_tick_src() == HRT_TICK_VIRTUAL);
     for (;;) {
 #ifdef HARDRT_TEST_HOOKS
         if (g_test_stop) {
@@ -179,21 +1200,41 @@ void hrt_port_enter_scheduler(void) {
         }
 #endif
         if (!g_switch_pending) {
-            hrt_port_idle_wait();
+            HRT_STACK_IDLE_CHECK();
+            if (virt) {
+                if (_virtual_idle(bounded, until)) return;
+            } else {
+                hrt_port_idle_wait();
+            }
             continue;
         }
         g_switch_pending = 0;
+        /* A post landing after this pends another pass */
+        HRT_ISR_DRAIN();
 
         sigset_t old;
         block_sigalrm(&old);
 
         const int next = hrt__pick_next_ready();
         if (next < 0 || next == HRT_IDLE_ID) {
+            HRT_SWITCH_HOOK(HRT_IDLE_ID);
+            HRT_PERF_SWITCH(HRT_IDLE_ID);
+            HRT_PROF_SWITCH(HRT_IDLE_ID);
+            HRT_SHM_SWITCH(HRT_IDLE_ID);
             unblock_sigalrm(&old);
-            hrt_port_idle_wait();
+            HRT_STACK_IDLE_CHECK();
+            if (virt) {
+                if (_virtual_idle(bounded, until)) return;
+            } else {
+                hrt_port_idle_wait();
+            }
             continue;
         }
 
+        HRT_SWITCH_HOOK(next);
+        HRT_PERF_SWITCH(next);
+        HRT_PROF_SWITCH(next);
+        HRT_SHM_SWITCH(next);
         hrt__set_current(next);
         /* Jump from scheduler to task; a task will swap back when it yields/sleeps */
         swapcontext(&g_sched_ctx, &g_ctxs[next].ctx);
@@ -206,18 +1247,66 @@ void hrt_port_enter_scheduler(void) {
     }
 }
 
+void hrt_port_enter_scheduler(void) {
+    _scheduler_loop(0, 0);
+}
+
+uint32_t hrt_sim_run_for(const uint32_t ticks) {
+    if (hrt__cfg_tick_src() != HRT_TICK_VIRTUAL) return hrt_tick_now();
+    /* Always give newly readied tasks a chance to run before time moves */
+    g_switch_pending = 1;
+    _scheduler_loop(1, hrt_tick_now() + ticks);
+    HRT_PERF_SWITCH(-1); /* host code between runs is not charged */
+    HRT_PROF_SWITCH(-1);
+    HRT_SHM_SWITCH(-1);
+    return hrt_tick_now();
+}
+
+uint32_t hrt_sim_step(void) {
+    return hrt_sim_run_for(1u);
+}
+
+/* Virtual time, task context: the running task burns `ticks` ticks of CPU. Every
+ * tick goes through the tick ISR. A switch it pends (a wake or an expired slice)
+ * is taken before the next tick of work, as PendSV would: the task goes to the
+ * tail of its class. Work that ends on the tick keeps the CPU until it blocks. */
+void hrt_sim_consume(uint32_t ticks) {
+    if (hrt__cfg_tick_src() != HRT_TICK_VIRTUAL) return;
+    const int cur = hrt__get_current();
+    if (cur < 0 || cur == HRT_IDLE_ID || !g_ctxs[cur].valid) return;
+
+    while (ticks--) {
+        if (g_switch_pending) {
+            /* An expired slice is requeued (and refilled) by hrt__on_scheduler_entry() */
+            const _hrt_tcb_t *t = hrt__tcb(cur);
+            const int expired = hrt__policy() != HRT_SCHED_PRIORITY && t->timeslice_cfg > 0 && t->slice_left == 0;
+            if (!expired) hrt__requeue_noreset(cur);
+            hrt_port_yield_to_scheduler();
+        }
+        sigset_t old;
+        block_sigalrm(&old);
+        hrt__tick_isr();
+        unblock_sigalrm(&old);
+    }
+}
+
 void hrt_port_crit_enter(void) {
     if (g_crit_depth++ == 0) {
         /* Block SIGALRM; we don't attempt to restore an arbitrary previous mask here.
-           Critical sections are short; on the final exit we simply unmask SIGALRM. */
+           Critical sections are short; on the final exit we simply unmask SIGALRM.
+           Simulated IRQ lines are not blocked: g_crit_depth acts as BASEPRI in _irq_pick(). */
         sigprocmask(SIG_BLOCK, &g_sigalrm_set, NULL);
+        HRT_IRQOFF_BEGIN(HRT_IRQOFF_CRIT, __builtin_return_address(0));
     }
 }
 
 void hrt_port_crit_exit(void) {
     if (--g_crit_depth == 0) {
+        HRT_IRQOFF_END(HRT_IRQOFF_CRIT);
         /* Unblock SIGALRM when leaving the outermost critical section. */
         sigprocmask(SIG_UNBLOCK, &g_sigalrm_set, NULL);
+        /* Lines held off by BASEPRI are taken as soon as it drops */
+        if (g_irq_pending && _irq_pick() >= 0) _irq_dispatch();
     }
 }
 
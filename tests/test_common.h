@@ -153,6 +153,8 @@ const test_case_t *get_tests_semaphore(int *out_count);
 
 const test_case_t *get_tests_queue(int *out_count);
 
+const test_case_t *get_tests_select(int *out_count);
+
 const test_case_t *get_tests_mutex(int *out_count);
 
 const test_case_t *get_tests_now_ms(int *out_count);
@@ -160,6 +162,45 @@ const test_case_t *get_tests_now_ms(int *out_count);
 /* External tick tests */
 const test_case_t *get_tests_external_tick(int *out_count);
 
+/* Virtual-time (POSIX) tests */
+const test_case_t *get_tests_virtual_time(int *out_count);
+
+/* Simulated interrupt controller (POSIX) tests */
+const test_case_t *get_tests_irq_sim(int *out_count);
+
+/* CPU time and context-switch statistics */
+const test_case_t *get_tests_stats(int *out_count);
+
+/* Kernel event tracer */
+const test_case_t *get_tests_trace(int *out_count);
+
+/* Stack painting and high-water mark */
+const test_case_t *get_tests_stack(int *out_count);
+
+/* POSIX guard-page overflow detection */
+const test_case_t *get_tests_guard(int *out_count);
+
+/* Wake-to-run latency histograms */
+const test_case_t *get_tests_latency(int *out_count);
+
+/* Semaphore, mutex and queue contention statistics */
+const test_case_t *get_tests_obj_stats(int *out_count);
+
+/* Interrupt-masked time tracking */
+const test_case_t *get_tests_irqoff(int *out_count);
+
+/* Deferred ISR post ring */
+const test_case_t *get_tests_isr(int *out_count);
+
+/* POSIX per-task perf_event counters */
+const test_case_t *get_tests_posix_perf(int *out_count);
+
+/* POSIX SIGPROF sampling profiler */
+const test_case_t *get_tests_posix_prof(int *out_count);
+
+/* POSIX shared-memory telemetry page */
+const test_case_t *get_tests_posix_shm(int *out_count);
+
 #ifdef HARDRT_TEST_HOOKS
 /* POSIX-only test hooks to block/unblock SIGALRM for deterministic checks */
 void hrt__test_block_sigalrm(void);
@@ -0,0 +1,81 @@
+/* Tests for POSIX guard-page stack overflow detection */
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "test_common.h"
+
+#if HARDRT_POSIX_GUARD_PAGES == 1
+
+/* Always true, but opaque to the compiler (avoids -Winfinite-recursion) */
+static volatile int g_keep_recursing = 1;
+
+__attribute__((noinline))
+static int recurse_forever(const int depth) {
+    volatile char frame[256];
+    frame[0] = (char) depth;
+    if (!g_keep_recursing) return frame[0];
+    return recurse_forever(depth + 1) + frame[0];
+}
+
+static void t_overflow(void *arg) {
+    (void) arg;
+    (void) recurse_forever(0);
+}
+
+/* Runs in a forked child: the overflow must kill it with SIGSEGV after the report */
+static void child_overflow(const int err_fd) {
+    dup2(err_fd, STDERR_FILENO);
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+    static uint32_t st[256];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    hrt_create_task(t_overflow, NULL, st, 256, &a);
+    hrt_start();
+    _exit(0);
+}
+
+static void test_guard_page_catches_overflow(void) {
+    int fds[2];
+    T_ASSERT_EQ_INT(0, pipe(fds), "pipe for child stderr");
+    fflush(stdout);
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        child_overflow(fds[1]);
+    }
+    close(fds[1]);
+    T_ASSERT_TRUE(pid > 0, "forked overflow child");
+
+    char out[256] = {0};
+    size_t len = 0;
+    ssize_t r;
+    while (len < sizeof(out) - 1 && (r = read(fds[0], out + len, sizeof(out) - 1 - len)) > 0) len += (size_t) r;
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    T_ASSERT_TRUE(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV, "overflow terminates with SIGSEGV");
+    T_ASSERT_TRUE(strstr(out, "stack overflow in task 0") != NULL, "report names the overflowing task");
+}
+
+#else
+
+static void test_guard_page_catches_overflow(void) {
+    printf("SKIP: guard page checks require HARDRT_POSIX_GUARD_PAGES=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"Guard: stack overflow hits guard page", test_guard_page_catches_overflow},
+};
+
+const test_case_t *get_tests_guard(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -0,0 +1,176 @@
+/* Tests for the POSIX simulated interrupt controller (virtual NVIC) */
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+
+#include "test_common.h"
+#include "hardrt_port.h"
+#include "hardrt_posix.h"
+#include "hardrt_sem.h"
+
+#define LINE_LOW   0
+#define LINE_HIGH  1
+#define LINE_LOWER 2
+
+static char g_trace[16];
+static int g_trace_len = 0;
+
+static void trace(const char c) {
+    if (g_trace_len < (int) sizeof(g_trace) - 1) g_trace[g_trace_len++] = c;
+    g_trace[g_trace_len] = '\0';
+}
+
+static void isr_high(int line, void *arg) {
+    (void) line; (void) arg;
+    trace('H');
+}
+
+static void isr_lower(int line, void *arg) {
+    (void) line; (void) arg;
+    trace('C');
+}
+
+static void isr_low(int line, void *arg) {
+    (void) line; (void) arg;
+    trace('A');
+    hrt_posix_irq_raise(LINE_HIGH);  /* more urgent: nests immediately */
+    hrt_posix_irq_raise(LINE_LOWER); /* less urgent: waits for us to return */
+    trace('a');
+}
+
+/* ---- Case 1: priority nesting and tail-chaining ---- */
+static void test_irq_nesting_by_priority(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5,
+                        .tick_src = HRT_TICK_EXTERNAL};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (irq nesting)");
+
+    g_trace_len = 0;
+    g_trace[0] = '\0';
+    T_ASSERT_EQ_INT(0, hrt_posix_irq_attach(LINE_LOW, 8, isr_low, NULL), "attach low line");
+    T_ASSERT_EQ_INT(0, hrt_posix_irq_attach(LINE_HIGH, 3, isr_high, NULL), "attach high line");
+    T_ASSERT_EQ_INT(0, hrt_posix_irq_attach(LINE_LOWER, 12, isr_lower, NULL), "attach lower line");
+
+    hrt_posix_irq_raise(LINE_LOW);
+
+    T_ASSERT_STREQ("AHaC", g_trace, "high nests into low; lower runs after low returns");
+    T_ASSERT_EQ_INT(-1, hrt_posix_irq_active_prio(), "back in thread mode");
+}
+
+/* ---- Case 2: critical section behaves like BASEPRI ---- */
+static volatile int g_masked_ran = 0;
+static volatile int g_urgent_ran = 0;
+
+static void isr_masked(int line, void *arg) { (void) line; (void) arg; g_masked_ran++; }
+static void isr_urgent(int line, void *arg) { (void) line; (void) arg; g_urgent_ran++; }
+
+static void test_irq_crit_section_masks_syscall_lines(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5,
+                        .tick_src = HRT_TICK_EXTERNAL};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (irq basepri)");
+
+    g_masked_ran = 0;
+    g_urgent_ran = 0;
+    hrt_posix_irq_attach(0, HARDRT_MAX_SYSCALL_IRQ_PRIO + 2, isr_masked, NULL);
+    hrt_posix_irq_attach(1, HARDRT_MAX_SYSCALL_IRQ_PRIO - 3, isr_urgent, NULL);
+
+    hrt_port_crit_enter();
+    hrt_posix_irq_raise(0);
+    hrt_posix_irq_raise(1);
+    const int masked_inside = g_masked_ran;
+    const int urgent_inside = g_urgent_ran;
+    hrt_port_crit_exit();
+
+    T_ASSERT_EQ_INT(0, masked_inside, "syscall-level line held off inside critical section");
+    T_ASSERT_EQ_INT(1, urgent_inside, "line above BASEPRI still preempts critical section");
+    T_ASSERT_EQ_INT(1, g_masked_ran, "held-off line runs on critical section exit");
+
+    hrt_posix_irq_enable(0, 0);
+    hrt_posix_irq_raise(0);
+    T_ASSERT_EQ_INT(1, g_masked_ran, "disabled line stays pending");
+    hrt_posix_irq_enable(0, 1);
+    T_ASSERT_EQ_INT(2, g_masked_ran, "re-enabled line is delivered");
+}
+
+/* ---- Case 3: a host thread raises a line whose handler wakes a task ---- */
+static hrt_sem_t g_irq_sem;
+static volatile int g_irq_task_woke = 0;
+static volatile uint64_t g_irq_latency_ns = 0;
+static volatile int g_irq_watchdog = 0;
+
+static void isr_give(int line, void *arg) {
+    (void) line; (void) arg;
+    int need = 0;
+    hrt_sem_give_from_isr(&g_irq_sem, &need);
+}
+
+static void t_irq_waiter(void *arg) {
+    (void) arg;
+    hrt_sem_take(&g_irq_sem);
+    g_irq_latency_ns = hrt_posix_now_ns() - hrt_posix_irq_raised_ns(3);
+    g_irq_task_woke = 1;
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void t_irq_watchdog(void *arg) {
+    (void) arg;
+    hrt_sleep(500);
+    g_irq_watchdog = 1;
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void *host_device(void *arg) {
+    (void) arg;
+    hrt_posix_host_thread_init();
+    const struct timespec ts = {0, 20 * 1000 * 1000};
+    nanosleep(&ts, NULL);
+    hrt_posix_irq_raise(3);
+    return NULL;
+}
+
+static void test_irq_host_thread_wakes_task(void) {
+    hrt__test_reset_scheduler_state();
+    g_irq_task_woke = 0;
+    g_irq_watchdog = 0;
+    hrt_sem_init(&g_irq_sem, 0);
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (irq wake)");
+    T_ASSERT_EQ_INT(0, hrt_posix_irq_attach(3, 10, isr_give, NULL), "attach device line");
+
+    static uint32_t sw[1024], swd[1024];
+    hrt_task_attr_t hi = {.priority = HRT_PRIO0, .timeslice = 0};
+    hrt_task_attr_t lo = {.priority = HRT_PRIO2, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(t_irq_waiter, NULL, sw, 1024, &hi) >= 0, "created waiter");
+    T_ASSERT_TRUE(hrt_create_task(t_irq_watchdog, NULL, swd, 1024, &lo) >= 0, "created watchdog");
+
+    /* Create the device thread with kernel signals already blocked (the mask is inherited) */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    pthread_t th;
+    const int rc = pthread_create(&th, NULL, host_device, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    T_ASSERT_EQ_INT(0, rc, "started host device thread");
+
+    hrt_start();
+    pthread_join(th, NULL);
+
+    T_ASSERT_EQ_INT(0, g_irq_watchdog, "watchdog should not trip");
+    T_ASSERT_EQ_INT(1, g_irq_task_woke, "task woke from give_from_isr in a line handler");
+    T_ASSERT_TRUE(g_irq_latency_ns > 0, "raise-to-task latency measured from line timestamp");
+}
+
+static const test_case_t CASES[] = {
+    {"IRQ sim: nesting by priority", test_irq_nesting_by_priority},
+    {"IRQ sim: critical section acts as BASEPRI", test_irq_crit_section_masks_syscall_lines},
+    {"IRQ sim: host thread raise wakes task", test_irq_host_thread_wakes_task},
+};
+
+const test_case_t *get_tests_irq_sim(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -0,0 +1,108 @@
+/* Tests for interrupt-masked time tracking */
+#include <stdio.h>
+
+#include "test_common.h"
+#include "hardrt_irqoff.h"
+#include "hardrt_posix.h"
+
+#if HARDRT_IRQOFF == 1
+
+void hrt_port_crit_enter(void);
+void hrt_port_crit_exit(void);
+
+/* Nested, 2 ms long section; noinline so the recorded call site lies in this function */
+__attribute__((noinline)) static void irqoff_long_section(void) {
+    hrt_port_crit_enter();
+    hrt_port_crit_enter();
+    const uint64_t until = hrt_posix_now_ns() + 2000000ull;
+    while (hrt_posix_now_ns() < until) {
+    }
+    hrt_port_crit_exit();
+    hrt_port_crit_exit();
+}
+
+static void test_irqoff_crit(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    cfg.tick_src = HRT_TICK_VIRTUAL; /* no tick handler taking critical sections behind our back */
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (irqoff)");
+
+    /* Every read is itself a critical section: keep calls out of the assert macros */
+    hrt_irqoff_t a, b;
+    const int ra = hrt_irqoff_stats(HRT_IRQOFF_CRIT, &a);
+    irqoff_long_section();
+    const int rb = hrt_irqoff_stats(HRT_IRQOFF_CRIT, &b);
+    T_ASSERT_TRUE(ra == 0 && rb == 0, "read before and after");
+
+    /* The first read's own section closes after its copy */
+    T_ASSERT_EQ_UINT(a.hist.count + 2u, b.hist.count, "nested section measured once");
+    T_ASSERT_TRUE(b.hist.max_cycles >= (uint64_t) hrt_port_cycles_hz() * 15u / 10000u, "max covers the 2 ms section");
+    const uintptr_t fn = (uintptr_t) irqoff_long_section;
+    T_ASSERT_TRUE(b.max_site > fn && b.max_site < fn + 512u, "worst site is inside the long section's caller");
+    T_ASSERT_TRUE(b.hist.min_cycles <= b.hist.p99_cycles && b.hist.p99_cycles <= b.hist.max_cycles,
+                  "min <= p99 <= max");
+
+    uint32_t binned = 0;
+    for (uint32_t k = 0; k < HRT_LATENCY_BINS; ++k) binned += b.hist.bins[k];
+    T_ASSERT_EQ_UINT(b.hist.count, binned, "bins add up to count");
+
+    hrt_irqoff_reset();
+    const int rr = hrt_irqoff_stats(HRT_IRQOFF_CRIT, &b);
+    T_ASSERT_EQ_INT(0, rr, "read after reset");
+    T_ASSERT_EQ_UINT(1, b.hist.count, "reset clears samples; its own section remains");
+    T_ASSERT_EQ_INT(-1, hrt_irqoff_stats(HRT_IRQOFF_SOURCES, &b), "bad source rejected");
+}
+
+static void t_irqoff_yield(void *arg) {
+    (void) arg;
+    for (int i = 0; i < 10; ++i) hrt_yield();
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void t_irqoff_spin(void *arg) {
+    (void) arg;
+    for (;;) hrt_yield();
+}
+
+static void test_irqoff_switch(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (irqoff switch)");
+
+    static uint32_t s_a[1024], s_b[1024];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(t_irqoff_yield, NULL, s_a, 1024, &a) >= 0, "created yielding task");
+    T_ASSERT_TRUE(hrt_create_task(t_irqoff_spin, NULL, s_b, 1024, &a) >= 0, "created partner task");
+    hrt_start();
+
+    hrt_irqoff_t s;
+    T_ASSERT_EQ_INT(0, hrt_irqoff_stats(HRT_IRQOFF_SWITCH, &s), "read switch path");
+    T_ASSERT_TRUE(s.hist.count >= 10u, "every pass through the scheduler measured");
+    T_ASSERT_TRUE(s.hist.max_cycles >= s.hist.min_cycles, "max >= min");
+    T_ASSERT_TRUE(s.max_site == 0, "no call site for the switch path");
+}
+
+#else
+
+static void test_irqoff_crit(void) {
+    hrt_irqoff_t s;
+    T_ASSERT_EQ_INT(-1, hrt_irqoff_stats(HRT_IRQOFF_CRIT, &s), "no samples without HARDRT_IRQOFF");
+    printf("SKIP: masked-time checks require HARDRT_IRQOFF=ON.\n");
+}
+
+static void test_irqoff_switch(void) {
+    printf("SKIP: masked-time checks require HARDRT_IRQOFF=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"IrqOff: critical sections and worst site", test_irqoff_crit},
+    {"IrqOff: scheduler switch path", test_irqoff_switch},
+};
+
+const test_case_t *get_tests_irqoff(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
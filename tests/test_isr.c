@@ -0,0 +1,285 @@
+/* Tests for ISR brackets and the deferred ISR post ring */
+#include <stdio.h>
+
+#include "test_common.h"
+#include "hardrt_isr.h"
+#include "hardrt_posix.h"
+#include "hardrt_sem.h"
+#include "hardrt_queue.h"
+
+#define ISR_LINE 0
+#define ISR_PRIO 8 /* >= HARDRT_MAX_SYSCALL_IRQ_PRIO: may call kernel APIs */
+#define ISR_LINE_NEST 1
+#define ISR_PRIO_NEST 6
+
+/* ---- Brackets: one decision at the outermost exit ---- */
+static hrt_sem_t g_br_hi, g_br_lo;
+static volatile int g_br_need_lo = 0, g_br_need_hi = 0;
+static volatile int g_br_exit_lo = -1, g_br_exit_inner = -1, g_br_exit_outer = -1;
+static volatile int g_br_lo_ran_early = 0, g_br_hi_ran = 0;
+
+static void isr_br_lo(int line, void *arg) {
+    (void) line; (void) arg;
+    hrt_isr_enter();
+    int need = 0;
+    hrt_sem_give_from_isr(&g_br_lo, &need);
+    g_br_need_lo = need;
+    g_br_exit_lo = hrt_isr_exit();
+}
+
+static void isr_br_inner(int line, void *arg) {
+    (void) line; (void) arg;
+    hrt_isr_enter();
+    int need = 0;
+    hrt_sem_give_from_isr(&g_br_hi, &need);
+    g_br_need_hi = need;
+    g_br_exit_inner = hrt_isr_exit();
+}
+
+static void isr_br_outer(int line, void *arg) {
+    (void) line; (void) arg;
+    hrt_isr_enter();
+    hrt_posix_irq_raise(ISR_LINE_NEST); /* more urgent: nests right here */
+    g_br_exit_outer = hrt_isr_exit();
+}
+
+static void t_br_hi(void *arg) {
+    (void) arg;
+    hrt_sem_take(&g_br_hi);
+    g_br_hi_ran = 1;
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void t_br_lo(void *arg) {
+    (void) arg;
+    hrt_sem_take(&g_br_lo);
+    if (!g_br_hi_ran) g_br_lo_ran_early = 1;
+    for (;;) hrt_yield();
+}
+
+static void t_br_runner(void *arg) {
+    (void) arg;
+    hrt_sleep(2); /* both waiters park first */
+    hrt_posix_irq_raise(ISR_LINE);
+    hrt_posix_irq_attach(ISR_LINE, ISR_PRIO, isr_br_outer, NULL);
+    hrt_posix_irq_raise(ISR_LINE);
+    for (;;) hrt_yield();
+}
+
+static void test_isr_bracket(void) {
+    hrt__test_reset_scheduler_state();
+    g_br_need_lo = g_br_need_hi = 0;
+    g_br_exit_lo = g_br_exit_inner = g_br_exit_outer = -1;
+    g_br_lo_ran_early = g_br_hi_ran = 0;
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    cfg.tick_src = HRT_TICK_VIRTUAL;
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (isr bracket)");
+    hrt_sem_init(&g_br_hi, 0);
+    hrt_sem_init(&g_br_lo, 0);
+    T_ASSERT_EQ_INT(0, hrt_posix_irq_attach(ISR_LINE, ISR_PRIO, isr_br_lo, NULL), "attach line");
+    T_ASSERT_EQ_INT(0, hrt_posix_irq_attach(ISR_LINE_NEST, ISR_PRIO_NEST, isr_br_inner, NULL), "attach nested line");
+
+    static uint32_t s_hi[1024], s_lo[1024], s_run[1024];
+    hrt_task_attr_t p0 = {.priority = HRT_PRIO0, .timeslice = 0};
+    hrt_task_attr_t p1 = {.priority = HRT_PRIO1, .timeslice = 0};
+    hrt_task_attr_t p2 = {.priority = HRT_PRIO2, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(t_br_hi, NULL, s_hi, 1024, &p0) >= 0, "created high waiter");
+    T_ASSERT_TRUE(hrt_create_task(t_br_lo, NULL, s_lo, 1024, &p2) >= 0, "created low waiter");
+    T_ASSERT_TRUE(hrt_create_task(t_br_runner, NULL, s_run, 1024, &p1) >= 0, "created runner");
+    hrt_start();
+
+    T_ASSERT_EQ_INT(1, g_br_need_lo, "need_switch still reports the wake-up");
+    /* A deferred post's priority is unknown at exit, so it always pends */
+    T_ASSERT_EQ_INT(HARDRT_ISR_DEFER ? 1 : 0, g_br_exit_lo, "lower-priority wake-up does not pend a switch");
+    T_ASSERT_EQ_INT(1, g_br_need_hi, "nested give reports the wake-up");
+    T_ASSERT_EQ_INT(0, g_br_exit_inner, "nested exit leaves the decision to the outermost one");
+    T_ASSERT_EQ_INT(1, g_br_exit_outer, "outermost exit pends once for the outranking task");
+    T_ASSERT_EQ_INT(1, g_br_hi_ran, "high waiter ran");
+    T_ASSERT_EQ_INT(0, g_br_lo_ran_early, "low waiter did not run before the high one");
+    T_ASSERT_EQ_INT(0, hrt_isr_exit(), "unbalanced exit is ignored");
+}
+
+#if HARDRT_ISR_DEFER == 1
+
+static hrt_sem_t g_isr_sem;
+static volatile int g_isr_gives = 1;
+static volatile int g_isr_need = 0;
+static volatile int g_isr_stored = -1, g_isr_stored_need = -1;
+static volatile int g_isr_woken = 0, g_isr_woken_early = -1, g_isr_woken_posted = -1, g_isr_left = -1;
+
+static void isr_gives(int line, void *arg) {
+    (void) line; (void) arg;
+    for (int i = 0; i < g_isr_gives; ++i) {
+        int need = 0;
+        hrt_sem_give_from_isr(&g_isr_sem, &need);
+        g_isr_need += need;
+    }
+}
+
+static void t_isr_waiter(void *arg) {
+    (void) arg;
+    hrt_sleep(1); /* the giver checks the unqueued path first */
+    for (;;) {
+        hrt_sem_take(&g_isr_sem);
+        g_isr_woken++;
+    }
+}
+
+static void t_isr_giver(void *arg) {
+    (void) arg;
+    /* Nobody queued: the token is stored at once and nothing is posted */
+    hrt_posix_irq_raise(ISR_LINE);
+    g_isr_stored = hrt_sem_try_take(&g_isr_sem);
+    g_isr_stored_need = g_isr_need;
+
+    hrt_sleep(2); /* the waiter blocks on the semaphore */
+    hrt_posix_irq_raise(ISR_LINE);
+    g_isr_woken_early = g_isr_woken;
+    hrt_yield(); /* switch point: the post is applied here */
+    g_isr_woken_posted = g_isr_woken;
+
+    /* Two more gives than the ring holds: the first extra one wakes the waiter
+       directly, the second finds nobody queued and is stored */
+    g_isr_gives = (int) HARDRT_ISR_DEFER_DEPTH + 2;
+    hrt_posix_irq_raise(ISR_LINE);
+    hrt_yield();
+    g_isr_left = hrt_sem_try_take(&g_isr_sem);
+
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void test_isr_defer_sem(void) {
+    hrt__test_reset_scheduler_state();
+    g_isr_gives = 1;
+    g_isr_need = 0;
+    g_isr_stored = g_isr_stored_need = -1;
+    g_isr_woken = 0;
+    g_isr_woken_early = g_isr_woken_posted = g_isr_left = -1;
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    cfg.tick_src = HRT_TICK_VIRTUAL;
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (isr defer sem)");
+    hrt_sem_init_counting(&g_isr_sem, 0, 64);
+    T_ASSERT_EQ_INT(0, hrt_posix_irq_attach(ISR_LINE, ISR_PRIO, isr_gives, NULL), "attach line");
+
+    static uint32_t s_g[1024], s_w[1024];
+    hrt_task_attr_t p0 = {.priority = HRT_PRIO0, .timeslice = 0};
+    hrt_task_attr_t p1 = {.priority = HRT_PRIO1, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(t_isr_waiter, NULL, s_w, 1024, &p0) >= 0, "created waiter");
+    T_ASSERT_TRUE(hrt_create_task(t_isr_giver, NULL, s_g, 1024, &p1) >= 0, "created giver");
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_isr_stored, "unqueued give visible at once");
+    T_ASSERT_EQ_INT(0, g_isr_stored_need, "unqueued give reports no switch");
+    T_ASSERT_EQ_INT(0, g_isr_woken_early, "posted wake-up waits for the switch point");
+    T_ASSERT_EQ_INT(1, g_isr_woken_posted, "posted wake-up applied at the switch point");
+    T_ASSERT_EQ_INT((int) HARDRT_ISR_DEFER_DEPTH + 3, g_isr_woken, "no give lost when the ring overflows");
+    T_ASSERT_EQ_INT(-1, g_isr_left, "waiter consumed every token");
+    T_ASSERT_EQ_INT(2 + (int) HARDRT_ISR_DEFER_DEPTH, g_isr_need, "posted and direct wake-ups report need_switch");
+
+    hrt_isr_defer_stats_t st;
+    T_ASSERT_EQ_INT(0, hrt_isr_defer_stats(&st), "read stats");
+    T_ASSERT_EQ_UINT(1u + HARDRT_ISR_DEFER_DEPTH, st.posted, "posts counted");
+    T_ASSERT_EQ_UINT(st.posted, st.applied, "every post applied");
+    T_ASSERT_EQ_UINT(1, st.overflows, "overflows counted");
+    T_ASSERT_EQ_UINT(HARDRT_ISR_DEFER_DEPTH, st.high_water, "high-water mark is the ring depth");
+}
+
+static hrt_queue_t g_isr_q;
+static uint32_t g_isr_qbuf[1];
+static volatile uint32_t g_isr_got = 0;
+static volatile uint32_t g_isr_sent_back = 0;
+static volatile int g_isr_q_need = 0;
+
+static void isr_queue(int line, void *arg) {
+    (void) line; (void) arg;
+    const uint32_t v = 0xC0FFEEu;
+    int need = 0;
+    if (hrt_queue_try_send_from_isr(&g_isr_q, &v, &need) == 0) g_isr_q_need += need;
+}
+
+static void isr_queue_drain(int line, void *arg) {
+    (void) line; (void) arg;
+    uint32_t v = 0;
+    int need = 0;
+    if (hrt_queue_try_recv_from_isr(&g_isr_q, &v, &need) == 0) {
+        g_isr_sent_back = v;
+        g_isr_q_need += need;
+    }
+}
+
+static void t_isr_receiver(void *arg) {
+    (void) arg;
+    uint32_t v = 0;
+    hrt_queue_recv(&g_isr_q, &v); /* parks until the line handler's send is applied */
+    g_isr_got = v;
+    /* Fill the queue, then park as a sender until a line handler makes room */
+    v = 1;
+    hrt_queue_send(&g_isr_q, &v);
+    v = 2;
+    hrt_queue_send(&g_isr_q, &v);
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void t_isr_raiser(void *arg) {
+    (void) arg;
+    hrt_posix_irq_raise(ISR_LINE);
+    hrt_yield();
+    hrt_posix_irq_attach(ISR_LINE, ISR_PRIO, isr_queue_drain, NULL);
+    hrt_posix_irq_raise(ISR_LINE);
+    for (;;) hrt_yield();
+}
+
+static void test_isr_defer_queue(void) {
+    hrt__test_reset_scheduler_state();
+    g_isr_got = g_isr_sent_back = 0;
+    g_isr_q_need = 0;
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    cfg.tick_src = HRT_TICK_VIRTUAL;
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (isr defer queue)");
+    hrt_queue_init(&g_isr_q, g_isr_qbuf, 1, sizeof(uint32_t));
+    T_ASSERT_EQ_INT(0, hrt_posix_irq_attach(ISR_LINE, ISR_PRIO, isr_queue, NULL), "attach line");
+
+    static uint32_t s_r[1024], s_s[1024];
+    hrt_task_attr_t hi = {.priority = HRT_PRIO0, .timeslice = 0};
+    hrt_task_attr_t lo = {.priority = HRT_PRIO1, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(t_isr_receiver, NULL, s_r, 1024, &hi) >= 0, "created receiver");
+    T_ASSERT_TRUE(hrt_create_task(t_isr_raiser, NULL, s_s, 1024, &lo) >= 0, "created raiser");
+    hrt_start();
+
+    T_ASSERT_EQ_UINT(0xC0FFEEu, g_isr_got, "receiver woken by the deferred RX wake-up");
+    T_ASSERT_EQ_UINT(1, g_isr_sent_back, "handler received the first queued item");
+    T_ASSERT_EQ_INT(2, g_isr_q_need, "both ISR calls posted a wake-up");
+
+    hrt_isr_defer_stats_t st;
+    T_ASSERT_EQ_INT(0, hrt_isr_defer_stats(&st), "read stats");
+    T_ASSERT_EQ_UINT(2, st.applied, "RX and TX wake-ups applied");
+    T_ASSERT_EQ_UINT(0, st.overflows, "no overflow");
+}
+
+#else
+
+static void test_isr_defer_sem(void) {
+    hrt_isr_defer_stats_t st;
+    T_ASSERT_EQ_INT(-1, hrt_isr_defer_stats(&st), "no post ring without HARDRT_ISR_DEFER");
+    printf("SKIP: deferred ISR post checks require HARDRT_ISR_DEFER=ON.\n");
+}
+
+static void test_isr_defer_queue(void) {
+    printf("SKIP: deferred ISR post checks require HARDRT_ISR_DEFER=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"IsrBracket: nested brackets decide once at the outermost exit", test_isr_bracket},
+    {"IsrDefer: semaphore give applied at the switch point", test_isr_defer_sem},
+    {"IsrDefer: queue wake-ups from a line handler", test_isr_defer_queue},
+};
+
+const test_case_t *get_tests_isr(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -0,0 +1,100 @@
+/* Tests for per-task wake-to-run latency histograms */
+#include <stdio.h>
+
+#include "test_common.h"
+#include "hardrt_sem.h"
+#include "hardrt_latency.h"
+
+#if HARDRT_LATENCY == 1
+
+#define LAT_ROUNDS 20
+
+static hrt_sem_t g_lat_sem;
+static volatile int g_lat_woken = 0;
+
+static void t_waiter(void *arg) {
+    (void) arg;
+    for (;;) {
+        hrt_sem_take(&g_lat_sem);
+        g_lat_woken++;
+    }
+}
+
+static void t_giver(void *arg) {
+    (void) arg;
+    for (int i = 0; i < LAT_ROUNDS; ++i) {
+        hrt_sleep(1);
+        hrt_sem_give(&g_lat_sem);
+    }
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void test_latency_histogram(void) {
+    hrt__test_reset_scheduler_state();
+    g_lat_woken = 0;
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (latency)");
+    hrt_sem_init(&g_lat_sem, 0);
+
+    static uint32_t s_wait[1024], s_give[1024];
+    hrt_task_attr_t hi = {.priority = HRT_PRIO0, .timeslice = 0};
+    hrt_task_attr_t lo = {.priority = HRT_PRIO1, .timeslice = 0};
+    const int waiter = hrt_create_task(t_waiter, NULL, s_wait, 1024, &hi);
+    const int giver = hrt_create_task(t_giver, NULL, s_give, 1024, &lo);
+    T_ASSERT_TRUE(waiter >= 0 && giver >= 0, "created tasks");
+
+    hrt_start();
+    T_ASSERT_EQ_INT(LAT_ROUNDS, g_lat_woken, "waiter woke once per give");
+
+    hrt_latency_t h;
+    T_ASSERT_EQ_INT(0, hrt_task_latency(waiter, &h), "read waiter histogram");
+    T_ASSERT_EQ_UINT(LAT_ROUNDS, h.count, "one sample per semaphore wakeup");
+    T_ASSERT_TRUE(h.min_cycles <= h.p99_cycles && h.p99_cycles <= h.max_cycles, "min <= p99 <= max");
+    T_ASSERT_TRUE(h.sum_cycles >= (uint64_t) h.min_cycles * h.count, "sum consistent with min");
+
+    uint32_t binned = 0;
+    for (uint32_t k = 0; k < HRT_LATENCY_BINS; ++k) binned += h.bins[k];
+    T_ASSERT_EQ_UINT(h.count, binned, "bins add up to count");
+
+    hrt_latency_t g;
+    T_ASSERT_EQ_INT(0, hrt_task_latency(giver, &g), "read giver histogram");
+    T_ASSERT_EQ_UINT(LAT_ROUNDS, g.count, "sleep wakeups counted, preemption resumes not");
+
+    hrt_task_latency_reset(-1);
+    T_ASSERT_EQ_INT(0, hrt_task_latency(waiter, &h), "read after reset");
+    T_ASSERT_EQ_UINT(0, h.count, "reset clears samples");
+    T_ASSERT_EQ_INT(-1, hrt_task_latency(HARDRT_MAX_TASKS, &h), "invalid id rejected");
+}
+
+#else
+
+static void test_latency_histogram(void) {
+    hrt_latency_t h;
+    T_ASSERT_EQ_INT(-1, hrt_task_latency(0, &h), "no histograms without HARDRT_LATENCY");
+    printf("SKIP: latency histogram checks require HARDRT_LATENCY=ON.\n");
+}
+
+#endif
+
+static void test_latency_percentile(void) {
+    hrt_latency_t h = {0};
+    T_ASSERT_EQ_UINT(0, hrt_latency_percentile(&h, 990u), "empty histogram");
+    /* 99 samples in [8,16), one outlier in [1024,2048) */
+    h.count = 100;
+    h.max_cycles = 1500;
+    h.bins[3] = 99;
+    h.bins[10] = 1;
+    T_ASSERT_EQ_UINT(15, hrt_latency_percentile(&h, 990u), "p99 is the upper bound of the common bin");
+    T_ASSERT_EQ_UINT(1500, hrt_latency_percentile(&h, 1000u), "p100 clamps to max");
+}
+
+static const test_case_t CASES[] = {
+    {"Latency: wake-to-run histogram", test_latency_histogram},
+    {"Latency: percentile from bins", test_latency_percentile},
+};
+
+const test_case_t *get_tests_latency(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -10,7 +10,7 @@ static void append_group(const test_case_t *group, int n, const test_case_t **ou
 
 int main(void) {
     /* Collect all test groups in desired order */
-    const test_case_t *registry[64];
+    const test_case_t *registry[128];
     int total = 0;
 
     int n = 0;
@@ -46,8 +46,36 @@ int main(void) {
     append_group(g, n, registry, &total);
     g = get_tests_queue(&n);
     append_group(g, n, registry, &total);
+    g = get_tests_select(&n);
+    append_group(g, n, registry, &total);
     g = get_tests_external_tick(&n);
     append_group(g, n, registry, &total);
+    g = get_tests_virtual_time(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_irq_sim(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_stats(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_trace(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_stack(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_guard(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_latency(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_obj_stats(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_irqoff(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_isr(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_posix_perf(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_posix_prof(&n);
+    append_group(g, n, registry, &total);
+    g = get_tests_posix_shm(&n);
+    append_group(g, n, registry, &total);
     g = get_tests_mutex(&n);
     append_group(g, n, registry, &total);
     g = get_tests_now_ms(&n);
@@ -378,6 +378,158 @@ static void test_mutex_try_lock_fails_when_busy(void) {
     T_ASSERT_EQ_INT(0, g_watchdog_tripped, "watchdog should not trip in busy try_lock test");
 }
 
+/* ---- Case 9: the lock word drops its waiter flag with the last handoff ---- */
+static hrt_mutex_t g_mutex_word;
+static volatile uint8_t g_word_after_handoff = 0xFF;
+static volatile int g_word_relock_rc = 1234;
+
+static void t_word_waiter(void *arg) {
+    (void)arg;
+    hrt_mutex_lock(&g_mutex_word);
+    g_word_after_handoff = g_mutex_word.locked;
+    hrt_mutex_unlock(&g_mutex_word);
+    /* Uncontended again: lock and unlock without a waiter queue */
+    g_word_relock_rc = hrt_mutex_try_lock(&g_mutex_word) + hrt_mutex_unlock(&g_mutex_word);
+    hrt__test_stop_scheduler();
+}
+
+static void t_word_owner(void *arg) {
+    (void)arg;
+    hrt_mutex_lock(&g_mutex_word);
+    hrt_sleep(20);
+    hrt_mutex_unlock(&g_mutex_word);
+    hrt_sleep(100);
+}
+
+static void test_mutex_lock_word_after_contention(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_word_after_handoff = 0xFF;
+    g_word_relock_rc = 1234;
+    hrt_mutex_init(&g_mutex_word);
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], so[1024], sw[1024];
+    hrt_task_attr_t p = {.priority = HRT_PRIO1, .timeslice = 5};
+
+    hrt_create_task(t_word_owner, NULL, so, 1024, &p);
+    hrt_create_task(t_word_waiter, NULL, sw, 1024, &p);
+    hrt_create_task(watchdog_task, (void *)(uintptr_t)300, swd, 1024, &p);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "watchdog should not trip in lock word test");
+    T_ASSERT_EQ_UINT(HRT_MUTEX_HELD, g_word_after_handoff, "handoff to the last waiter clears the waiter flag");
+    T_ASSERT_EQ_INT(0, g_word_relock_rc, "uncontended lock/unlock after contention");
+    T_ASSERT_EQ_UINT(0u, g_mutex_word.locked, "mutex free at the end");
+    T_ASSERT_EQ_INT(HRT_MUTEX_NO_OWNER, g_mutex_word.owner, "no owner at the end");
+}
+
+/* ---- Case 10: barging release frees the mutex without a switch ---- */
+static hrt_mutex_t g_mutex_barge;
+static volatile int g_barge_relock_rc = 1234;
+static volatile int g_barge_waiter_rc = 1234;
+static volatile int g_barge_waiter_ran_early = 0;
+static volatile int g_barge_waiter_done = 0;
+
+static void t_barge_waiter(void *arg) {
+    (void)arg;
+    g_barge_waiter_rc = hrt_mutex_lock(&g_mutex_barge);
+    g_barge_waiter_done = 1;
+    hrt_mutex_unlock(&g_mutex_barge);
+    hrt__test_stop_scheduler();
+}
+
+static void t_barge_owner(void *arg) {
+    (void)arg;
+    hrt_mutex_lock(&g_mutex_barge);
+    hrt_sleep(20); /* the waiter queues up */
+    hrt_mutex_unlock(&g_mutex_barge);
+    /* Barging: no handoff and no yield, so the lock is free for the caller again */
+    g_barge_relock_rc = hrt_mutex_try_lock(&g_mutex_barge);
+    g_barge_waiter_ran_early = g_barge_waiter_done;
+    hrt_yield(); /* the woken waiter loses the race and re-queues */
+    hrt_mutex_unlock(&g_mutex_barge);
+    hrt_sleep(100);
+}
+
+static void test_mutex_barging_release(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_barge_relock_rc = 1234;
+    g_barge_waiter_rc = 1234;
+    g_barge_waiter_ran_early = 0;
+    g_barge_waiter_done = 0;
+    hrt_mutex_init_mode(&g_mutex_barge, HRT_MUTEX_BARGING);
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], so[1024], sw[1024];
+    hrt_task_attr_t p = {.priority = HRT_PRIO1, .timeslice = 5};
+
+    hrt_create_task(t_barge_owner, NULL, so, 1024, &p);
+    hrt_create_task(t_barge_waiter, NULL, sw, 1024, &p);
+    hrt_create_task(watchdog_task, (void *)(uintptr_t)300, swd, 1024, &p);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "watchdog should not trip in barging test");
+    T_ASSERT_EQ_INT(0, g_barge_relock_rc, "releasing task re-locks a barging mutex");
+    T_ASSERT_EQ_INT(0, g_barge_waiter_ran_early, "unlock did not switch to the waiter");
+    T_ASSERT_EQ_INT(0, g_barge_waiter_rc, "waiter acquires after losing one race");
+    T_ASSERT_EQ_INT(1, g_barge_waiter_done, "waiter ran its critical section");
+    T_ASSERT_EQ_UINT(0u, g_mutex_barge.locked, "mutex free at the end");
+}
+
+/* ---- Case 11: a barging unlock still yields to a higher-priority waiter ---- */
+static hrt_mutex_t g_mutex_barge_hi;
+static volatile int g_barge_hi_got = 0;
+static volatile int g_barge_hi_seen_by_owner = 0;
+
+static void t_barge_hi_waiter(void *arg) {
+    (void)arg;
+    hrt_sleep(5); /* let the owner take the lock first */
+    hrt_mutex_lock(&g_mutex_barge_hi);
+    g_barge_hi_got = 1;
+    hrt_mutex_unlock(&g_mutex_barge_hi);
+}
+
+static void t_barge_lo_owner(void *arg) {
+    (void)arg;
+    hrt_mutex_lock(&g_mutex_barge_hi);
+    hrt_sleep(20);
+    hrt_mutex_unlock(&g_mutex_barge_hi);
+    g_barge_hi_seen_by_owner = g_barge_hi_got;
+    hrt__test_stop_scheduler();
+}
+
+static void test_mutex_barging_yields_to_higher_prio(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_barge_hi_got = 0;
+    g_barge_hi_seen_by_owner = 0;
+    hrt_mutex_init_mode(&g_mutex_barge_hi, HRT_MUTEX_BARGING);
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], so[1024], sw[1024];
+    hrt_task_attr_t hi = {.priority = HRT_PRIO0, .timeslice = 5};
+    hrt_task_attr_t lo = {.priority = HRT_PRIO2, .timeslice = 5};
+
+    hrt_create_task(t_barge_lo_owner, NULL, so, 1024, &lo);
+    hrt_create_task(t_barge_hi_waiter, NULL, sw, 1024, &hi);
+    hrt_create_task(watchdog_task, (void *)(uintptr_t)300, swd, 1024, &lo);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "watchdog should not trip in barging priority test");
+    T_ASSERT_EQ_INT(1, g_barge_hi_seen_by_owner, "higher-priority waiter took the lock before unlock returned");
+}
+
 static const test_case_t CASES[] = {
     {"Mutex: try_lock / unlock basic", test_mutex_try_lock_and_unlock_basic},
     {"Mutex: recursive try_lock fails", test_mutex_recursive_try_lock_fails},
@@ -386,7 +538,10 @@ static const test_case_t CASES[] = {
     {"Mutex: non-owner unlock fails", test_mutex_non_owner_unlock_fails},
     {"Mutex: wake is direct handoff", test_mutex_wake_is_direct_handoff},
     {"Mutex: init idempotency", test_mutex_init_idempotency},
-    {"Mutex: try_lock fails when busy", test_mutex_try_lock_fails_when_busy}
+    {"Mutex: try_lock fails when busy", test_mutex_try_lock_fails_when_busy},
+    {"Mutex: lock word after contention", test_mutex_lock_word_after_contention},
+    {"Mutex: barging release", test_mutex_barging_release},
+    {"Mutex: barging unlock yields to higher priority", test_mutex_barging_yields_to_higher_prio}
 };
 
 const test_case_t *get_tests_mutex(int *out_count) {
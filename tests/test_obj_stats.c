@@ -0,0 +1,206 @@
+/* Tests for semaphore, mutex and queue contention statistics */
+#include <stdio.h>
+
+#include "test_common.h"
+#include "hardrt_sem.h"
+#include "hardrt_mutex.h"
+#include "hardrt_queue.h"
+#include "hardrt_objstats.h"
+
+#if HARDRT_OBJ_STATS == 1
+
+#define OS_ITEMS 6
+
+static hrt_queue_t g_os_q;
+static uint32_t g_os_qbuf[4];
+static volatile int g_os_recv = 0;
+static volatile int g_os_try_fail = 0;
+
+static void t_os_producer(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < OS_ITEMS; ++i) {
+        hrt_queue_send(&g_os_q, &i);
+    }
+    for (;;) {
+        hrt_sleep(10);
+    }
+}
+
+static void t_os_consumer(void *arg) {
+    (void) arg;
+    hrt_sleep(5); /* let the producer fill the queue and stall */
+    uint32_t v;
+    for (int i = 0; i < OS_ITEMS; ++i) {
+        if (hrt_queue_recv(&g_os_q, &v) == 0 && v == (uint32_t) i) g_os_recv++;
+    }
+    g_os_try_fail = hrt_queue_try_recv(&g_os_q, &v) != 0;
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void test_obj_stats_queue(void) {
+    hrt__test_reset_scheduler_state();
+    g_os_recv = 0;
+    g_os_try_fail = 0;
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (obj stats queue)");
+    hrt_queue_init(&g_os_q, g_os_qbuf, 4, sizeof(uint32_t));
+
+    static uint32_t s_prod[1024], s_cons[1024];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(t_os_producer, NULL, s_prod, 1024, &a) >= 0, "created producer");
+    T_ASSERT_TRUE(hrt_create_task(t_os_consumer, NULL, s_cons, 1024, &a) >= 0, "created consumer");
+
+    hrt_start();
+    T_ASSERT_EQ_INT(OS_ITEMS, g_os_recv, "items received in order");
+    T_ASSERT_TRUE(g_os_try_fail, "try_recv on the drained queue fails");
+
+    hrt_obj_stats_t st;
+    T_ASSERT_EQ_INT(0, hrt_obj_stats(&g_os_q, HRT_OBJ_QUEUE, &st), "read queue stats");
+    T_ASSERT_EQ_UINT(2 * OS_ITEMS, st.ops, "every send and receive counted");
+    T_ASSERT_EQ_UINT(4, st.high_water, "high-water mark is the capacity");
+    T_ASSERT_TRUE(st.full_stalls >= 1, "producer stalled on a full queue");
+    T_ASSERT_TRUE(st.empty_stalls >= 1, "drained queue counted as an empty stall");
+    T_ASSERT_EQ_UINT(1, st.failed, "only the final try_recv failed");
+    T_ASSERT_TRUE(st.contended >= 1 && st.contended <= st.full_stalls + st.empty_stalls, "waits bounded by stalls");
+    T_ASSERT_TRUE(st.max_blocked_cycles > 0 && st.blocked_cycles >= st.max_blocked_cycles, "blocked time recorded");
+    T_ASSERT_EQ_UINT(OS_ITEMS, st.latency_samples, "every shallow item timed");
+    /* The first item waited out the consumer's 5-tick sleep */
+    T_ASSERT_TRUE(st.max_latency_cycles >= (uint64_t) st.cycles_hz * 4u / 1000u, "latency covers the stall");
+    T_ASSERT_TRUE(st.latency_cycles >= st.max_latency_cycles, "latency sum consistent with max");
+    T_ASSERT_EQ_UINT(0, st.hold_cycles, "no hold time on a queue");
+
+    T_ASSERT_EQ_INT(0, hrt_obj_stats_reset(&g_os_q, HRT_OBJ_QUEUE), "reset");
+    T_ASSERT_EQ_INT(0, hrt_obj_stats(&g_os_q, HRT_OBJ_QUEUE, &st), "read after reset");
+    T_ASSERT_EQ_UINT(0, st.ops, "reset clears counters");
+}
+
+static hrt_mutex_t g_os_m;
+static volatile int g_os_try_lock = 0;
+
+static void t_os_holder(void *arg) {
+    (void) arg;
+    hrt_mutex_lock(&g_os_m);
+    hrt_sleep(3);
+    hrt_mutex_unlock(&g_os_m);
+    for (;;) {
+        hrt_sleep(10);
+    }
+}
+
+static void t_os_waiter(void *arg) {
+    (void) arg;
+    hrt_sleep(1);
+    g_os_try_lock = hrt_mutex_try_lock(&g_os_m);
+    hrt_mutex_lock(&g_os_m);
+    hrt_mutex_unlock(&g_os_m);
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void test_obj_stats_mutex(void) {
+    hrt__test_reset_scheduler_state();
+    g_os_try_lock = 0;
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (obj stats mutex)");
+    hrt_mutex_init(&g_os_m);
+
+    static uint32_t s_hold[1024], s_wait[1024];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(t_os_holder, NULL, s_hold, 1024, &a) >= 0, "created holder");
+    T_ASSERT_TRUE(hrt_create_task(t_os_waiter, NULL, s_wait, 1024, &a) >= 0, "created waiter");
+
+    hrt_start();
+    T_ASSERT_EQ_INT(-1, g_os_try_lock, "try_lock failed while held");
+
+    hrt_obj_stats_t st;
+    T_ASSERT_EQ_INT(0, hrt_obj_stats(&g_os_m, HRT_OBJ_MUTEX, &st), "read mutex stats");
+    T_ASSERT_EQ_UINT(2, st.ops, "two acquisitions");
+    T_ASSERT_EQ_UINT(1, st.contended, "second lock waited for the handoff");
+    T_ASSERT_EQ_UINT(1, st.failed, "failed try_lock counted");
+    T_ASSERT_TRUE(st.max_blocked_cycles >= (uint64_t) st.cycles_hz / 1000u, "wait spans the holder's sleep");
+    T_ASSERT_TRUE(st.max_hold_cycles >= (uint64_t) st.cycles_hz * 2u / 1000u, "hold spans the holder's sleep");
+    T_ASSERT_TRUE(st.hold_cycles >= st.max_hold_cycles, "hold sum consistent with max");
+}
+
+static void test_obj_stats_registry(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (obj registry)");
+
+    static hrt_sem_t sems[HARDRT_OBJ_REGISTRY + 1];
+    static hrt_mutex_t m;
+    static hrt_queue_t q;
+    static uint8_t qbuf[2];
+    hrt_sem_init(&sems[0], 0);
+    hrt_mutex_init(&m);
+    hrt_queue_init(&q, qbuf, 2, 1);
+
+    const int empty = hrt_sem_try_take(&sems[0]);
+    T_ASSERT_EQ_INT(-1, empty, "empty semaphore");
+    hrt_sem_give(&sems[0]);
+    const int took = hrt_sem_try_take(&sems[0]);
+    T_ASSERT_EQ_INT(0, took, "take");
+
+    T_ASSERT_EQ_INT(0, hrt_obj_register(&sems[0], HRT_OBJ_SEM, "sem"), "register sem");
+    T_ASSERT_EQ_INT(0, hrt_obj_register(&m, HRT_OBJ_MUTEX, "mutex"), "register mutex");
+    T_ASSERT_EQ_INT(0, hrt_obj_register(&q, HRT_OBJ_QUEUE, "queue"), "register queue");
+    T_ASSERT_EQ_INT(-1, hrt_obj_register(&q, (hrt_obj_kind_t) 0, "bad"), "bad kind rejected");
+
+    hrt_obj_info_t info;
+    T_ASSERT_EQ_INT(0, hrt_obj_enum(0, &info), "enum 0");
+    T_ASSERT_TRUE(info.obj == &sems[0] && info.kind == HRT_OBJ_SEM, "first entry is the semaphore");
+    T_ASSERT_EQ_UINT(1, info.stats.ops, "semaphore take counted");
+    T_ASSERT_EQ_UINT(1, info.stats.failed, "failed try_take counted");
+
+    hrt_obj_unregister(&m);
+    T_ASSERT_EQ_INT(0, hrt_obj_enum(1, &info), "enum 1 after unregister");
+    T_ASSERT_TRUE(info.obj == &q, "order kept after unregister");
+    T_ASSERT_EQ_INT(-1, hrt_obj_enum(2, &info), "past the end");
+
+    T_ASSERT_EQ_INT(0, hrt_obj_register(&q, HRT_OBJ_QUEUE, "renamed"), "re-register");
+    T_ASSERT_EQ_INT(0, hrt_obj_enum(1, &info), "enum renamed");
+    T_ASSERT_STREQ("renamed", info.name, "name updated in place");
+
+    int n = 2;
+    for (int i = 1; i <= (int) HARDRT_OBJ_REGISTRY; ++i) {
+        hrt_sem_init(&sems[i], 0);
+        if (hrt_obj_register(&sems[i], HRT_OBJ_SEM, NULL) == 0) n++;
+    }
+    T_ASSERT_EQ_INT((int) HARDRT_OBJ_REGISTRY, n, "registry fills up");
+
+    for (int i = 0; i <= (int) HARDRT_OBJ_REGISTRY; ++i) hrt_obj_unregister(&sems[i]);
+    hrt_obj_unregister(&q);
+    T_ASSERT_EQ_INT(-1, hrt_obj_enum(0, &info), "registry empty again");
+}
+
+#else
+
+static void test_obj_stats_queue(void) {
+    hrt_obj_stats_t st = {0};
+    T_ASSERT_EQ_INT(-1, hrt_obj_stats(&st, HRT_OBJ_QUEUE, &st), "no counters without HARDRT_OBJ_STATS");
+    printf("SKIP: object statistics checks require HARDRT_OBJ_STATS=ON.\n");
+}
+
+static void test_obj_stats_mutex(void) {
+    printf("SKIP: object statistics checks require HARDRT_OBJ_STATS=ON.\n");
+}
+
+static void test_obj_stats_registry(void) {
+    hrt_obj_info_t info = {0};
+    T_ASSERT_EQ_INT(-1, hrt_obj_register(&info, HRT_OBJ_SEM, "x"), "no registry without HARDRT_OBJ_STATS");
+    T_ASSERT_EQ_INT(-1, hrt_obj_enum(0, &info), "registry empty");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"ObjStats: queue occupancy, stalls and latency", test_obj_stats_queue},
+    {"ObjStats: mutex contention and hold time", test_obj_stats_mutex},
+    {"ObjStats: registry", test_obj_stats_registry},
+};
+
+const test_case_t *get_tests_obj_stats(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -0,0 +1,82 @@
+/* Tests for per-task perf_event counters on the POSIX port */
+#include <stdio.h>
+
+#include "test_common.h"
+#include "hardrt_time.h"
+#include "hardrt_posix.h"
+
+#if HARDRT_POSIX_PERF == 1
+
+static void spin(const uint32_t n) {
+    volatile uint32_t x = 0;
+    for (uint32_t i = 0; i < n; ++i) x += i;
+}
+
+static void t_heavy(void *arg) {
+    (void) arg;
+    spin(4000000u);
+    hrt_sleep(1000);
+}
+
+static void t_light(void *arg) {
+    (void) arg;
+    spin(1000u);
+    hrt_sleep(1000);
+}
+
+static void test_perf_charged_per_task(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY, .tick_src = HRT_TICK_VIRTUAL};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (perf)");
+
+    const uint32_t avail = hrt_posix_perf_available();
+    if (avail == 0) {
+        printf("SKIP: perf_event_open() refused on this host (see perf_event_paranoid).\n");
+        return;
+    }
+    /* Prefer retired instructions; a host without a PMU still has the task clock */
+    const int ev = (avail & (1u << HRT_POSIX_PERF_INSTRUCTIONS)) ? HRT_POSIX_PERF_INSTRUCTIONS
+                                                                 : HRT_POSIX_PERF_TASK_CLOCK;
+    T_ASSERT_TRUE(avail & (1u << ev), "instructions or task clock available");
+
+    static uint32_t s_heavy[1024], s_light[1024];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    const int heavy = hrt_create_task(t_heavy, NULL, s_heavy, 1024, &a);
+    const int light = hrt_create_task(t_light, NULL, s_light, 1024, &a);
+    T_ASSERT_TRUE(heavy >= 0 && light >= 0, "created tasks");
+
+    hrt_sim_run_for(0);
+
+    hrt_posix_perf_t h, l;
+    T_ASSERT_EQ_INT(0, hrt_posix_perf_task(heavy, &h), "read heavy task counters");
+    T_ASSERT_EQ_INT(0, hrt_posix_perf_task(light, &l), "read light task counters");
+    T_ASSERT_EQ_UINT(1, h.runs, "heavy task switched in once");
+    T_ASSERT_EQ_UINT(1, l.runs, "light task switched in once");
+    /* The task clock also charges switch-in/out overhead to both tasks: keep the margin loose */
+    T_ASSERT_TRUE(h.count[ev] > 10u * l.count[ev], "heavy task charged far more than light task");
+
+    hrt_posix_perf_reset();
+    T_ASSERT_EQ_INT(0, hrt_posix_perf_task(heavy, &h), "read after reset");
+    T_ASSERT_TRUE(h.runs == 0 && h.count[ev] == 0, "reset clears counters");
+    T_ASSERT_EQ_INT(-1, hrt_posix_perf_task(HARDRT_MAX_TASKS, &h), "invalid id rejected");
+}
+
+#else
+
+static void test_perf_charged_per_task(void) {
+    hrt_posix_perf_t p;
+    T_ASSERT_EQ_INT(-1, hrt_posix_perf_task(0, &p), "no counters without HARDRT_POSIX_PERF");
+    T_ASSERT_EQ_UINT(0, hrt_posix_perf_available(), "nothing available");
+    printf("SKIP: perf counter checks require HARDRT_POSIX_PERF=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"Perf: counters charged per task", test_perf_charged_per_task},
+};
+
+const test_case_t *get_tests_posix_perf(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -0,0 +1,111 @@
+/* Tests for the SIGPROF sampling profiler on the POSIX port */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "test_common.h"
+#include "hardrt_time.h"
+#include "hardrt_posix.h"
+
+#if HARDRT_POSIX_PROF == 1
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+/* Not static: -rdynamic exports it, so the folded stacks show its name */
+__attribute__((noinline)) void prof_test_burn(const uint64_t ns) {
+    volatile uint32_t x = 0;
+    const uint64_t end = thread_cpu_ns() + ns;
+    while (thread_cpu_ns() < end) {
+        for (uint32_t i = 0; i < 1000u; ++i) x += i;
+    }
+}
+
+static void t_heavy(void *arg) {
+    (void) arg;
+    prof_test_burn(100u * 1000u * 1000u); /* 100 ms of CPU */
+    hrt_sleep(1000);
+}
+
+static void t_light(void *arg) {
+    (void) arg;
+    volatile uint32_t x = 0;
+    for (uint32_t i = 0; i < 1000u; ++i) x += i;
+    hrt_sleep(1000);
+}
+
+static void test_prof_samples_per_task(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY, .tick_src = HRT_TICK_VIRTUAL};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (prof)");
+
+    static uint32_t s_heavy[4096], s_light[4096];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    const int heavy = hrt_create_task(t_heavy, NULL, s_heavy, 4096, &a);
+    const int light = hrt_create_task(t_light, NULL, s_light, 4096, &a);
+    T_ASSERT_TRUE(heavy >= 0 && light >= 0, "created tasks");
+
+    hrt_posix_prof_reset();
+    T_ASSERT_EQ_INT(0, hrt_posix_prof_start(1000u), "profiler started");
+    hrt_sim_run_for(0);
+    hrt_posix_prof_stop();
+
+    hrt_posix_prof_stats_t st;
+    T_ASSERT_EQ_INT(0, hrt_posix_prof_stats(&st), "read stats");
+    const uint32_t h = hrt_posix_prof_task_samples(heavy);
+    const uint32_t l = hrt_posix_prof_task_samples(light);
+    printf("prof: samples=%u stacks=%u dropped=%u heavy=%u light=%u\n",
+           (unsigned) st.samples, (unsigned) st.stacks, (unsigned) st.dropped, (unsigned) h, (unsigned) l);
+    /* 100 ms at 1 kHz; generous margin for coarse CPU-timer expiry */
+    T_ASSERT_TRUE(h >= 30u, "heavy task sampled");
+    T_ASSERT_TRUE(h > 4u * l, "samples follow CPU time");
+    T_ASSERT_EQ_UINT(0, st.dropped, "no stacks dropped");
+
+    char path[] = "/tmp/hardrt_prof_XXXXXX";
+    const int fd = mkstemp(path);
+    T_ASSERT_TRUE(fd >= 0, "temp file");
+    close(fd);
+    T_ASSERT_EQ_INT(0, hrt_posix_prof_dump(path), "folded stacks written");
+
+    char want[32];
+    snprintf(want, sizeof(want), "task%d;", heavy);
+    int found = 0;
+    char line[4096];
+    FILE *f = fopen(path, "r");
+    while (f && fgets(line, sizeof(line), f)) {
+        if (strncmp(line, want, strlen(want)) == 0 && strstr(line, ";prof_test_burn")) found = 1;
+    }
+    if (f) fclose(f);
+    remove(path);
+    T_ASSERT_TRUE(found, "heavy task stack names its burn function");
+
+    hrt_posix_prof_reset();
+    T_ASSERT_EQ_INT(0, hrt_posix_prof_stats(&st), "read stats after reset");
+    T_ASSERT_TRUE(st.samples == 0 && st.stacks == 0 && hrt_posix_prof_task_samples(heavy) == 0,
+                  "reset clears samples");
+}
+
+#else
+
+static void test_prof_samples_per_task(void) {
+    hrt_posix_prof_stats_t st;
+    T_ASSERT_EQ_INT(-1, hrt_posix_prof_start(0), "no profiler without HARDRT_POSIX_PROF");
+    T_ASSERT_EQ_INT(-1, hrt_posix_prof_stats(&st), "no stats");
+    printf("SKIP: profiler checks require HARDRT_POSIX_PROF=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"Prof: samples charged per task", test_prof_samples_per_task},
+};
+
+const test_case_t *get_tests_posix_prof(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -0,0 +1,105 @@
+/* Tests for the shared-memory telemetry page on the POSIX port */
+#include <stdio.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "hardrt_time.h"
+#include "hardrt_queue.h"
+#include "hardrt_posix.h"
+
+#if HARDRT_POSIX_SHM == 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static hrt_queue_t g_q;
+static uint8_t g_q_buf[4 * sizeof(uint32_t)];
+
+static void t_producer(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < 3u; ++i) hrt_queue_try_send(&g_q, &i);
+    hrt_sleep(5);
+    hrt_sleep(1000);
+}
+
+static void t_sleeper(void *arg) {
+    (void) arg;
+    hrt_sleep(1000);
+}
+
+static void test_shm_page_published(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY, .tick_src = HRT_TICK_VIRTUAL};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (shm)");
+
+    const char *name = hrt_posix_shm_name();
+    if (!name) {
+        printf("SKIP: shm_open() refused on this host.\n");
+        return;
+    }
+    const int fd = shm_open(name, O_RDONLY, 0);
+    T_ASSERT_TRUE(fd >= 0, "page opens read-only by name");
+    void *map = mmap(NULL, sizeof(hrt_shm_page_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    T_ASSERT_TRUE(map != MAP_FAILED, "page maps");
+    if (map == MAP_FAILED) return;
+    const hrt_shm_page_t *page = map;
+    T_ASSERT_EQ_UINT(HRT_SHM_MAGIC, page->magic, "magic");
+    T_ASSERT_EQ_UINT(sizeof(hrt_shm_page_t), page->page_bytes, "layout size");
+    T_ASSERT_EQ_UINT(HARDRT_MAX_TASKS, page->max_tasks, "task slots");
+    T_ASSERT_EQ_UINT(0, page->seq & 1u, "seqlock even at rest");
+
+    hrt_queue_init(&g_q, g_q_buf, 4, sizeof(uint32_t));
+    const int slot = hrt_posix_shm_watch("work_q", &g_q, HRT_SHM_OBJ_QUEUE);
+    T_ASSERT_EQ_INT(0, slot, "queue watched");
+    T_ASSERT_EQ_INT(-1, hrt_posix_shm_watch("bad", &g_q, HRT_SHM_OBJ_NONE), "kind checked");
+
+    static uint32_t s_prod[1024], s_sleep[1024];
+    hrt_task_attr_t hi = {.priority = HRT_PRIO0, .timeslice = 0};
+    hrt_task_attr_t lo = {.priority = HRT_PRIO2, .timeslice = 3};
+    const int prod = hrt_create_task(t_producer, NULL, s_prod, 1024, &hi);
+    const int sleeper = hrt_create_task(t_sleeper, NULL, s_sleep, 1024, &lo);
+    T_ASSERT_TRUE(prod >= 0 && sleeper >= 0, "created tasks");
+
+    hrt_sim_run_for(10);
+    hrt_posix_shm_update();
+
+    T_ASSERT_EQ_UINT(0, page->seq & 1u, "seqlock even after update");
+    T_ASSERT_EQ_UINT(10, page->tick, "tick published");
+    T_ASSERT_EQ_INT(-1, page->current, "host code between runs");
+    T_ASSERT_EQ_UINT(2, page->task[prod].switches_in, "producer ran twice (start, wake)");
+    T_ASSERT_EQ_UINT(1, page->task[sleeper].switches_in, "sleeper ran once");
+    T_ASSERT_EQ_UINT(HRT_SHM_SLEEP, page->task[prod].state, "producer sleeping");
+    T_ASSERT_EQ_UINT(HRT_PRIO2, page->task[sleeper].prio, "priority published");
+    T_ASSERT_EQ_UINT(3, page->task[sleeper].timeslice, "slice published");
+    T_ASSERT_EQ_UINT(HRT_SHM_UNUSED, page->task[sleeper + 1].state, "free slot unused");
+    T_ASSERT_TRUE(page->switches >= 3u, "switches counted");
+    T_ASSERT_EQ_UINT(1, page->nobjs, "one object");
+    T_ASSERT_TRUE(strcmp(page->obj[0].name, "work_q") == 0, "object name");
+    T_ASSERT_EQ_UINT(3, page->obj[0].level, "queue depth");
+    T_ASSERT_EQ_UINT(4, page->obj[0].capacity, "queue capacity");
+
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "re-init");
+    T_ASSERT_EQ_UINT(0, page->nobjs, "hrt_init clears watches");
+    T_ASSERT_EQ_UINT(0, page->task[prod].switches_in, "hrt_init clears tasks");
+    munmap(map, sizeof(hrt_shm_page_t));
+}
+
+#else
+
+static void test_shm_page_published(void) {
+    T_ASSERT_TRUE(hrt_posix_shm_name() == NULL, "no page without HARDRT_POSIX_SHM");
+    T_ASSERT_EQ_INT(-1, hrt_posix_shm_watch("q", "", HRT_SHM_OBJ_QUEUE), "watch unavailable");
+    printf("SKIP: telemetry page checks require HARDRT_POSIX_SHM=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"Shm: telemetry page published", test_shm_page_published},
+};
+
+const test_case_t *get_tests_posix_shm(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
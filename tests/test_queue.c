@@ -234,12 +234,240 @@ static void test_queue_isr_basic(void) {
     T_ASSERT_EQ_INT(0, need_switch, "No switch needed");
 }
 
+/* ---- Case 6: a blocked receiver gets the item straight into its buffer ---- */
+static int g_ho_rx_val = 0; /* receiver buffer, read through a volatile access */
+static volatile int g_ho_rx_ran = 0;
+static volatile int g_ho_rx_seen_val = -1;
+static volatile int g_ho_rx_seen_count = -1;
+static volatile int g_ho_rx_seen_ran = -1;
+
+static void t_ho_receiver(void *arg) {
+    (void) arg;
+    hrt_queue_recv(&g_q_block, &g_ho_rx_val);
+    g_ho_rx_ran = 1;
+    for(;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void t_ho_sender(void *arg) {
+    (void) arg;
+    hrt_sleep(10);
+    int val = 77;
+    hrt_queue_send(&g_q_block, &val);
+    /* Higher priority than the receiver: it has not run yet, but already holds the item */
+    g_ho_rx_seen_val = *(volatile int *) &g_ho_rx_val;
+    g_ho_rx_seen_count = hrt_queue_count(&g_q_block);
+    g_ho_rx_seen_ran = g_ho_rx_ran;
+    hrt_sleep(10);
+    hrt__test_stop_scheduler();
+    for(;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void test_queue_handoff_to_receiver(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_ho_rx_val = 0;
+    g_ho_rx_ran = 0;
+    g_ho_rx_seen_val = g_ho_rx_seen_count = g_ho_rx_seen_ran = -1;
+
+    uint32_t storage[2];
+    hrt_queue_init(&g_q_block, storage, 2, sizeof(int));
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], s1[1024], s2[1024];
+    hrt_task_attr_t prio_hi = {.priority = HRT_PRIO0, .timeslice = 3};
+    hrt_task_attr_t prio_mid = {.priority = HRT_PRIO1, .timeslice = 3};
+    hrt_task_attr_t prio_lo = {.priority = HRT_PRIO2, .timeslice = 3};
+
+    hrt_create_task(watchdog_task, (void *) (uintptr_t) 200, swd, 1024, &prio_lo);
+    hrt_create_task(t_ho_receiver, NULL, s1, 1024, &prio_mid);
+    hrt_create_task(t_ho_sender, NULL, s2, 1024, &prio_hi);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "Watchdog should not trip");
+    T_ASSERT_EQ_INT(77, g_ho_rx_seen_val, "Item landed in the receiver's buffer at send time");
+    T_ASSERT_EQ_INT(0, g_ho_rx_seen_count, "Item never went through the ring");
+    T_ASSERT_EQ_INT(0, g_ho_rx_seen_ran, "Receiver had not run yet");
+    T_ASSERT_EQ_INT(1, g_ho_rx_ran, "Receiver returned afterwards");
+}
+
+/* ---- Case 7: a receiver refills the slot it frees from a blocked sender ---- */
+static volatile int g_ho_tx_done = 0;
+static volatile int g_ho_tx_seen_count = -1;
+static volatile int g_ho_tx_seen_done = -1;
+static volatile int g_ho_tx_vals[2] = {0, 0};
+
+static void t_ho_tx_sender(void *arg) {
+    (void) arg;
+    int val = 1;
+    hrt_queue_send(&g_q_block, &val);
+    val = 2;
+    hrt_queue_send(&g_q_block, &val); /* capacity 1: blocks */
+    g_ho_tx_done = 1;
+    for(;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void t_ho_tx_receiver(void *arg) {
+    (void) arg;
+    hrt_sleep(10);
+    int out = 0;
+    hrt_queue_recv(&g_q_block, &out);
+    g_ho_tx_vals[0] = out;
+    g_ho_tx_seen_count = hrt_queue_count(&g_q_block);
+    g_ho_tx_seen_done = g_ho_tx_done;
+    hrt_queue_recv(&g_q_block, &out);
+    g_ho_tx_vals[1] = out;
+    hrt_sleep(10);
+    hrt__test_stop_scheduler();
+    for(;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void test_queue_handoff_from_sender(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_ho_tx_done = 0;
+    g_ho_tx_seen_count = g_ho_tx_seen_done = -1;
+    g_ho_tx_vals[0] = g_ho_tx_vals[1] = 0;
+
+    uint32_t storage[1];
+    hrt_queue_init(&g_q_block, storage, 1, sizeof(int));
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], s1[1024], s2[1024];
+    hrt_task_attr_t prio_hi = {.priority = HRT_PRIO0, .timeslice = 3};
+    hrt_task_attr_t prio_mid = {.priority = HRT_PRIO1, .timeslice = 3};
+    hrt_task_attr_t prio_lo = {.priority = HRT_PRIO2, .timeslice = 3};
+
+    hrt_create_task(watchdog_task, (void *) (uintptr_t) 200, swd, 1024, &prio_lo);
+    hrt_create_task(t_ho_tx_sender, NULL, s1, 1024, &prio_mid);
+    hrt_create_task(t_ho_tx_receiver, NULL, s2, 1024, &prio_hi);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "Watchdog should not trip");
+    T_ASSERT_EQ_INT(1, g_ho_tx_seen_count, "Blocked sender's item moved into the freed slot");
+    T_ASSERT_EQ_INT(0, g_ho_tx_seen_done, "Sender had not run yet");
+    T_ASSERT_EQ_INT(1, g_ho_tx_vals[0], "First item first");
+    T_ASSERT_EQ_INT(2, g_ho_tx_vals[1], "Handed-off item second");
+    T_ASSERT_EQ_INT(1, g_ho_tx_done, "Sender returned afterwards");
+}
+
+/* ---- Case 8: typed queue from HRT_QUEUE_DEFINE ---- */
+typedef struct {
+    uint32_t seq;
+    uint32_t tag;
+} typed_msg_t;
+
+HRT_QUEUE_DEFINE(g_typed_q, typed_msg_t, 4)
+
+static volatile uint32_t g_typed_rx_seq = 0;
+
+static void t_typed_receiver(void *arg) {
+    (void) arg;
+    typed_msg_t m = {0, 0};
+    g_typed_q_recv(&m); /* blocks: the typed send below hands over through the generic waiter path */
+    g_typed_rx_seq = m.seq;
+    hrt__test_stop_scheduler();
+    for(;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void t_typed_sender(void *arg) {
+    (void) arg;
+    hrt_sleep(10);
+    const typed_msg_t m = {.seq = 4242u, .tag = 7u};
+    g_typed_q_send(&m);
+    for(;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void test_queue_typed_define(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_typed_rx_seq = 0;
+    g_typed_q_reset();
+
+    T_ASSERT_EQ_UINT(3u, g_typed_q.mask, "power-of-two capacity wraps with a mask");
+    T_ASSERT_EQ_UINT(2u, g_typed_q.copy_words, "8-byte items copy as two words");
+
+    /* Several laps around the ring keep FIFO order */
+    int bad = 0;
+    for (uint32_t i = 0; i < 10u; ++i) {
+        typed_msg_t in = {.seq = i, .tag = ~i}, a = {0, 0}, b = {0, 0};
+        typed_msg_t in2 = {.seq = i + 100u, .tag = i};
+        bad |= g_typed_q_try_send(&in) != 0;
+        bad |= g_typed_q_try_send(&in2) != 0;
+        bad |= g_typed_q_count() != 2u;
+        bad |= g_typed_q_try_recv(&a) != 0 || a.seq != i || a.tag != ~i;
+        bad |= g_typed_q_try_recv(&b) != 0 || b.seq != i + 100u || b.tag != i;
+    }
+    T_ASSERT_EQ_INT(0, bad, "typed send/recv over several laps");
+
+    /* The inline path and the generic API share one ring */
+    typed_msg_t g_in = {.seq = 77u, .tag = 1u}, g_out = {0, 0};
+    hrt_queue_try_send(&g_typed_q, &g_in);
+    g_typed_q_try_send(&g_in);
+    int mixed = g_typed_q_try_recv(&g_out) == 0 && g_out.seq == 77u;
+    g_out.seq = 0;
+    mixed &= hrt_queue_try_recv(&g_typed_q, &g_out) == 0 && g_out.seq == 77u && g_typed_q_count() == 0u;
+    T_ASSERT_EQ_INT(1, mixed, "typed and generic calls interleave on one queue");
+
+    typed_msg_t fill = {0, 0};
+    for (int i = 0; i < 4; ++i) g_typed_q_try_send(&fill);
+    const int full_rc = g_typed_q_try_send(&fill);
+    T_ASSERT_EQ_INT(-1, full_rc, "typed try_send fails when full");
+    g_typed_q_reset();
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], s1[1024], s2[1024];
+    hrt_task_attr_t prio_hi = {.priority = HRT_PRIO0, .timeslice = 3};
+    hrt_task_attr_t prio_lo = {.priority = HRT_PRIO2, .timeslice = 3};
+
+    hrt_create_task(watchdog_task, (void *) (uintptr_t) 200, swd, 1024, &prio_lo);
+    hrt_create_task(t_typed_receiver, NULL, s1, 1024, &prio_hi);
+    hrt_create_task(t_typed_sender, NULL, s2, 1024, &prio_lo);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "Watchdog should not trip");
+    T_ASSERT_EQ_UINT(4242u, g_typed_rx_seq, "blocked typed receiver got the item");
+}
+
+/* ---- Case 9: odd capacity and item size take the generic copy and wrap ---- */
+static void test_queue_generic_odd_shape(void) {
+    hrt__test_reset_scheduler_state();
+
+    hrt_queue_t q;
+    uint8_t storage[3 * 3];
+    hrt_queue_init(&q, storage, 3, 3);
+    T_ASSERT_EQ_UINT(0u, q.mask, "capacity 3 wraps by compare");
+    T_ASSERT_EQ_UINT(0u, q.copy_words, "3-byte items use memcpy");
+
+    int bad = 0;
+    for (uint8_t i = 0; i < 10u; ++i) {
+        const uint8_t in[3] = {i, (uint8_t) (i + 1u), (uint8_t) (i + 2u)};
+        uint8_t out[3] = {0, 0, 0};
+        bad |= hrt_queue_try_send(&q, in) != 0;
+        bad |= hrt_queue_try_recv(&q, out) != 0;
+        bad |= memcmp(in, out, sizeof(in)) != 0;
+    }
+    T_ASSERT_EQ_INT(0, bad, "odd-shaped queue keeps items intact over several laps");
+}
+
 static const test_case_t CASES[] = {
     {"Queue: try_send/recv basic", test_queue_try_basic},
     {"Queue: blocking recv wakes", test_queue_block_recv},
     {"Queue: blocking send wakes", test_queue_block_send},
     {"Queue: FIFO waiter order", test_queue_fifo_waiters},
     {"Queue: ISR variants basic", test_queue_isr_basic},
+    {"Queue: blocked receiver gets a direct handoff", test_queue_handoff_to_receiver},
+    {"Queue: blocked sender's item fills the freed slot", test_queue_handoff_from_sender},
+    {"Queue: typed queue from HRT_QUEUE_DEFINE", test_queue_typed_define},
+    {"Queue: odd capacity and item size", test_queue_generic_odd_shape},
 };
 
 const test_case_t *get_tests_queue(int *out_count) {
@@ -0,0 +1,316 @@
+/* Tests for queue/semaphore sets: readiness scan order, blocking wait and wake-ups,
+ * membership rules. */
+#include "test_common.h"
+#include "hardrt_isr.h"
+#include "hardrt_select.h"
+
+/* ---- Utility: watchdog to avoid infinite tests ---- */
+static volatile int g_watchdog_tripped = 0;
+
+static void watchdog_task(void *arg) {
+    uint32_t ticks = (uint32_t)(uintptr_t)arg;
+    for (;;) {
+        hrt_sleep(ticks);
+        g_watchdog_tripped = 1;
+        hrt__test_stop_scheduler();
+        hrt_yield();
+    }
+}
+
+/* ---- Case 1: non-blocking scan reports the first ready member, nothing consumed ---- */
+static void test_select_try_scan_order(void) {
+    hrt__test_reset_scheduler_state();
+
+    hrt_select_t set;
+    hrt_sem_t stop;
+    hrt_queue_t qa, qb;
+    uint32_t sa[4], sb[4];
+    hrt_sem_init(&stop, 0);
+    hrt_queue_init(&qa, sa, 4, sizeof(uint32_t));
+    hrt_queue_init(&qb, sb, 4, sizeof(uint32_t));
+
+    hrt_select_init(&set);
+    int r = hrt_select_add_sem(&set, &stop);
+    T_ASSERT_EQ_INT(0, r, "first member gets index 0");
+    r = hrt_select_add_queue(&set, &qa);
+    T_ASSERT_EQ_INT(1, r, "second member gets index 1");
+    r = hrt_select_add_queue(&set, &qb);
+    T_ASSERT_EQ_INT(2, r, "third member gets index 2");
+
+    r = hrt_select_try(&set);
+    T_ASSERT_EQ_INT(-1, r, "nothing ready");
+
+    uint32_t v = 5;
+    hrt_queue_try_send(&qb, &v);
+    r = hrt_select_try(&set);
+    T_ASSERT_EQ_INT(2, r, "queue b ready");
+    r = hrt_select_try(&set);
+    T_ASSERT_EQ_INT(2, r, "still ready: the scan consumes nothing");
+
+    hrt_sem_give(&stop);
+    r = hrt_select_try(&set);
+    T_ASSERT_EQ_INT(0, r, "earlier member wins");
+
+    r = hrt_sem_try_take(&stop);
+    T_ASSERT_EQ_INT(0, r, "token still there for try_take");
+    r = hrt_select_try(&set);
+    T_ASSERT_EQ_INT(2, r, "back to queue b");
+
+    uint32_t out = 0;
+    hrt_queue_try_recv(&qb, &out);
+    T_ASSERT_EQ_INT(5, out, "item intact");
+    r = hrt_select_try(&set);
+    T_ASSERT_EQ_INT(-1, r, "nothing ready after draining");
+}
+
+/* ---- Case 2: membership rules ---- */
+static void test_select_membership(void) {
+    hrt__test_reset_scheduler_state();
+
+    hrt_select_t s1, s2;
+    hrt_sem_t sems[HARDRT_SELECT_MAX + 1u];
+    hrt_select_init(&s1);
+    hrt_select_init(&s2);
+
+    int r = hrt_select_wait(&s1);
+    T_ASSERT_EQ_INT(-1, r, "waiting on an empty set returns at once");
+
+    for (unsigned i = 0; i < HARDRT_SELECT_MAX + 1u; ++i) hrt_sem_init(&sems[i], 0);
+    for (unsigned i = 0; i < HARDRT_SELECT_MAX; ++i) {
+        r = hrt_select_add_sem(&s1, &sems[i]);
+        T_ASSERT_EQ_INT((int)i, r, "add fills the set in order");
+    }
+    r = hrt_select_add_sem(&s1, &sems[HARDRT_SELECT_MAX]);
+    T_ASSERT_EQ_INT(-1, r, "full set rejects a member");
+
+    r = hrt_select_add_sem(&s2, &sems[0]);
+    T_ASSERT_EQ_INT(-1, r, "a member of another set is rejected");
+
+    hrt_sem_init(&sems[0], 0);
+    r = hrt_select_add_sem(&s2, &sems[0]);
+    T_ASSERT_EQ_INT(0, r, "re-initializing detaches it");
+
+    hrt_queue_t q;
+    uint32_t storage[2];
+    hrt_queue_init(&q, storage, 2, sizeof(uint32_t));
+    r = hrt_select_add_queue(&s2, &q);
+    T_ASSERT_EQ_INT(1, r, "queue added after the semaphore");
+    r = hrt_select_add_queue(&s1, &q);
+    T_ASSERT_EQ_INT(-1, r, "queue already in a set");
+}
+
+/* ---- Case 3: a gateway blocks on three members and serves each as it gets ready ---- */
+static hrt_select_t g_gw_set;
+static hrt_sem_t g_gw_stop;
+static hrt_queue_t g_gw_qa, g_gw_qb;
+static volatile int g_gw_log[8];
+static volatile int g_gw_n = 0;
+static volatile int g_gw_done = 0;
+
+static void t_gateway(void *arg) {
+    (void) arg;
+    for (;;) {
+        const int idx = hrt_select_wait(&g_gw_set);
+        uint32_t v = 0;
+        if (idx == 0) {
+            if (hrt_sem_try_take(&g_gw_stop) != 0) continue;
+            g_gw_done = 1;
+            break;
+        }
+        if (hrt_queue_try_recv(idx == 1 ? &g_gw_qa : &g_gw_qb, &v) != 0) continue;
+        if (g_gw_n < 8) g_gw_log[g_gw_n++] = idx * 100 + (int) v;
+    }
+    for (;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void t_gw_producer(void *arg) {
+    (void) arg;
+    uint32_t v = 7;
+    hrt_sleep(5);
+    /* The gateway outranks us: each call returns after it has logged the item */
+    hrt_queue_send(&g_gw_qb, &v);
+    const int after_b = g_gw_n;
+    v = 8;
+    hrt_queue_send(&g_gw_qa, &v);
+    const int after_a = g_gw_n;
+    hrt_sem_give(&g_gw_stop);
+    T_ASSERT_EQ_INT(1, after_b, "gateway served queue b before the send returned");
+    T_ASSERT_EQ_INT(2, after_a, "gateway served queue a before the send returned");
+    hrt_sleep(5);
+    hrt__test_stop_scheduler();
+    for (;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void test_select_gateway_wakes(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_gw_n = 0;
+    g_gw_done = 0;
+    for (int i = 0; i < 8; ++i) g_gw_log[i] = 0;
+
+    static uint32_t sqa[4], sqb[4];
+    hrt_sem_init(&g_gw_stop, 0);
+    hrt_queue_init(&g_gw_qa, sqa, 4, sizeof(uint32_t));
+    hrt_queue_init(&g_gw_qb, sqb, 4, sizeof(uint32_t));
+    hrt_select_init(&g_gw_set);
+    hrt_select_add_sem(&g_gw_set, &g_gw_stop);
+    hrt_select_add_queue(&g_gw_set, &g_gw_qa);
+    hrt_select_add_queue(&g_gw_set, &g_gw_qb);
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], s1[1024], s2[1024];
+    hrt_task_attr_t prio_hi = {.priority = HRT_PRIO0, .timeslice = 3};
+    hrt_task_attr_t prio_mid = {.priority = HRT_PRIO1, .timeslice = 3};
+    hrt_task_attr_t prio_lo = {.priority = HRT_PRIO2, .timeslice = 3};
+
+    hrt_create_task(watchdog_task, (void *) (uintptr_t) 200, swd, 1024, &prio_lo);
+    hrt_create_task(t_gateway, NULL, s1, 1024, &prio_hi);
+    hrt_create_task(t_gw_producer, NULL, s2, 1024, &prio_mid);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "Watchdog should not trip");
+    T_ASSERT_EQ_INT(2, g_gw_n, "two items logged");
+    T_ASSERT_EQ_INT(207, g_gw_log[0], "queue b first");
+    T_ASSERT_EQ_INT(108, g_gw_log[1], "then queue a");
+    T_ASSERT_EQ_INT(1, g_gw_done, "stop semaphore ended the loop");
+}
+
+/* ---- Case 4: a task blocked on the member itself is served before the set ---- */
+static hrt_select_t g_dr_set;
+static hrt_queue_t g_dr_q;
+static volatile int g_dr_direct = 0;
+static volatile int g_dr_set_wakes = 0;
+
+static void t_dr_direct(void *arg) {
+    (void) arg;
+    uint32_t v = 0;
+    hrt_queue_recv(&g_dr_q, &v);
+    g_dr_direct = (int) v;
+    for (;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void t_dr_selector(void *arg) {
+    (void) arg;
+    for (;;) {
+        if (hrt_select_wait(&g_dr_set) == 0) g_dr_set_wakes++;
+        uint32_t v;
+        hrt_queue_try_recv(&g_dr_q, &v);
+    }
+}
+
+static void t_dr_producer(void *arg) {
+    (void) arg;
+    hrt_sleep(5);
+    uint32_t v = 11;
+    hrt_queue_send(&g_dr_q, &v); /* handed to the blocked receiver */
+    hrt_sleep(5);
+    const int wakes_after_handoff = g_dr_set_wakes;
+    v = 12;
+    hrt_queue_send(&g_dr_q, &v); /* nobody blocked on the queue: the set wakes */
+    hrt_sleep(5);
+    T_ASSERT_EQ_INT(0, wakes_after_handoff, "handoff did not wake the set");
+    T_ASSERT_EQ_INT(1, g_dr_set_wakes, "ring item woke the set");
+    hrt__test_stop_scheduler();
+    for (;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void test_select_direct_receiver_first(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_dr_direct = 0;
+    g_dr_set_wakes = 0;
+
+    static uint32_t sq[2];
+    hrt_queue_init(&g_dr_q, sq, 2, sizeof(uint32_t));
+    hrt_select_init(&g_dr_set);
+    hrt_select_add_queue(&g_dr_set, &g_dr_q);
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], s1[1024], s2[1024], s3[1024];
+    hrt_task_attr_t prio_hi = {.priority = HRT_PRIO0, .timeslice = 3};
+    hrt_task_attr_t prio_mid = {.priority = HRT_PRIO1, .timeslice = 3};
+    hrt_task_attr_t prio_lo = {.priority = HRT_PRIO2, .timeslice = 3};
+
+    hrt_create_task(watchdog_task, (void *) (uintptr_t) 200, swd, 1024, &prio_lo);
+    hrt_create_task(t_dr_direct, NULL, s1, 1024, &prio_hi);
+    hrt_create_task(t_dr_selector, NULL, s2, 1024, &prio_hi);
+    hrt_create_task(t_dr_producer, NULL, s3, 1024, &prio_mid);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "Watchdog should not trip");
+    T_ASSERT_EQ_INT(11, g_dr_direct, "blocked receiver got the first item");
+}
+
+/* ---- Case 5: a give from ISR context wakes the set ---- */
+static hrt_select_t g_isr_set;
+static hrt_sem_t g_isr_sem;
+static volatile int g_isr_woke = -1;
+static volatile int g_isr_need = -1;
+
+static void t_isr_waiter(void *arg) {
+    (void) arg;
+    g_isr_woke = hrt_select_wait(&g_isr_set);
+    hrt_sem_try_take(&g_isr_sem);
+    for (;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void t_isr_giver(void *arg) {
+    (void) arg;
+    hrt_sleep(5);
+    int need = 0;
+    hrt_isr_enter();
+    hrt_sem_give_from_isr(&g_isr_sem, &need);
+    hrt_isr_exit();
+    g_isr_need = need;
+    hrt_sleep(5);
+    hrt__test_stop_scheduler();
+    for (;;) { hrt_yield(); hrt_sleep(1000); }
+}
+
+static void test_select_isr_give(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_isr_woke = -1;
+    g_isr_need = -1;
+
+    hrt_sem_init(&g_isr_sem, 0);
+    hrt_select_init(&g_isr_set);
+    hrt_select_add_sem(&g_isr_set, &g_isr_sem);
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    hrt_init(&cfg);
+
+    static uint32_t swd[1024], s1[1024], s2[1024];
+    hrt_task_attr_t prio_hi = {.priority = HRT_PRIO0, .timeslice = 3};
+    hrt_task_attr_t prio_mid = {.priority = HRT_PRIO1, .timeslice = 3};
+    hrt_task_attr_t prio_lo = {.priority = HRT_PRIO2, .timeslice = 3};
+
+    hrt_create_task(watchdog_task, (void *) (uintptr_t) 200, swd, 1024, &prio_lo);
+    hrt_create_task(t_isr_waiter, NULL, s1, 1024, &prio_hi);
+    hrt_create_task(t_isr_giver, NULL, s2, 1024, &prio_mid);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "Watchdog should not trip");
+    T_ASSERT_EQ_INT(0, g_isr_woke, "set waiter saw the semaphore");
+    T_ASSERT_EQ_INT(1, g_isr_need, "ISR give reported a switch");
+}
+
+static const test_case_t CASES[] = {
+    {"Select: try scan order", test_select_try_scan_order},
+    {"Select: membership rules", test_select_membership},
+    {"Select: gateway wakes on each member", test_select_gateway_wakes},
+    {"Select: blocked receiver served before the set", test_select_direct_receiver_first},
+    {"Select: ISR give wakes the set", test_select_isr_give}
+};
+
+const test_case_t *get_tests_select(int *out_count) {
+    if (out_count) *out_count = (int)(sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
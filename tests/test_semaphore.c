@@ -397,6 +397,76 @@ static void test_sem_counting_multi_waiter_fifo(void) {
     T_ASSERT_EQ_INT(3, g_multi_order[3], "third woken should be task 3");
 }
 
+/* ---- Case 10: counting semaphore beyond 8 bits ---- */
+static void test_sem_counting_wide(void) {
+    hrt__test_reset_scheduler_state();
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    int r = hrt_init(&cfg);
+    T_ASSERT_EQ_INT(0, r, "hrt_init ok");
+
+    hrt_sem_t s;
+    hrt_sem_init_counting(&s, 0, 1000u);
+    int fails = 0;
+    for (int i = 0; i < 1200; ++i) fails += hrt_sem_give(&s) != 0;
+    T_ASSERT_EQ_INT(0, fails, "1200 gives ok (saturate at 1000)");
+
+    int taken = 0;
+    while (hrt_sem_try_take(&s) == 0) taken++;
+    T_ASSERT_EQ_INT(1000, taken, "exactly max_count tokens stored");
+
+    hrt_sem_init_counting(&s, 0xFFFFFFFFu, 0xFFFFFFFFu);
+    T_ASSERT_EQ_UINT(HRT_SEM_MAX_COUNT, s.max_count, "max_count clamps to HRT_SEM_MAX_COUNT");
+    T_ASSERT_EQ_UINT(HRT_SEM_MAX_COUNT, s.count, "init clamps to the clamped max_count");
+}
+
+/* ---- Case 11: once the last waiter is woken, gives store tokens again ---- */
+static volatile int g_drain_try = -99;
+static hrt_sem_t g_drain_sem;
+
+static void t_drain_waiter(void *arg) {
+    (void)arg;
+    hrt_sem_take(&g_drain_sem);
+    hrt_sem_give(&g_drain_sem); /* no waiter left: this one is stored */
+    hrt_sem_give(&g_drain_sem);
+    g_drain_try = hrt_sem_try_take(&g_drain_sem) + hrt_sem_try_take(&g_drain_sem);
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void t_drain_giver(void *arg) {
+    (void)arg;
+    hrt_sleep(20);
+    hrt_sem_give(&g_drain_sem);
+    hrt_yield();
+}
+
+static void test_sem_gives_store_after_waiters_drain(void) {
+    hrt__test_reset_scheduler_state();
+    g_watchdog_tripped = 0;
+    g_drain_try = -99;
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    int r = hrt_init(&cfg);
+    T_ASSERT_EQ_INT(0, r, "hrt_init ok");
+
+    hrt_sem_init_counting(&g_drain_sem, 0, 5);
+
+    static uint32_t sw[1024], sg[1024], swd[1024];
+    hrt_task_attr_t prio_hi = {.priority = HRT_PRIO0, .timeslice = 3};
+    hrt_task_attr_t prio_lo = {.priority = HRT_PRIO2, .timeslice = 3};
+
+    hrt_create_task(watchdog_task, (void *) (uintptr_t) 250, swd, 1024, &prio_lo);
+    hrt_create_task(t_drain_waiter, NULL, sw, 1024, &prio_hi);
+    hrt_create_task(t_drain_giver, NULL, sg, 1024, &prio_lo);
+
+    hrt_start();
+
+    T_ASSERT_EQ_INT(0, g_watchdog_tripped, "watchdog should not trip in drain test");
+    T_ASSERT_EQ_INT(0, g_drain_try, "both tokens given after the handoff were stored");
+    T_ASSERT_EQ_UINT(0u, g_drain_sem.count, "no waiter flag left behind");
+}
+
 static const test_case_t CASES[] = {
     {"Semaphore: try/take/give basic", test_sem_try_and_give_basic},
     {"Semaphore: blocking take wakes on give", test_sem_block_and_wake},
@@ -406,7 +476,9 @@ static const test_case_t CASES[] = {
     {"Semaphore: accumulate shall saturate at set value",test_sem_counting_accumulates_and_saturates},
     {"Semaphore: init shall clamp to max_count",test_sem_counting_init_clamps},
     {"Semaphore: direct handoff shall fail after wake with 0 tokens",test_sem_counting_wake_is_handoff},
-    {"Semaphore: counting FIFO wait order", test_sem_counting_multi_waiter_fifo}
+    {"Semaphore: counting FIFO wait order", test_sem_counting_multi_waiter_fifo},
+    {"Semaphore: counting beyond 255", test_sem_counting_wide},
+    {"Semaphore: gives store again after waiters drain", test_sem_gives_store_after_waiters_drain}
 };
 
 const test_case_t *get_tests_semaphore(int *out_count) {
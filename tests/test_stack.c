@@ -0,0 +1,85 @@
+/* Tests for stack painting and high-water-mark reporting */
+#include <stdio.h>
+
+#include "test_common.h"
+#include "hardrt_time.h"
+#include "hardrt_stack.h"
+
+#if HARDRT_STACK_CHECK == 1
+
+#define STK_WORDS 1024u
+
+static volatile int g_hook_id = -1;
+static volatile int g_hook_calls = 0;
+static volatile uint32_t g_hook_unused = 0;
+
+static void stack_hook(const int id, const uint32_t unused_words) {
+    g_hook_id = id;
+    g_hook_unused = unused_words;
+    g_hook_calls++;
+}
+
+/* Touch ~2 KB of stack once, then idle */
+static void deep_task(void *arg) {
+    (void) arg;
+    volatile uint32_t scratch[512];
+    for (unsigned i = 0; i < 512u; ++i) scratch[i] = i;
+    (void) scratch[7];
+    for (;;) hrt_sleep(10);
+}
+
+static void shallow_task(void *arg) {
+    (void) arg;
+    for (;;) hrt_sleep(10);
+}
+
+static void test_stack_high_water_mark(void) {
+    hrt__test_reset_scheduler_state();
+    g_hook_id = -1;
+    g_hook_calls = 0;
+
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5,
+                        .tick_src = HRT_TICK_VIRTUAL};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (stack)");
+    hrt_stack_set_hook(stack_hook, STK_WORDS / 2u);
+
+    static uint32_t s_deep[STK_WORDS], s_shallow[STK_WORDS];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    const int deep = hrt_create_task(deep_task, NULL, s_deep, STK_WORDS, &a);
+    const int shallow = hrt_create_task(shallow_task, NULL, s_shallow, STK_WORDS, &a);
+    T_ASSERT_TRUE(deep >= 0 && shallow >= 0, "created tasks");
+
+    T_ASSERT_TRUE(hrt_task_stack_unused(deep) > (int32_t) (STK_WORDS * 9u / 10u), "fresh stack reads almost all unused");
+
+    hrt_sim_run_for(3u * HARDRT_STACK_CHECK_PERIOD_TICKS);
+
+    const int32_t u_deep = hrt_task_stack_unused(deep);
+    const int32_t u_shallow = hrt_task_stack_unused(shallow);
+    T_ASSERT_TRUE(u_deep >= 0 && u_deep < (int32_t) (STK_WORDS - 512u), "deep task mark covers its 512-word buffer");
+    T_ASSERT_TRUE(u_shallow > u_deep, "shallow task used less stack");
+    T_ASSERT_TRUE(u_shallow > (int32_t) (STK_WORDS / 2u), "shallow task stays above the threshold");
+
+    T_ASSERT_EQ_INT(1, g_hook_calls, "hook fired once for the deep task only");
+    T_ASSERT_EQ_INT(deep, g_hook_id, "hook reported the deep task");
+    T_ASSERT_EQ_UINT((uint32_t) u_deep, g_hook_unused, "hook got the high-water margin");
+
+    T_ASSERT_EQ_INT(-1, hrt_task_stack_unused(HARDRT_MAX_TASKS), "invalid id rejected");
+}
+
+#else
+
+static void test_stack_high_water_mark(void) {
+    T_ASSERT_EQ_INT(-1, hrt_task_stack_unused(0), "no high-water mark without HARDRT_STACK_CHECK");
+    printf("SKIP: stack painting checks require HARDRT_STACK_CHECK=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"Stack: painting and high-water mark", test_stack_high_water_mark},
+};
+
+const test_case_t *get_tests_stack(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -0,0 +1,100 @@
+/* Tests for per-task CPU time and context-switch statistics */
+#include <stdio.h>
+
+#include "test_common.h"
+#include "hardrt_stats.h"
+#include "hardrt_posix.h"
+
+#if HARDRT_STATS == 1
+
+static volatile int g_st_watchdog = 0;
+
+static void spin_ms(const uint32_t ms) {
+    const uint64_t until = hrt_posix_now_ns() + (uint64_t) ms * 1000000ull;
+    while (hrt_posix_now_ns() < until) {
+    }
+}
+
+static void t_busy(void *arg) {
+    (void) arg;
+    for (int i = 0; i < 5; ++i) {
+        spin_ms(2);
+        hrt_sleep(1);
+    }
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void t_light(void *arg) {
+    (void) arg;
+    for (;;) {
+        hrt_sleep(1);
+    }
+}
+
+static void t_st_watchdog(void *arg) {
+    (void) arg;
+    hrt_sleep(1000);
+    g_st_watchdog = 1;
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void test_stats_run_time_and_switches(void) {
+    hrt__test_reset_scheduler_state();
+    g_st_watchdog = 0;
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (stats)");
+
+    static uint32_t s_busy[2048], s_light[1024], s_wd[1024];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    hrt_task_attr_t wd = {.priority = HRT_PRIO2, .timeslice = 0};
+    const int busy = hrt_create_task(t_busy, NULL, s_busy, 2048, &a);
+    const int light = hrt_create_task(t_light, NULL, s_light, 1024, &a);
+    T_ASSERT_TRUE(busy >= 0 && light >= 0, "created tasks");
+    T_ASSERT_TRUE(hrt_create_task(t_st_watchdog, NULL, s_wd, 1024, &wd) >= 0, "created watchdog");
+
+    hrt_start();
+    T_ASSERT_EQ_INT(0, g_st_watchdog, "watchdog should not trip");
+
+    hrt_task_stats_t sb, sl;
+    T_ASSERT_EQ_INT(0, hrt_task_stats(busy, &sb), "busy task stats");
+    T_ASSERT_EQ_INT(0, hrt_task_stats(light, &sl), "light task stats");
+    T_ASSERT_TRUE(sb.run_cycles >= 8000000ull, "busy task charged for its ~10 ms of spinning");
+    T_ASSERT_TRUE(sb.run_cycles > sl.run_cycles, "busy task ran longer than the sleeper");
+    T_ASSERT_TRUE(sb.switches_in >= 5, "busy task switched in once per sleep");
+    T_ASSERT_TRUE(sb.voluntary >= 5, "sleeps count as voluntary switch-outs");
+    T_ASSERT_EQ_UINT(0, sb.preempted, "cooperative POSIX task is never preempted");
+    T_ASSERT_TRUE(sl.switches_in >= 1, "sleeper ran");
+
+    hrt_sys_stats_t sys;
+    T_ASSERT_EQ_INT(0, hrt_sys_stats(&sys), "system stats");
+    T_ASSERT_EQ_UINT(1000000000u, sys.cycles_hz, "POSIX counter is nanoseconds");
+    T_ASSERT_TRUE(sys.run_cycles >= sb.run_cycles + sl.run_cycles, "system run time covers tasks");
+    T_ASSERT_TRUE(sys.context_switches >= sb.switches_in + sl.switches_in, "system switch count");
+    T_ASSERT_TRUE(sys.load_permille <= 1000, "load is a permille");
+
+    T_ASSERT_EQ_INT(-1, hrt_task_stats(HARDRT_MAX_TASKS, &sb), "invalid id rejected");
+    T_ASSERT_EQ_INT(-1, hrt_task_stats(busy, NULL), "NULL out rejected");
+}
+
+#else
+
+static void test_stats_run_time_and_switches(void) {
+    hrt_task_stats_t ts;
+    hrt_sys_stats_t sys;
+    T_ASSERT_EQ_INT(-1, hrt_task_stats(0, &ts), "task stats unavailable without HARDRT_STATS");
+    T_ASSERT_EQ_INT(-1, hrt_sys_stats(&sys), "system stats unavailable without HARDRT_STATS");
+    printf("SKIP: accounting checks require HARDRT_STATS=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"Stats: run time and switch counters", test_stats_run_time_and_switches},
+};
+
+const test_case_t *get_tests_stats(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
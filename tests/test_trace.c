@@ -0,0 +1,110 @@
+/* Tests for the kernel event tracer */
+#include <stdio.h>
+
+#include "test_common.h"
+#include "hardrt_trace.h"
+#include "hardrt_posix.h"
+#include "hardrt_sem.h"
+
+#if HARDRT_TRACE == 1
+
+static hrt_sem_t g_tr_sem;
+static hrt_trace_rec_t g_recs[HARDRT_TRACE_EVENTS];
+
+static void t_taker(void *arg) {
+    (void) arg;
+    hrt_sem_take(&g_tr_sem);
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void t_giver(void *arg) {
+    (void) arg;
+    hrt_trace_user(0x1234);
+    hrt_sem_give(&g_tr_sem);
+    for (;;) hrt_sleep(10);
+}
+
+static int count_ev(const uint32_t n, const uint8_t ev, const int task) {
+    int c = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        if (g_recs[i].ev == ev && (task < 0 || g_recs[i].task == task)) c++;
+    }
+    return c;
+}
+
+static void test_trace_records_kernel_events(void) {
+    hrt__test_reset_scheduler_state();
+    hrt_sem_init(&g_tr_sem, 0);
+    hrt_config_t cfg = {.tick_hz = 1000, .policy = HRT_SCHED_PRIORITY_RR, .default_slice = 5};
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init ok (trace)");
+
+    static uint32_t s1[1024], s2[1024];
+    hrt_task_attr_t hi = {.priority = HRT_PRIO0, .timeslice = 0};
+    hrt_task_attr_t lo = {.priority = HRT_PRIO1, .timeslice = 0};
+    const int taker = hrt_create_task(t_taker, NULL, s1, 1024, &hi);
+    const int giver = hrt_create_task(t_giver, NULL, s2, 1024, &lo);
+    T_ASSERT_TRUE(taker >= 0 && giver >= 0, "created tasks");
+
+    hrt_start();
+    hrt_trace_enable(0);
+
+    hrt_trace_hdr_t hdr;
+    const uint32_t n = hrt_trace_snapshot(&hdr, g_recs, HARDRT_TRACE_EVENTS);
+    T_ASSERT_TRUE(n > 0, "events recorded");
+    T_ASSERT_EQ_UINT(HRT_TRACE_MAGIC, hdr.magic, "header magic");
+    T_ASSERT_EQ_UINT(n, hdr.count, "header count matches copy");
+
+    T_ASSERT_TRUE(count_ev(n, HRT_EV_SWITCH_IN, taker) >= 2, "taker switched in before and after blocking");
+    T_ASSERT_TRUE(count_ev(n, HRT_EV_SWITCH_IN, giver) >= 1, "giver switched in");
+    T_ASSERT_TRUE(count_ev(n, HRT_EV_SWITCH_OUT, taker) >= 1, "taker switched out");
+    T_ASSERT_EQ_INT(1, count_ev(n, HRT_EV_BLOCK, taker), "taker blocked once");
+    T_ASSERT_EQ_INT(1, count_ev(n, HRT_EV_SEM_GIVE, giver), "giver gave");
+    T_ASSERT_EQ_INT(1, count_ev(n, HRT_EV_READY, taker), "taker made ready by the give");
+    T_ASSERT_EQ_INT(1, count_ev(n, HRT_EV_SEM_TAKE, taker), "taker took after wakeup");
+    T_ASSERT_EQ_INT(1, count_ev(n, HRT_EV_USER, giver), "user marker recorded");
+
+    int ordered = 1;
+    for (uint32_t i = 1; i < n; ++i) {
+        if ((int32_t) (g_recs[i].ts - g_recs[i - 1].ts) < 0) ordered = 0;
+    }
+    T_ASSERT_TRUE(ordered, "timestamps are non-decreasing");
+
+    hrt_trace_user(1);
+    T_ASSERT_EQ_UINT(n, hrt_trace_snapshot(NULL, g_recs, HARDRT_TRACE_EVENTS), "disabled tracer records nothing");
+
+    const char *path = "hardrt_test_trace.bin";
+    T_ASSERT_EQ_INT((int) n, hrt_posix_trace_dump(path), "dump written");
+    FILE *f = fopen(path, "rb");
+    long size = -1;
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        fclose(f);
+    }
+    remove(path);
+    T_ASSERT_TRUE(size == (long) (sizeof(hrt_trace_hdr_t) + n * sizeof(hrt_trace_rec_t)), "dump is header + records");
+
+    hrt_trace_clear();
+    T_ASSERT_EQ_UINT(0, hrt_trace_snapshot(NULL, g_recs, HARDRT_TRACE_EVENTS), "clear empties the ring");
+}
+
+#else
+
+static void test_trace_records_kernel_events(void) {
+    hrt_trace_rec_t r;
+    T_ASSERT_EQ_UINT(0, hrt_trace_snapshot(NULL, &r, 1), "no events without HARDRT_TRACE");
+    T_ASSERT_EQ_INT(-1, hrt_posix_trace_dump("hardrt_test_trace.bin"), "dump unavailable without HARDRT_TRACE");
+    printf("SKIP: tracer checks require HARDRT_TRACE=ON.\n");
+}
+
+#endif
+
+static const test_case_t CASES[] = {
+    {"Trace: kernel events recorded and dumped", test_trace_records_kernel_events},
+};
+
+const test_case_t *get_tests_trace(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
@@ -0,0 +1,174 @@
+/* Tests for the POSIX virtual-time tick source (HRT_TICK_VIRTUAL) */
+#include "test_common.h"
+#include "hardrt_time.h"
+
+/* ---- Case 1: a long sleep completes instantly and lands on the exact deadline ---- */
+static volatile uint32_t g_long_woke_at = 0;
+
+static void long_sleeper(void *arg) {
+    (void) arg;
+    /* 10 simulated minutes at 1 kHz */
+    hrt_sleep(10u * 60u * 1000u);
+    g_long_woke_at = hrt_tick_now();
+    hrt__test_stop_scheduler();
+    hrt_yield();
+}
+
+static void test_virtual_long_sleep_jumps_to_deadline(void) {
+    hrt__test_reset_scheduler_state();
+    g_long_woke_at = 0;
+
+    hrt_config_t cfg = {0};
+    cfg.tick_hz = 1000;
+    cfg.policy = HRT_SCHED_PRIORITY_RR;
+    cfg.default_slice = 5;
+    cfg.tick_src = HRT_TICK_VIRTUAL;
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init virtual tick");
+
+    static uint32_t st[1024];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(long_sleeper, NULL, st, 1024, &a) >= 0, "created long sleeper");
+
+    hrt_start();
+
+    T_ASSERT_EQ_UINT(600000u, g_long_woke_at, "sleeper woke exactly at its virtual deadline");
+}
+
+/* ---- Case 2: lockstep run_for/step drive periodic tasks deterministically ---- */
+static volatile int g_fast_runs = 0;
+static volatile int g_slow_runs = 0;
+
+static void periodic_fast(void *arg) {
+    (void) arg;
+    for (;;) {
+        hrt_sleep(10);
+        g_fast_runs++;
+    }
+}
+
+static void periodic_slow(void *arg) {
+    (void) arg;
+    for (;;) {
+        hrt_sleep(25);
+        g_slow_runs++;
+    }
+}
+
+static void test_virtual_lockstep_run_for_and_step(void) {
+    hrt__test_reset_scheduler_state();
+    g_fast_runs = 0;
+    g_slow_runs = 0;
+
+    hrt_config_t cfg = {0};
+    cfg.tick_hz = 1000;
+    cfg.policy = HRT_SCHED_PRIORITY_RR;
+    cfg.default_slice = 5;
+    cfg.tick_src = HRT_TICK_VIRTUAL;
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init virtual tick (lockstep)");
+
+    static uint32_t s1[1024], s2[1024];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(periodic_fast, NULL, s1, 1024, &a) >= 0, "created fast periodic task");
+    T_ASSERT_TRUE(hrt_create_task(periodic_slow, NULL, s2, 1024, &a) >= 0, "created slow periodic task");
+
+    uint32_t now = hrt_sim_run_for(100);
+    T_ASSERT_EQ_UINT(100u, now, "run_for(100) returns at tick 100");
+    T_ASSERT_EQ_INT(10, g_fast_runs, "10-tick task ran 10 times in 100 ticks");
+    T_ASSERT_EQ_INT(4, g_slow_runs, "25-tick task ran 4 times in 100 ticks");
+
+    for (int i = 0; i < 9; ++i) now = hrt_sim_step();
+    T_ASSERT_EQ_UINT(109u, now, "nine steps advance to tick 109");
+    T_ASSERT_EQ_INT(10, g_fast_runs, "fast task not yet due at tick 109");
+    now = hrt_sim_step();
+    T_ASSERT_EQ_UINT(110u, now, "tenth step reaches tick 110");
+    T_ASSERT_EQ_INT(11, g_fast_runs, "fast task ran on the step that hit its deadline");
+
+    now = hrt_sim_run_for(0);
+    T_ASSERT_EQ_UINT(110u, now, "run_for(0) does not advance time");
+}
+
+/* ---- Case 3: consumed ticks wake sleepers and let a higher priority task preempt ---- */
+static volatile uint32_t g_hi_ran_at = 0;
+static volatile uint32_t g_worker_done_at = 0;
+static volatile int g_worker_done_before_hi = 0;
+
+static void hi_sleeper(void *arg) {
+    (void) arg;
+    hrt_sleep(3);
+    g_hi_ran_at = hrt_tick_now();
+    g_worker_done_before_hi = (g_worker_done_at != 0);
+    hrt_sleep(1000);
+}
+
+static void worker(void *arg) {
+    (void) arg;
+    hrt_sim_consume(10);
+    g_worker_done_at = hrt_tick_now();
+    hrt_sleep(1000);
+}
+
+static void test_virtual_consume_preempts_on_wake(void) {
+    hrt__test_reset_scheduler_state();
+    g_hi_ran_at = 0;
+    g_worker_done_at = 0;
+    g_worker_done_before_hi = 0;
+
+    hrt_config_t cfg = {0};
+    cfg.tick_hz = 1000;
+    cfg.policy = HRT_SCHED_PRIORITY;
+    cfg.tick_src = HRT_TICK_VIRTUAL;
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init virtual tick (consume)");
+
+    static uint32_t s1[1024], s2[1024];
+    hrt_task_attr_t hi = {.priority = HRT_PRIO0, .timeslice = 0};
+    hrt_task_attr_t lo = {.priority = HRT_PRIO1, .timeslice = 0};
+    T_ASSERT_TRUE(hrt_create_task(hi_sleeper, NULL, s1, 1024, &hi) >= 0, "created PRIO0 sleeper");
+    T_ASSERT_TRUE(hrt_create_task(worker, NULL, s2, 1024, &lo) >= 0, "created PRIO1 worker");
+
+    hrt_sim_run_for(20);
+    T_ASSERT_EQ_UINT(3u, g_hi_ran_at, "sleeper ran on the tick it woke, mid-consume");
+    T_ASSERT_EQ_INT(0, g_worker_done_before_hi, "worker was preempted, not finished");
+    T_ASSERT_EQ_UINT(10u, g_worker_done_at, "worker finished after exactly 10 ticks of work");
+}
+
+/* ---- Case 4: round-robin slices expire while tasks consume ticks ---- */
+static volatile uint32_t g_rr_done[2];
+
+static void rr_worker(void *arg) {
+    const int idx = (int) (intptr_t) arg;
+    hrt_sim_consume(6);
+    g_rr_done[idx] = hrt_tick_now();
+    hrt_sleep(1000);
+}
+
+static void test_virtual_consume_rr_slices(void) {
+    hrt__test_reset_scheduler_state();
+    g_rr_done[0] = g_rr_done[1] = 0;
+
+    hrt_config_t cfg = {0};
+    cfg.tick_hz = 1000;
+    cfg.policy = HRT_SCHED_RR;
+    cfg.tick_src = HRT_TICK_VIRTUAL;
+    T_ASSERT_EQ_INT(0, hrt_init(&cfg), "hrt_init virtual tick (RR consume)");
+
+    static uint32_t s1[1024], s2[1024];
+    hrt_task_attr_t a = {.priority = HRT_PRIO1, .timeslice = 2};
+    T_ASSERT_TRUE(hrt_create_task(rr_worker, (void *) (intptr_t) 0, s1, 1024, &a) >= 0, "created RR worker A");
+    T_ASSERT_TRUE(hrt_create_task(rr_worker, (void *) (intptr_t) 1, s2, 1024, &a) >= 0, "created RR worker B");
+
+    hrt_sim_run_for(20);
+    T_ASSERT_EQ_UINT(10u, g_rr_done[0], "A alternates 2-tick slices with B and finishes at 10");
+    T_ASSERT_EQ_UINT(12u, g_rr_done[1], "B finishes one slice later at 12");
+}
+
+static const test_case_t CASES[] = {
+    {"Virtual tick: long sleep jumps to deadline", test_virtual_long_sleep_jumps_to_deadline},
+    {"Virtual tick: lockstep run_for/step", test_virtual_lockstep_run_for_and_step},
+    {"Virtual tick: consume preempted by wake", test_virtual_consume_preempts_on_wake},
+    {"Virtual tick: consume expires RR slices", test_virtual_consume_rr_slices},
+};
+
+const test_case_t *get_tests_virtual_time(int *out_count) {
+    if (out_count) *out_count = (int) (sizeof(CASES) / sizeof(CASES[0]));
+    return CASES;
+}
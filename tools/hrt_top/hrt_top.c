@@ -0,0 +1,179 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Live task view of a running POSIX HardRT process, read from its telemetry
+ * page (built with -DHARDRT_POSIX_SHM=ON). Nothing is attached or stopped: the
+ * page is mapped read-only and copied under its seqlock.
+ *
+ *   hrt-top [-i ms] [--once] [pid | /shm-name]
+ *
+ * Without an argument the only /dev/shm/hardrt.* page is used. CPU% is the
+ * share of wall time between two refreshes (since hrt_init() with --once). */
+#define _DEFAULT_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hardrt_shm.h"
+
+static const char *const k_states[] = {"READY", "SLEEP", "BLOCKED", "-", "RUN"};
+static const char *const k_kinds[] = {"-", "sem", "mutex", "queue"};
+static const char *const k_policies[] = {"PRIORITY", "RR", "PRIORITY_RR"};
+
+static int usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [-i ms] [--once] [pid | /shm-name]\n", argv0);
+    return 2;
+}
+
+/* The single live /dev/shm/hardrt.<pid> page; pages left by killed processes are skipped */
+static int find_page(char *name, const size_t len) {
+    DIR *d = opendir("/dev/shm");
+    if (!d) return -1;
+    int found = 0;
+    const struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        if (strncmp(e->d_name, "hardrt.", 7) != 0) continue;
+        const long pid = strtol(e->d_name + 7, NULL, 10);
+        if (pid > 0 && kill((pid_t) pid, 0) != 0 && errno == ESRCH) continue;
+        if (found++ == 0) snprintf(name, len, "/%s", e->d_name);
+    }
+    closedir(d);
+    if (found > 1) fprintf(stderr, "several HardRT pages in /dev/shm; pass a pid\n");
+    return found == 1 ? 0 : -1;
+}
+
+/* Copy the page under the seqlock; gives up after a while if the writer is stuck mid-update */
+static int snapshot(const hrt_shm_page_t *page, hrt_shm_page_t *out) {
+    for (int tries = 0; tries < 10000; ++tries) {
+        const uint32_t s1 = __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE);
+        if (s1 & 1u) continue;
+        memcpy(out, (const void *) page, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&page->seq, __ATOMIC_RELAXED) == s1) return 0;
+    }
+    return -1;
+}
+
+static void print_page(const hrt_shm_page_t *p, const hrt_shm_page_t *prev, const char *name) {
+    const uint64_t span = prev ? p->update_ns - prev->update_ns : 0;
+    const uint32_t idle = p->max_tasks ? p->max_tasks - 1u : 0;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < p->max_tasks && i < HRT_SHM_TASKS; ++i) total += p->task[i].run_ns;
+
+    printf("%s  pid %u  tick %u @ %u Hz  policy %s  switches %llu\n", name, (unsigned) p->pid,
+           (unsigned) p->tick, (unsigned) p->tick_hz,
+           p->policy < sizeof(k_policies) / sizeof(k_policies[0]) ? k_policies[p->policy] : "?",
+           (unsigned long long) p->switches);
+    printf("%4s %-7s %4s %7s %9s %10s %6s %12s\n", "ID", "STATE", "PRIO", "SLICE", "STACK", "SWITCHES", "CPU%",
+           "RUN_MS");
+    for (uint32_t i = 0; i < p->max_tasks && i < HRT_SHM_TASKS; ++i) {
+        const hrt_shm_task_t *t = &p->task[i];
+        if (t->state == HRT_SHM_UNUSED && i != idle) continue;
+        const uint64_t run = prev ? t->run_ns - prev->task[i].run_ns : t->run_ns;
+        const uint64_t base = prev ? span : total;
+        const double cpu = base ? 100.0 * (double) run / (double) base : 0.0;
+        char id[8], prio[8], slice[16];
+        if (i == idle) {
+            snprintf(id, sizeof(id), "idle");
+            snprintf(prio, sizeof(prio), "-");
+            snprintf(slice, sizeof(slice), "-");
+        } else {
+            snprintf(id, sizeof(id), "%u", (unsigned) i);
+            snprintf(prio, sizeof(prio), "%u", (unsigned) t->prio);
+            if (t->timeslice) snprintf(slice, sizeof(slice), "%u/%u", (unsigned) t->slice_left, (unsigned) t->timeslice);
+            else snprintf(slice, sizeof(slice), "coop");
+        }
+        printf("%4s %-7s %4s %7s %9u %10u %6.1f %12.3f\n", id,
+               t->state < sizeof(k_states) / sizeof(k_states[0]) ? k_states[t->state] : "?", prio, slice,
+               (unsigned) t->stack_words, (unsigned) t->switches_in, cpu, (double) t->run_ns / 1e6);
+    }
+    if (p->nobjs) {
+        printf("\n%-16s %-6s %11s %8s %6s\n", "OBJECT", "KIND", "LEVEL/CAP", "WAITERS", "OWNER");
+        for (uint32_t i = 0; i < p->nobjs && i < HRT_SHM_OBJS; ++i) {
+            const hrt_shm_obj_t *o = &p->obj[i];
+            char level[24], owner[8];
+            snprintf(level, sizeof(level), "%u/%u", (unsigned) o->level, (unsigned) o->capacity);
+            if (o->owner >= 0) snprintf(owner, sizeof(owner), "%d", o->owner);
+            else snprintf(owner, sizeof(owner), "-");
+            printf("%-16.*s %-6s %11s %8u %6s\n", (int) HRT_SHM_NAME_LEN, o->name,
+                   o->kind < sizeof(k_kinds) / sizeof(k_kinds[0]) ? k_kinds[o->kind] : "?", level,
+                   (unsigned) o->waiters, owner);
+        }
+    }
+}
+
+int main(const int argc, char **argv) {
+    int once = 0;
+    long interval_ms = 1000;
+    const char *target = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--once") == 0) {
+            once = 1;
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            interval_ms = strtol(argv[++i], NULL, 10);
+            if (interval_ms <= 0) return usage(argv[0]);
+        } else if (argv[i][0] != '-' && !target) {
+            target = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    char name[64];
+    if (!target) {
+        if (find_page(name, sizeof(name)) != 0) {
+            fprintf(stderr, "no HardRT telemetry page found (build with -DHARDRT_POSIX_SHM=ON)\n");
+            return 1;
+        }
+    } else if (target[0] == '/') {
+        snprintf(name, sizeof(name), "%s", target);
+    } else {
+        snprintf(name, sizeof(name), "/hardrt.%s", target);
+    }
+
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", name, strerror(errno));
+        return 1;
+    }
+    struct stat st;
+    const hrt_shm_page_t *page = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t) st.st_size >= sizeof(hrt_shm_page_t)) {
+        page = mmap(NULL, sizeof(hrt_shm_page_t), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (page == MAP_FAILED || page->magic != HRT_SHM_MAGIC || page->version != HRT_SHM_VERSION ||
+        page->page_bytes != sizeof(hrt_shm_page_t)) {
+        fprintf(stderr, "%s: not a HardRT telemetry page (v%u)\n", name, HRT_SHM_VERSION);
+        return 1;
+    }
+
+    static hrt_shm_page_t cur, prev;
+    if (snapshot(page, &cur) != 0) {
+        fprintf(stderr, "%s: writer stuck mid-update\n", name);
+        return 1;
+    }
+    if (once) {
+        print_page(&cur, NULL, name);
+        return 0;
+    }
+    for (;;) {
+        prev = cur;
+        const struct timespec ts = {interval_ms / 1000, (interval_ms % 1000) * 1000000L};
+        nanosleep(&ts, NULL);
+        if (kill((pid_t) cur.pid, 0) != 0 && errno == ESRCH) {
+            printf("process %u exited\n", (unsigned) cur.pid);
+            return 0;
+        }
+        if (snapshot(page, &cur) != 0) continue;
+        printf("\033[H\033[2J");
+        print_page(&cur, cur.update_ns != prev.update_ns ? &prev : NULL, name);
+        fflush(stdout);
+    }
+}
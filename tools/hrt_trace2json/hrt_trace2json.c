@@ -0,0 +1,102 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Convert a HardRT trace dump (hrt_posix_trace_dump() or a raw memory dump of
+ * hrt_trace_hdr_t + records) into Chrome trace event JSON. Open the output in
+ * ui.perfetto.dev or chrome://tracing.
+ *
+ *   hrt_trace2json dump.bin > trace.json
+ *
+ * Each task is a track (tid = task id); running time is drawn as a slice from
+ * SWITCH_IN to SWITCH_OUT. ISR enter/exit become slices on an "ISR" track and
+ * everything else is an instant event on the task that emitted it. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hardrt_trace.h"
+
+#define TID_ISR    1000
+#define TID_KERNEL 1001
+
+static const char *const k_names[HRT_EV_COUNT] = {
+    "switch_in", "switch_out", "ready", "block",
+    "sem_give", "sem_take", "queue_send", "queue_recv",
+    "mutex_lock", "mutex_unlock", "isr_enter", "isr_exit",
+    "tick", "user",
+};
+
+static int g_first = 1;
+
+static void emit(const char *name, const char ph, const double us, const int tid, const unsigned arg) {
+    printf("%s\n  {\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+           g_first ? "" : ",", name, ph, us, tid);
+    if (ph == 'i') printf(",\"s\":\"t\"");
+    printf(",\"args\":{\"arg\":%u}}", arg);
+    g_first = 0;
+}
+
+static void name_track(const int tid, const char *name) {
+    printf("%s\n  {\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+           g_first ? "" : ",", tid, name);
+    g_first = 0;
+}
+
+int main(const int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <trace.bin>\n", argv[0]);
+        return 2;
+    }
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    hrt_trace_hdr_t hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != HRT_TRACE_MAGIC ||
+        hdr.version != HRT_TRACE_VERSION || hdr.rec_size != sizeof(hrt_trace_rec_t)) {
+        fprintf(stderr, "%s: not a HardRT trace dump (v%u)\n", argv[1], HRT_TRACE_VERSION);
+        fclose(f);
+        return 1;
+    }
+    if (hdr.lost) fprintf(stderr, "note: %u older events were overwritten\n", (unsigned) hdr.lost);
+
+    /* Without a counter rate, fall back to raw counts as microseconds */
+    const double to_us = hdr.cycles_hz ? 1e6 / (double) hdr.cycles_hz : 1.0;
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    name_track(TID_ISR, "ISR");
+    name_track(TID_KERNEL, "kernel");
+
+    uint8_t named[256] = {0};
+    uint64_t t = 0;
+    uint32_t last = 0;
+    hrt_trace_rec_t r;
+    for (uint32_t i = 0; i < hdr.count && fread(&r, sizeof(r), 1, f) == 1; ++i) {
+        /* Unwrap the 32-bit counter; records are in order so deltas are small */
+        if (i) t += (uint32_t) (r.ts - last);
+        last = r.ts;
+        const double us = (double) t * to_us;
+        const char *name = r.ev < HRT_EV_COUNT ? k_names[r.ev] : "unknown";
+
+        if (!named[r.task] && r.task != HRT_TRACE_NO_TASK) {
+            char buf[24];
+            snprintf(buf, sizeof(buf), "task %u", (unsigned) r.task);
+            name_track(r.task, buf);
+            named[r.task] = 1;
+        }
+
+        switch (r.ev) {
+            case HRT_EV_SWITCH_IN: emit("run", 'B', us, r.task, r.arg); break;
+            case HRT_EV_SWITCH_OUT: emit("run", 'E', us, r.task, r.arg); break;
+            case HRT_EV_ISR_ENTER: emit("isr", 'B', us, TID_ISR, r.arg); break;
+            case HRT_EV_ISR_EXIT: emit("isr", 'E', us, TID_ISR, r.arg); break;
+            case HRT_EV_TICK: emit(name, 'i', us, TID_KERNEL, r.arg); break;
+            default:
+                emit(name, 'i', us, r.task == HRT_TRACE_NO_TASK ? TID_KERNEL : r.task, r.arg);
+                break;
+        }
+    }
+    printf("\n]}\n");
+    fclose(f);
+    return 0;
+}